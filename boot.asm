@@ -26,6 +26,12 @@ multiboot_header_start:
     dd 768                       ; 高度
     dd 32                        ; 深度
 
+    ; 模块对齐标签 - 要求 GRUB 把模块放在页边界上，便于按页保留
+    align 8
+    dw 6                         ; 类型：模块对齐
+    dw 0                         ; 标志
+    dd 8                         ; 大小
+
     ; 结束标签
     align 8
     dw 0                         ; 类型：结束
@@ -43,6 +49,7 @@ section .text
 
 ; 入口点
 global _start
+global stack_top
 extern kernel_main
 
 _start:
@@ -0,0 +1,54 @@
+#ifndef KERNEL_ACPI_H
+#define KERNEL_ACPI_H
+
+#include <stdint.h>
+
+/* RSDP（根系统描述指针） */
+typedef struct {
+    char signature[8];          // "RSD PTR "
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;           // 0 = ACPI 1.0, 2 = ACPI 2.0+
+    uint32_t rsdt_address;
+    // 以下字段仅 ACPI 2.0+
+    uint32_t length;
+    uint64_t xsdt_address;
+    uint8_t extended_checksum;
+    uint8_t reserved[3];
+} __attribute__((packed)) acpi_rsdp_t;
+
+/* 所有系统描述表的公共头 */
+typedef struct {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed)) acpi_sdt_header_t;
+
+/* MADT 中记录的最大处理器数量 */
+#define ACPI_MAX_CPUS 32
+
+/* 从 MADT 中提取的中断控制器信息 */
+typedef struct {
+    uint32_t lapic_address;             // 本地 APIC 物理地址
+    uint32_t cpu_count;                 // 已启用的处理器数量
+    uint8_t apic_ids[ACPI_MAX_CPUS];    // 各处理器的 APIC ID
+    uint32_t ioapic_address;            // 第一个 I/O APIC（0 表示没有）
+    uint32_t ioapic_gsi_base;
+} acpi_madt_info_t;
+
+/* 使用 RSDP 初始化（为 NULL 时在 BIOS 区域搜索），成功返回 1 */
+int acpi_init(const acpi_rsdp_t *rsdp);
+
+/* 按签名查找系统描述表 */
+const acpi_sdt_header_t *acpi_find_table(const char *signature);
+
+/* 解析 MADT，成功返回 1 */
+int acpi_parse_madt(acpi_madt_info_t *info);
+
+#endif /* KERNEL_ACPI_H */
@@ -0,0 +1,39 @@
+#ifndef KERNEL_APIC_H
+#define KERNEL_APIC_H
+
+#include <stdint.h>
+
+/* 本地 APIC 默认物理地址 */
+#define LAPIC_DEFAULT_BASE   0xFEE00000
+
+/* 本地 APIC 使用的中断向量 */
+#define LAPIC_TIMER_VECTOR   0xEF
+#define IPI_RESCHED_VECTOR   0xF0
+#define LAPIC_SPURIOUS_VECTOR 0xFF
+
+/* 设置本地 APIC 寄存器基址（来自 MADT） */
+void lapic_set_base(uint32_t base);
+
+/* 是否已找到本地 APIC */
+int lapic_available(void);
+
+/* 启用当前 CPU 的本地 APIC */
+void lapic_init(void);
+
+/* 当前 CPU 的 APIC ID */
+uint32_t lapic_id(void);
+
+/* 发送 EOI */
+void lapic_eoi(void);
+
+/* 向指定 CPU 发送固定向量 IPI */
+void lapic_send_ipi(uint32_t apic_id, uint8_t vector);
+
+/* 启动 AP：INIT 与 STARTUP IPI */
+void lapic_send_init(uint32_t apic_id);
+void lapic_send_sipi(uint32_t apic_id, uint8_t page);
+
+/* 启动本地 APIC 周期定时器 */
+void lapic_timer_init(uint32_t hz);
+
+#endif /* KERNEL_APIC_H */
@@ -0,0 +1,20 @@
+#ifndef KERNEL_ATA_H
+#define KERNEL_ATA_H
+
+#include <stdint.h>
+
+/* 是否使用总线主控 DMA（关闭后所有传输走 PIO） */
+#ifndef CONFIG_ATA_DMA
+#define CONFIG_ATA_DMA 1
+#endif
+
+/* 每条命令最多传输的扇区数（LBA28 的扇区计数 0 表示 256） */
+#define ATA_MAX_SECTORS 256
+
+/* 每个通道的 PRD 表项数：256 扇区 = 128KB，按页拆分最多 33 项 */
+#define ATA_PRD_ENTRIES 64
+
+/* 查找 PCI IDE 控制器，识别硬盘并注册为块设备 hda-hdd */
+void ata_init(void);
+
+#endif /* KERNEL_ATA_H */
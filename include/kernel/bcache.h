@@ -0,0 +1,88 @@
+#ifndef KERNEL_BCACHE_H
+#define KERNEL_BCACHE_H
+
+#include <stdint.h>
+#include <kernel/blkdev.h>
+
+/* 缓存块大小（8 个扇区）与缓存块数（共 1MB） */
+#define BCACHE_BLOCK_SIZE   4096
+#define BCACHE_BLOCK_SECTORS (BCACHE_BLOCK_SIZE / BLKDEV_SECTOR_SIZE)
+#define BCACHE_BLOCKS       256
+
+/* 哈希桶数（必须是2的幂） */
+#define BCACHE_HASH_SIZE    512
+
+/* 预读窗口：检测到顺序访问后从 MIN 开始，每次未命中翻倍直到 MAX */
+#define BCACHE_RA_MIN       4
+#define BCACHE_RA_MAX       32
+
+/* 回写线程把脏块写回磁盘的周期（毫秒） */
+#ifndef CONFIG_BCACHE_WRITEBACK_MS
+#define CONFIG_BCACHE_WRITEBACK_MS 5000
+#endif
+
+/* 启动时顺序读两遍第一个块设备的开头，检查命中与预读 */
+#ifndef CONFIG_BCACHE_SELFTEST
+#define CONFIG_BCACHE_SELFTEST 1
+#endif
+#define BCACHE_SELFTEST_BYTES (256 * 1024)
+
+/* 缓存块标志 */
+#define BCACHE_VALID    0x01    // 数据有效
+#define BCACHE_DIRTY    0x02    // 已修改，尚未写回
+#define BCACHE_BUSY     0x04    // 正在读盘，数据尚不可用
+#define BCACHE_RA       0x08    // 由预读读入，尚未被访问
+#define BCACHE_WRITING  0x10    // 正在写回（数据仍可读写）
+
+typedef struct bcache_buf {
+    blkdev_t *dev;
+    uint32_t block;
+    uint16_t flags;
+    uint16_t refcount;          // 持有者数量，非 0 时不会被淘汰
+    struct bcache_buf *hash_next;
+    struct bcache_buf *lru_prev;    // LRU 链表：头部最近使用，尾部最先淘汰
+    struct bcache_buf *lru_next;
+    uint8_t *data;
+} bcache_buf_t;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t ra_blocks;         // 预读读入的块数
+    uint32_t ra_hits;           // 其中后来被访问到的块数
+    uint32_t evictions;
+    uint32_t writebacks;
+} bcache_stats_t;
+
+/* 初始化缓存并启动回写线程（在 thread_init 之后调用） */
+void bcache_init(void);
+
+/* 获取 (dev, block) 的缓存块并持有它，数据已读入；失败返回 NULL */
+bcache_buf_t *bcache_get(blkdev_t *dev, uint32_t block);
+
+/* 标记为脏（调用者持有该块且已修改 data） */
+void bcache_mark_dirty(bcache_buf_t *buf);
+
+/* 释放 bcache_get 得到的块 */
+void bcache_release(bcache_buf_t *buf);
+
+/* 按字节读写设备内容（经过缓存），成功返回 0 */
+int bcache_read(blkdev_t *dev, uint32_t offset, void *dst, uint32_t len);
+int bcache_write(blkdev_t *dev, uint32_t offset, const void *src, uint32_t len);
+
+/* 写回 dev 的所有脏块并刷设备缓存（dev 为 NULL 表示所有设备），成功返回 0 */
+int bcache_sync(blkdev_t *dev);
+
+/* 丢弃 dev 的所有未被持有的缓存块（先写回） */
+void bcache_invalidate(blkdev_t *dev);
+
+/* 读取统计计数 */
+void bcache_get_stats(bcache_stats_t *stats);
+
+/* 启动自检：两遍读到的内容须一致，第二遍须全部命中；没有块设备时跳过，失败返回 -1 */
+int bcache_selftest(void);
+
+/* 通过 printk 输出命中率与预读效果 */
+void bcache_report(void);
+
+#endif /* KERNEL_BCACHE_H */
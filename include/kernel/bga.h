@@ -0,0 +1,55 @@
+#ifndef KERNEL_BGA_H
+#define KERNEL_BGA_H
+
+#include <stdint.h>
+#include <kernel/graphics.h>
+
+/* Bochs/QEMU stdvga 的 DISPI 接口（Bochs Graphics Adapter） */
+#define VBE_DISPI_IOPORT_INDEX  0x1CE
+#define VBE_DISPI_IOPORT_DATA   0x1CF
+
+#define VBE_DISPI_INDEX_ID          0x0
+#define VBE_DISPI_INDEX_XRES        0x1
+#define VBE_DISPI_INDEX_YRES        0x2
+#define VBE_DISPI_INDEX_BPP         0x3
+#define VBE_DISPI_INDEX_ENABLE      0x4
+#define VBE_DISPI_INDEX_BANK        0x5
+#define VBE_DISPI_INDEX_VIRT_WIDTH  0x6
+#define VBE_DISPI_INDEX_VIRT_HEIGHT 0x7
+#define VBE_DISPI_INDEX_X_OFFSET    0x8
+#define VBE_DISPI_INDEX_Y_OFFSET    0x9
+#define VBE_DISPI_INDEX_VIDEO_MEMORY_64K 0xA
+
+#define VBE_DISPI_ID0               0xB0C0
+#define VBE_DISPI_ID5               0xB0C5
+
+#define VBE_DISPI_ENABLED           0x01
+#define VBE_DISPI_LFB_ENABLED       0x40
+#define VBE_DISPI_NOCLEARMEM        0x80
+
+/* 显存中的画面页数：2 为双缓冲，3 为三缓冲（显存不够时自动减少） */
+#ifndef CONFIG_BGA_PAGES
+#define CONFIG_BGA_PAGES 3
+#endif
+
+/* 探测 DISPI 并把虚拟高度设为多页（需在开启分页、设置写合并之前调用）。
+ * ctx 为 GRUB 设置好的可见帧缓冲，之后始终指向当前显示的页；返回页数，不是 DISPI 返回 0 */
+uint32_t bga_init(graphics_context_t *ctx);
+
+/* 显存大小（字节），不是 DISPI 时返回 0 */
+uint32_t bga_vram_size(void);
+
+/* 画面页数（0 或 1 表示不能翻页） */
+uint32_t bga_page_count(void);
+
+/* 下一次 bga_flip 将要显示的隐藏页，不能翻页时返回 NULL */
+graphics_context_t *bga_back_buffer(void);
+
+/* 改写 Y_OFFSET 显示隐藏页（无拷贝）；双缓冲时等待垂直回扫，避免在扫描中的页上作画 */
+void bga_flip(void);
+
+/* 运行时切换显示模式并重新分页，成功返回 0。
+ * 已映射帧缓冲的用户进程不会得到通知，只应在没有这类进程时调用 */
+int bga_set_mode(uint32_t width, uint32_t height, uint32_t bpp);
+
+#endif /* KERNEL_BGA_H */
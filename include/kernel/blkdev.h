@@ -0,0 +1,46 @@
+#ifndef KERNEL_BLKDEV_H
+#define KERNEL_BLKDEV_H
+
+#include <stdint.h>
+
+/* 最多注册的块设备数 */
+#define BLKDEV_MAX 8
+
+/* 扇区大小（目前只支持 512 字节扇区） */
+#define BLKDEV_SECTOR_SIZE 512
+
+struct blkdev;
+
+/* 驱动提供的操作：成功返回 0，失败返回 -1。
+ * buf 可以是任意内核或当前地址空间的用户地址，count 由驱动自行拆分。 */
+typedef struct {
+    int (*read)(struct blkdev *dev, uint32_t lba, uint32_t count, void *buf);
+    int (*write)(struct blkdev *dev, uint32_t lba, uint32_t count, const void *buf);
+    int (*flush)(struct blkdev *dev);   // 可为 NULL：设备没有写缓存
+} blkdev_ops_t;
+
+typedef struct blkdev {
+    char name[8];               // 如 "hda"
+    uint32_t sector_count;      // 总扇区数
+    uint32_t sector_size;       // 每扇区字节数
+    const blkdev_ops_t *ops;
+    void *priv;                 // 驱动私有数据
+} blkdev_t;
+
+/* 注册块设备，成功返回 0 */
+int blkdev_register(blkdev_t *dev);
+
+/* 按名字查找块设备，找不到返回 NULL */
+blkdev_t *blkdev_get(const char *name);
+
+/* 按序号遍历已注册的块设备 */
+blkdev_t *blkdev_get_index(uint32_t index);
+
+/* 读写 count 个扇区（检查越界），成功返回 0 */
+int blkdev_read(blkdev_t *dev, uint32_t lba, uint32_t count, void *buf);
+int blkdev_write(blkdev_t *dev, uint32_t lba, uint32_t count, const void *buf);
+
+/* 把设备写缓存刷到介质，成功返回 0 */
+int blkdev_flush(blkdev_t *dev);
+
+#endif /* KERNEL_BLKDEV_H */
@@ -0,0 +1,20 @@
+#ifndef KERNEL_BLKFS_H
+#define KERNEL_BLKFS_H
+
+#include <stdint.h>
+
+/* 启动时经 VFS 顺序读两遍 /dev 下第一个设备，检查页缓存命中 */
+#ifndef CONFIG_BLKFS_SELFTEST
+#define CONFIG_BLKFS_SELFTEST 1
+#endif
+#define BLKFS_SELFTEST_BYTES (128 * 1024)
+
+/* 把每个已注册的块设备作为只读文件挂载到 path 目录下（如 /dev/hda），
+ * 读取经过页缓存与块缓存。在 vfs_mount_root 之后调用，成功返回 0 */
+int blkfs_mount(const char *path);
+
+/* 启动自检：两遍内容须一致，第一遍每页恰好读盘一次，第二遍须全部命中页缓存；
+ * 没有块设备时跳过，失败返回 -1 */
+int blkfs_selftest(void);
+
+#endif /* KERNEL_BLKFS_H */
@@ -0,0 +1,19 @@
+#ifndef KERNEL_BOOTMEM_H
+#define KERNEL_BOOTMEM_H
+
+#include <stdint.h>
+
+/* 根据 Multiboot2 内存映射，在内核映像、引导信息和模块之后建立启动期页分配器
+ * （在 bootmod_init 之后调用） */
+void bootmem_init(uint32_t mb_info_addr);
+
+/* 分配 size 字节（按页取整）的物理连续内存，位于恒等映射区内；失败返回 NULL */
+void *bootmem_alloc(uint32_t size);
+
+/* 缩小最近一次分配（多余的页归还给分配器） */
+void bootmem_shrink(void *ptr, uint32_t old_size, uint32_t new_size);
+
+/* 剩余可分配的字节数 */
+uint32_t bootmem_available(void);
+
+#endif /* KERNEL_BOOTMEM_H */
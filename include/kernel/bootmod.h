@@ -0,0 +1,35 @@
+#ifndef KERNEL_BOOTMOD_H
+#define KERNEL_BOOTMOD_H
+
+#include <stdint.h>
+
+/* 最多记录的引导模块数 */
+#define BOOTMOD_MAX 8
+#define BOOTMOD_NAME_LEN 64
+
+/* GRUB 加载的模块：[start, end) 为物理地址（位于恒等映射区内，可直接访问） */
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+    char name[BOOTMOD_NAME_LEN];    // grub.cfg 中 module2 路径之后的参数
+    const void *data;               // 解压后的内容（首次 bootmod_data 时确定）
+    uint32_t size;
+} bootmod_t;
+
+/* 收集 Multiboot2 模块标签并保留模块所在的页 */
+void bootmod_init(uint32_t mb_info_addr);
+
+/* 按名字（参数的第一个词）查找模块，没有时返回 NULL */
+const bootmod_t *bootmod_find(const char *name);
+
+/* 模块内容：LZ4 帧压缩的模块首次访问时解压到启动期分配的页中，之后直接返回；
+ * 未压缩的模块原地返回。失败返回 NULL */
+const void *bootmod_data(const bootmod_t *mod, uint32_t *size);
+
+/* 按序号遍历模块 */
+const bootmod_t *bootmod_get(uint32_t index);
+
+/* [addr, addr+size) 是否与某个模块所在的页重叠（物理页分配器须跳过这些页） */
+int bootmod_is_reserved(uint32_t addr, uint32_t size);
+
+#endif /* KERNEL_BOOTMOD_H */
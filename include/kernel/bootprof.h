@@ -0,0 +1,23 @@
+#ifndef KERNEL_BOOTPROF_H
+#define KERNEL_BOOTPROF_H
+
+#include <stdint.h>
+
+/* 默认是否安静启动（也可通过内核命令行 "quiet" 开启） */
+#ifndef CONFIG_BOOT_QUIET
+#define CONFIG_BOOT_QUIET 0
+#endif
+
+/* 最多记录的启动阶段数 */
+#define BOOTPROF_MAX_STAGES 32
+
+/* 安静启动：抑制逐项的启动日志 */
+extern uint8_t boot_quiet;
+
+/* 开始一个新阶段（同时结束上一个阶段） */
+void bootprof_mark(const char *stage);
+
+/* 结束最后一个阶段并通过串口输出耗时表 */
+void bootprof_report(void);
+
+#endif /* KERNEL_BOOTPROF_H */
@@ -0,0 +1,64 @@
+#ifndef KERNEL_CIRRUS_H
+#define KERNEL_CIRRUS_H
+
+#include <stdint.h>
+#include <kernel/graphics.h>
+
+/* Cirrus Logic GD5446（QEMU -vga cirrus） */
+#define CIRRUS_VENDOR_ID        0x1013
+#define CIRRUS_DEVICE_GD5446    0x00B8
+
+/* 序列器与图形控制器端口 */
+#define CIRRUS_SEQ_INDEX        0x3C4
+#define CIRRUS_SEQ_DATA         0x3C5
+#define CIRRUS_GR_INDEX         0x3CE
+#define CIRRUS_GR_DATA          0x3CF
+
+/* SR6 写入该值解锁扩展寄存器 */
+#define CIRRUS_SR6_UNLOCK       0x12
+
+/* BitBLT 寄存器（图形控制器索引） */
+#define CIRRUS_GR_BG_COLOR0     0x00    // 背景色字节 0（1-3 在 0x10/0x12/0x14）
+#define CIRRUS_GR_FG_COLOR0     0x01    // 前景色字节 0（1-3 在 0x11/0x13/0x15）
+#define CIRRUS_GR_BLT_WIDTH     0x20    // 宽度（字节数 - 1），0x20-0x21
+#define CIRRUS_GR_BLT_HEIGHT    0x22    // 高度（行数 - 1），0x22-0x23
+#define CIRRUS_GR_BLT_DST_PITCH 0x24    // 0x24-0x25
+#define CIRRUS_GR_BLT_SRC_PITCH 0x26    // 0x26-0x27
+#define CIRRUS_GR_BLT_DST_ADDR  0x28    // 0x28-0x2A
+#define CIRRUS_GR_BLT_SRC_ADDR  0x2C    // 0x2C-0x2E
+#define CIRRUS_GR_BLT_MODE      0x30
+#define CIRRUS_GR_BLT_STATUS    0x31
+#define CIRRUS_GR_BLT_ROP       0x32
+#define CIRRUS_GR_BLT_MODE_EXT  0x33
+
+/* BLT 模式（GR30） */
+#define CIRRUS_BLTMODE_BACKWARDS    0x01
+#define CIRRUS_BLTMODE_MEMSYSSRC    0x04    // 源数据由 CPU 写入
+#define CIRRUS_BLTMODE_TRANSPARENT  0x08    // 颜色扩展时 0 位不写
+#define CIRRUS_BLTMODE_PIXELWIDTH8  0x00
+#define CIRRUS_BLTMODE_PIXELWIDTH16 0x10
+#define CIRRUS_BLTMODE_PIXELWIDTH24 0x20
+#define CIRRUS_BLTMODE_PIXELWIDTH32 0x30
+#define CIRRUS_BLTMODE_PATTERNCOPY  0x40
+#define CIRRUS_BLTMODE_COLOREXPAND  0x80
+
+/* BLT 状态（GR31） */
+#define CIRRUS_BLT_BUSY         0x01
+#define CIRRUS_BLT_START        0x02
+#define CIRRUS_BLT_RESET        0x04
+
+/* 扩展模式（GR33） */
+#define CIRRUS_BLTMODEEXT_SOLIDFILL 0x04
+
+/* 光栅操作（GR32）：目标 = 源 */
+#define CIRRUS_ROP_SRC          0x0D
+
+/* 引擎的尺寸限制 */
+#define CIRRUS_BLT_MAX_WIDTH    8192    // 字节
+#define CIRRUS_BLT_MAX_HEIGHT   1024
+#define CIRRUS_BLT_ADDR_MASK    0x3FFFFF
+
+/* 识别 GD5446 并把它安装为 graphics 的加速后端（需在 pci_init 之后调用），成功返回 0 */
+int cirrus_init(graphics_context_t *ctx);
+
+#endif /* KERNEL_CIRRUS_H */
@@ -0,0 +1,65 @@
+#ifndef KERNEL_CPU_FEATURES_H
+#define KERNEL_CPU_FEATURES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* CPU 特性编号（cpu_feature_bits 中的位） */
+typedef enum {
+    CPU_FEATURE_FPU = 0,
+    CPU_FEATURE_PSE,            // 4MB 页
+    CPU_FEATURE_TSC,
+    CPU_FEATURE_MSR,
+    CPU_FEATURE_APIC,
+    CPU_FEATURE_SEP,            // SYSENTER/SYSEXIT（已排除早期 Pentium Pro 的误报）
+    CPU_FEATURE_PAT,
+    CPU_FEATURE_FXSR,
+    CPU_FEATURE_SSE,
+    CPU_FEATURE_SSE2,
+    CPU_FEATURE_SSE3,
+    CPU_FEATURE_SSSE3,
+    CPU_FEATURE_SSE41,
+    CPU_FEATURE_SSE42,          // 含 crc32 指令
+    CPU_FEATURE_X2APIC,
+    CPU_FEATURE_AVX,            // 硬件支持；内核未开启 XSAVE，暂不使用
+    CPU_FEATURE_ERMS,           // 增强型 rep movsb/stosb
+    CPU_FEATURE_INVARIANT_TSC,  // TSC 频率不随 P/C 状态变化
+    CPU_FEATURE_COUNT
+} cpu_feature_t;
+
+/* CPUID 识别结果 */
+typedef struct {
+    char vendor[13];
+    uint32_t family, model, stepping;
+    uint32_t max_leaf, max_ext_leaf;
+} cpu_info_t;
+
+extern cpu_info_t cpu_info;
+extern uint32_t cpu_feature_bits;
+
+static inline int cpu_has(cpu_feature_t feature) {
+    return (cpu_feature_bits >> feature) & 1;
+}
+
+/* 启动时按 CPU 特性选择的例程；在 cpu_features_init 之前指向通用实现。
+ * 使用 SIMD 的实现依赖 #NM 惰性保存，只能在线程上下文中调用（memcpy 的实现不使用 SIMD） */
+typedef struct {
+    void *(*memcpy)(void *dest, const void *src, size_t num);
+    void (*fill_span)(uint32_t *dst, uint32_t color, size_t count);
+    void (*blend)(uint32_t *dst, const uint32_t *src, size_t count);    // ARGB 源覆盖
+    uint32_t (*checksum)(uint32_t crc, const void *data, size_t len);   // CRC32C
+    const char *memcpy_name, *fill_span_name, *blend_name, *checksum_name;
+} cpu_dispatch_t;
+
+extern cpu_dispatch_t cpu_dispatch;
+
+/* 解析 CPUID（BSP，在 fpu_init 之前调用） */
+void cpu_features_init(void);
+
+/* 在 fpu_init 之后按特性填充分发表 */
+void cpu_dispatch_init(void);
+
+/* 输出识别到的特性与选中的实现 */
+void cpu_features_report(void);
+
+#endif /* KERNEL_CPU_FEATURES_H */
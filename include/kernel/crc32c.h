@@ -0,0 +1,17 @@
+#ifndef KERNEL_CRC32C_H
+#define KERNEL_CRC32C_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <kernel/cpu_features.h>
+
+/* CRC32C（Castagnoli）。crc 为上一段的结果，首段传 0：
+ * crc32c(crc32c(0, a, n), b, m) 等于对 a、b 连接后的整体计算 */
+uint32_t crc32c_generic(uint32_t crc, const void *data, size_t len);
+uint32_t crc32c_sse42(uint32_t crc, const void *data, size_t len);
+
+static inline uint32_t crc32c(uint32_t crc, const void *data, size_t len) {
+    return cpu_dispatch.checksum(crc, data, len);
+}
+
+#endif /* KERNEL_CRC32C_H */
@@ -0,0 +1,41 @@
+#ifndef KERNEL_EVENT_H
+#define KERNEL_EVENT_H
+
+#include <stdint.h>
+
+/* 事件编号（最多 32 个，每个占 pending 位图的一位） */
+typedef enum {
+    EVENT_MOUSE = 0,            // 鼠标数据包到达
+    EVENT_CURSOR_REFRESH,       // 周期性重绘光标
+    EVENT_TRACE_DUMP,           // 导出跟踪缓冲区
+    EVENT_LOCK_REPORT,          // 输出锁竞争统计
+    EVENT_SYSCALL_BENCH,        // 运行系统调用往返基准
+    EVENT_COMPOSITE,            // 把用户表面的损坏区域合成到屏幕
+    EVENT_MODE_SWITCH,          // 切换显示模式
+    EVENT_COUNT
+} event_id_t;
+
+typedef void (*event_handler_t)(void);
+
+/* 初始化事件系统 */
+void event_init(void);
+
+/* 为事件注册处理函数（在事件循环所在线程中调用） */
+void event_register(event_id_t id, const char *name, event_handler_t handler);
+
+/* 触发事件，可在中断上下文调用 */
+void event_signal(event_id_t id);
+
+/* 每隔 period 个定时器 tick 自动触发一次（0 表示取消） */
+void event_set_periodic(event_id_t id, uint32_t period);
+
+/* 定时器中断中调用：触发到期的周期事件 */
+void event_timer_tick(uint32_t now);
+
+/* 事件循环：阻塞直到有事件待处理，然后只调用对应的处理函数 */
+void event_loop(void) __attribute__((noreturn));
+
+/* 输出各事件的触发与分发次数 */
+void event_report(void);
+
+#endif /* KERNEL_EVENT_H */
@@ -0,0 +1,33 @@
+#ifndef KERNEL_FPU_H
+#define KERNEL_FPU_H
+
+#include <stdint.h>
+#include <kernel/thread.h>
+
+/* 在 BSP 上开启 x87/SSE（在使用任何 SIMD 指令之前调用） */
+void fpu_init(void);
+
+/* 在 AP 上开启 x87/SSE，并进入惰性保存模式 */
+void fpu_init_ap(void);
+
+/* 线程系统就绪后开启惰性保存：安装 #NM/#MF/#XM 处理程序，当前线程成为 FPU 所有者 */
+void fpu_enable_lazy(void);
+
+/* 是否启用了 SSE（CR4.OSFXSR） */
+int fpu_sse_enabled(void);
+
+/* 调度器切换到 next 之前调用：next 不持有 FPU 寄存器时置位 CR0.TS */
+void fpu_switch(thread_t *next);
+
+/* 线程退出时放弃其 FPU 所有权 */
+void fpu_thread_exit(thread_t *t);
+
+/* 在任意上下文（包括中断）中临时使用 SIMD 寄存器：
+ * 关中断并把当前所有者的状态写回内存，kernel_fpu_end 后所有者下次使用时重新载入 */
+uint32_t kernel_fpu_begin(void);
+void kernel_fpu_end(uint32_t flags);
+
+/* #NM 触发的惰性状态切换次数 */
+uint32_t fpu_get_switch_count(void);
+
+#endif /* KERNEL_FPU_H */
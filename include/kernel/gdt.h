@@ -19,12 +19,33 @@ struct gdt_ptr {
     uint32_t base;          // GDT 表基址
 } __attribute__((packed));
 
+// 任务状态段（TSS），只用于特权级切换时提供内核栈
+struct tss_entry {
+    uint32_t prev_tss;
+    uint32_t esp0;          // 从用户态陷入时使用的内核栈
+    uint32_t ss0;           // 内核栈段选择子
+    uint32_t esp1;
+    uint32_t ss1;
+    uint32_t esp2;
+    uint32_t ss2;
+    uint32_t cr3;
+    uint32_t eip;
+    uint32_t eflags;
+    uint32_t eax, ecx, edx, ebx;
+    uint32_t esp, ebp, esi, edi;
+    uint32_t es, cs, ss, ds, fs, gs;
+    uint32_t ldt;
+    uint16_t trap;
+    uint16_t iomap_base;    // I/O 位图偏移（设为段界限之外表示无位图）
+} __attribute__((packed));
+
 // 段选择子定义
 #define KERNEL_CODE_SEG 0x08  // 内核代码段选择子
 #define KERNEL_DATA_SEG 0x10  // 内核数据段选择子
 #define USER_CODE_SEG   0x18  // 用户代码段选择子 (DPL=3)
 #define USER_DATA_SEG   0x20  // 用户数据段选择子 (DPL=3)
 #define TSS_SEG         0x28  // TSS 段选择子
+#define PERCPU_SEG      0x30  // 每 CPU 数据段选择子（加载到 GS）
 
 // 访问字节位定义
 #define GDT_ACCESS_PRESENT     (1 << 7)      // 段存在位
@@ -35,6 +56,7 @@ struct gdt_ptr {
 #define GDT_ACCESS_EXECUTABLE  (1 << 3)      // 可执行（代码段）
 #define GDT_ACCESS_READ_WRITE  (1 << 1)      // 可读/可写
 #define GDT_ACCESS_ACCESSED    (1 << 0)      // 已访问位
+#define GDT_ACCESS_TSS_32      0x09          // 32位可用TSS（系统段类型）
 
 // 粒度标志位定义
 #define GDT_FLAG_32BIT         (1 << 6)      // 32位保护模式
@@ -42,8 +64,10 @@ struct gdt_ptr {
 
 // 函数声明
 void gdt_init(void);
-void gdt_load(void);
-void gdt_set_entry(int index, uint32_t base, uint32_t limit, 
+void gdt_init_cpu(uint32_t cpu);
+void gdt_load(uint32_t cpu);
+void gdt_set_entry(uint32_t cpu, int index, uint32_t base, uint32_t limit, 
                    uint8_t access, uint8_t flags);
+void tss_set_kernel_stack(uint32_t esp0);
 
 #endif
\ No newline at end of file
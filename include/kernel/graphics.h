@@ -2,6 +2,7 @@
 #define KERNEL_GRAPHICS_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* 颜色定义 */
 #define COLOR_BLACK         0x000000
@@ -15,6 +16,7 @@
 #define COLOR_GRAY          0x808080
 #define COLOR_DARK_GRAY     0x404040
 #define COLOR_LIGHT_GRAY    0xC0C0C0
+#define COLOR_DESKTOP       0x000033    // 桌面底色
 
 /* 图形上下文 */
 typedef struct {
@@ -25,6 +27,32 @@ typedef struct {
     uint8_t bpp;
 } graphics_context_t;
 
+/* 2D 加速后端。每个操作返回 0 表示已由硬件完成（返回时硬件已空闲，CPU 可以直接读写帧缓冲），
+ * 返回 -1 表示不支持这次操作，调用者改用 CPU 绘制。坐标已由调用者裁剪到 ctx 之内 */
+typedef struct {
+    const char* name;
+    /* ctx 的帧缓冲是否位于该硬件可以访问的显存中 */
+    int (*supports)(const graphics_context_t* ctx);
+    int (*fill_rect)(graphics_context_t* ctx, uint32_t x, uint32_t y,
+                     uint32_t width, uint32_t height, uint32_t color);
+    /* 屏幕内拷贝，源与目标可以重叠 */
+    int (*copy_rect)(graphics_context_t* ctx, uint32_t dst_x, uint32_t dst_y,
+                     uint32_t src_x, uint32_t src_y, uint32_t width, uint32_t height);
+    /* 单色位图颜色扩展：每行 (width + 7) / 8 字节，最高位在左，1 画 color，0 透明 */
+    int (*expand_mono)(graphics_context_t* ctx, uint32_t x, uint32_t y,
+                       uint32_t width, uint32_t height, const uint8_t* bits, uint32_t color);
+} graphics_ops_t;
+
+/* 安装加速后端（NULL 表示只用 CPU） */
+void graphics_set_ops(const graphics_ops_t* ops);
+
+/* 能加速 ctx 的后端，没有时返回 NULL */
+const graphics_ops_t* graphics_accel(const graphics_context_t* ctx);
+
+/* 屏幕内矩形拷贝（源与目标可以重叠，超出屏幕的部分被裁掉） */
+void graphics_copy_rect(graphics_context_t* ctx, uint32_t dst_x, uint32_t dst_y,
+                        uint32_t src_x, uint32_t src_y, uint32_t width, uint32_t height);
+
 /* 函数声明 */
 void put_pixel(uint32_t x, uint32_t y, uint32_t color);  /* 添加这一行 */
 void graphics_init(graphics_context_t* ctx, uint32_t* framebuffer, 
@@ -44,4 +72,12 @@ void graphics_draw_char(graphics_context_t* ctx, uint32_t x, uint32_t y,
 void graphics_draw_string(graphics_context_t* ctx, uint32_t x, uint32_t y, 
                          const char* str, uint32_t color);
 uint32_t graphics_get_pixel(graphics_context_t* ctx, int x, int y);
+
+/* 行填充与 ARGB 源覆盖混合的各个实现，通过 cpu_dispatch 调用。
+ * 混合结果：c = (s*a + d*(255-a)) / 255（四舍五入），结果 alpha 按 s 的 alpha 为 255 计算 */
+void fill_span_generic(uint32_t* dst, uint32_t color, size_t count);
+void fill_span_stosd(uint32_t* dst, uint32_t color, size_t count);
+void fill_span_sse2(uint32_t* dst, uint32_t color, size_t count);
+void blend_span_generic(uint32_t* dst, const uint32_t* src, size_t count);
+void blend_span_sse2(uint32_t* dst, const uint32_t* src, size_t count);
 #endif /* KERNEL_GRAPHICS_H */
\ No newline at end of file
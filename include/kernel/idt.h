@@ -53,10 +53,21 @@ void idt_set_gate(uint8_t num, uint32_t base, uint16_t selector, uint8_t flags);
 // 中断处理函数类型
 typedef void (*interrupt_handler_t)(struct registers *);
 
+// 共享 IRQ 线上的处理程序：dev 是注册时的参数，设备确实发出了中断时返回 1
+typedef int (*irq_shared_handler_t)(struct registers *, void *dev);
+
+// 所有 IRQ 线合计最多注册的共享处理程序数
+#define IRQ_SHARED_MAX 8
+
 // 注册中断处理程序
 void register_interrupt_handler(uint8_t n, interrupt_handler_t handler);
 void register_irq_handler(uint8_t irq, interrupt_handler_t handler);
 
+// 在（可能由多个 PCI 设备共享的电平触发）IRQ 线上追加处理程序并启用该 IRQ，
+// 中断到来时依次调用该线上的所有处理程序。线已被独占处理程序占用或表已满时返回 -1，
+// 调用者应退回轮询
+int register_irq_shared(uint8_t irq, irq_shared_handler_t handler, void *dev);
+
 // C中断处理函数
 void isr_handler(struct registers *regs);
 void irq_handler(struct registers *regs);
@@ -111,5 +122,11 @@ extern void irq12(void);
 extern void irq13(void);
 extern void irq14(void);
 extern void irq15(void);
+extern void isr239(void);
+extern void isr240(void);
+extern void isr255(void);
+
+// int 0x80 系统调用入口
+extern void syscall_entry(void);
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define KERNEL_IO_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* 端口 I/O */
 static inline uint8_t inb(uint16_t port) {
@@ -14,9 +15,76 @@ static inline void outb(uint16_t port, uint8_t value) {
     asm volatile ("outb %0, %1" : : "a"(value), "Nd"(port));
 }
 
+static inline uint16_t inw(uint16_t port) {
+    uint16_t ret;
+    asm volatile ("inw %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static inline void outw(uint16_t port, uint16_t value) {
+    asm volatile ("outw %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    asm volatile ("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static inline void outl(uint16_t port, uint32_t value) {
+    asm volatile ("outl %0, %1" : : "a"(value), "Nd"(port));
+}
+
+/* 串操作：从同一端口连续读/写 count 个字 */
+static inline void insw(uint16_t port, void *buf, uint32_t count) {
+    asm volatile ("cld; rep insw" : "+D"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+static inline void outsw(uint16_t port, const void *buf, uint32_t count) {
+    asm volatile ("cld; rep outsw" : "+S"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+/* 保存 EFLAGS 并关中断，返回原 EFLAGS */
+static inline uint32_t irq_save(void) {
+    uint32_t flags;
+    asm volatile ("pushf\n" "pop %0\n" "cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+/* 恢复 irq_save 之前的中断状态 */
+static inline void irq_restore(uint32_t flags) {
+    if (flags & 0x200) {
+        asm volatile ("sti" : : : "memory");
+    }
+}
+
+/* CPUID 查询 */
+static inline void cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx) {
+    asm volatile ("cpuid" : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx) : "a"(leaf), "c"(0));
+}
+
+/* 模型特定寄存器 */
+static inline uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    asm volatile ("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t value) {
+    asm volatile ("wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+/* 串口默认波特率（可选 115200 / 57600 / 38400 ...） */
+#define SERIAL_DEFAULT_BAUD 115200
+
 /* 串口函数 */
 void serial_init();
+void serial_set_baud(uint32_t baud);
+void serial_enable_irq(void);
 void serial_putc(char c);
+void serial_write(const char* data, size_t len);
 void serial_puts(const char* str);
+void serial_flush(void);
+uint32_t serial_get_dropped(void);
 
 #endif /* KERNEL_IO_H */
\ No newline at end of file
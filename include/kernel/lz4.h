@@ -0,0 +1,30 @@
+#ifndef KERNEL_LZ4_H
+#define KERNEL_LZ4_H
+
+#include <stdint.h>
+
+/* LZ4 帧魔数（小端） */
+#define LZ4_FRAME_MAGIC 0x184D2204
+
+/* 是否校验帧中的块校验和与内容校验和（xxHash32） */
+#ifndef CONFIG_LZ4_VERIFY
+#define CONFIG_LZ4_VERIFY 1
+#endif
+
+/* 数据是否以 LZ4 帧开头 */
+int lz4_is_frame(const void *src, uint32_t len);
+
+/* 解压后大小：帧头带内容大小时为精确值，否则为按块数估计的上界；格式错误返回 0 */
+uint32_t lz4_frame_bound(const void *src, uint32_t len);
+
+/* 逐块解压一个或多个相连的帧到 dst，返回输出字节数，出错返回 -1 */
+int lz4_frame_decompress(const void *src, uint32_t len, void *dst, uint32_t cap);
+
+/* 解压一个原始块；dict 之前的输出不可被引用（独立块传 dst，链接块传本帧输出起点） */
+int lz4_block_decompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap,
+                         const uint8_t *dict);
+
+/* xxHash32 */
+uint32_t xxh32(const void *data, uint32_t len, uint32_t seed);
+
+#endif /* KERNEL_LZ4_H */
@@ -42,6 +42,8 @@ int mouse_check_button_click(uint8_t button_mask);
 
 /* 显示控制 */
 void mouse_set_visible(uint8_t visible);
+/* 分辨率改变后把指针限制在新的屏幕内（保存的背景已失效，由调用者重绘整个屏幕） */
+void mouse_clamp_to_screen(void);
 void mouse_force_redraw(void);
 
 /* 队列状态 */
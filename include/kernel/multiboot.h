@@ -0,0 +1,73 @@
+#ifndef KERNEL_MULTIBOOT_H
+#define KERNEL_MULTIBOOT_H
+
+#include <stdint.h>
+
+/* Multiboot2 信息结构 */
+typedef struct {
+    uint32_t total_size;
+    uint32_t reserved;
+} multiboot2_info_header_t;
+
+/* 标签头 */
+typedef struct {
+    uint32_t type;
+    uint32_t size;
+} multiboot_tag_header_t;
+
+/* 字符串标签（命令行、引导器名称） */
+typedef struct {
+    multiboot_tag_header_t header;
+    char string[];
+} multiboot_tag_string_t;
+
+/* 帧缓冲信息标签 */
+typedef struct {
+    multiboot_tag_header_t header;
+    uint64_t framebuffer_addr;
+    uint32_t framebuffer_pitch;
+    uint32_t framebuffer_width;
+    uint32_t framebuffer_height;
+    uint8_t framebuffer_bpp;
+    uint8_t framebuffer_type;
+    uint8_t reserved;
+} multiboot_tag_framebuffer_t;
+
+/* 模块标签（类型 3）：每个模块一个，string 为 grub.cfg 中模块路径之后的参数 */
+typedef struct {
+    multiboot_tag_header_t header;
+    uint32_t mod_start;
+    uint32_t mod_end;
+    char string[];
+} multiboot_tag_module_t;
+
+/* 内存映射标签（类型 6） */
+typedef struct {
+    uint64_t addr;
+    uint64_t len;
+    uint32_t type;              // 1 = 可用内存
+    uint32_t reserved;
+} __attribute__((packed)) multiboot_mmap_entry_t;
+
+typedef struct {
+    multiboot_tag_header_t header;
+    uint32_t entry_size;
+    uint32_t entry_version;
+} multiboot_tag_mmap_t;
+
+#define MULTIBOOT_MEMORY_AVAILABLE  1
+
+/* 标签类型 */
+#define MULTIBOOT_TAG_END           0
+#define MULTIBOOT_TAG_CMDLINE       1
+#define MULTIBOOT_TAG_MODULE        3
+#define MULTIBOOT_TAG_MMAP          6
+#define MULTIBOOT_TAG_FRAMEBUFFER   8
+
+/* 查找第一个指定类型的标签，没有时返回 NULL */
+multiboot_tag_header_t* multiboot_find_tag(uint32_t mb_info_addr, uint32_t type);
+
+/* 返回 tag 之后的下一个标签（到达结束标签时返回 NULL） */
+multiboot_tag_header_t* multiboot_next_tag(uint32_t mb_info_addr, multiboot_tag_header_t* tag);
+
+#endif /* KERNEL_MULTIBOOT_H */
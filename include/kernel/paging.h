@@ -0,0 +1,80 @@
+#ifndef KERNEL_PAGING_H
+#define KERNEL_PAGING_H
+
+#include <stdint.h>
+
+#define PAGE_SIZE       4096
+#define PAGE_MASK       (~(PAGE_SIZE - 1))
+#define LARGE_PAGE_SIZE 0x400000        // PSE 4MB 页
+
+/* 页目录/页表项标志 */
+#define PAGE_PRESENT    0x001
+#define PAGE_WRITE      0x002
+#define PAGE_USER       0x004
+#define PAGE_PWT        0x008
+#define PAGE_PCD        0x010
+#define PAGE_LARGE      0x080           // 页目录项：4MB 页
+
+/* PAT 表项 1 被设置为写合并（WC），PWT=1、PCD=0、PAT=0 的页即使用 WC；
+ * 不支持 PAT 的 CPU 上退化为写穿透 */
+#define PAGE_WRITE_COMBINE PAGE_PWT
+
+/* 地址空间布局：
+ * [0, 1GB)        内核恒等映射（4MB 页，仅内核可访问）
+ * [1GB, 3GB)      用户空间，每个进程独立映射（4KB 页）
+ * [3GB, 4GB)      MMIO 恒等映射（帧缓冲、APIC 等） */
+#define USER_BASE       0x40000000
+#define USER_TOP        0xC0000000
+#define USER_STACK_TOP  USER_TOP
+#define USER_STACK_PAGES 4
+
+/* 页帧池大小（进程页目录、页表和用户页都从这里分配） */
+#define FRAME_POOL_PAGES 256
+
+/* 建立内核页目录并开启分页（BSP） */
+void paging_init(void);
+
+/* 在 AP 上加载内核页目录并开启分页 */
+void paging_init_ap(void);
+
+/* 内核页目录的物理地址（分页开启前为 0） */
+extern uint32_t paging_kernel_cr3;
+
+/* 分配/释放一个清零的物理页帧，失败返回 NULL */
+void *frame_alloc(void);
+void frame_free(void *frame);
+
+/* 创建进程页目录（共享内核映射） */
+uint32_t *paging_create_directory(void);
+
+/* 释放页目录及其所有用户页 */
+void paging_destroy_directory(uint32_t *pd);
+
+/* 在用户空间映射一个新页，返回其物理地址（内核可直接访问），失败返回 NULL */
+void *paging_map_user_page(uint32_t *pd, uint32_t vaddr, uint32_t flags);
+
+/* 把已有的物理页（帧缓冲、内核共享缓冲区等）映射到用户空间，成功返回 0；
+ * 这些页不属于页帧池，销毁页目录时不会被释放 */
+int paging_map_user_phys(uint32_t *pd, uint32_t vaddr, uint32_t paddr, uint32_t flags);
+
+/* 把内核恒等映射中 [addr, addr+size) 设为写合并：完整覆盖的 4MB 页整页设置，
+ * 两端部分覆盖的大页拆成 4KB 页（需在启动 AP、创建进程之前调用） */
+void paging_set_write_combining(uint32_t addr, uint32_t size);
+
+/* 当前地址空间中虚拟地址对应的物理地址（DMA 用），未映射返回 0 */
+uint32_t paging_virt_to_phys(uint32_t vaddr);
+
+/* 检查 [addr, addr+len) 是否全部是已映射的用户页 */
+int paging_user_range_ok(uint32_t *pd, uint32_t addr, uint32_t len, int write);
+
+static inline uint32_t read_cr3(void) {
+    uint32_t cr3;
+    asm volatile("mov %%cr3, %0" : "=r"(cr3));
+    return cr3;
+}
+
+static inline void write_cr3(uint32_t cr3) {
+    asm volatile("mov %0, %%cr3" : : "r"(cr3) : "memory");
+}
+
+#endif /* KERNEL_PAGING_H */
@@ -0,0 +1,62 @@
+#ifndef KERNEL_PCI_H
+#define KERNEL_PCI_H
+
+#include <stdint.h>
+
+/* 枚举时记录的最大设备数 */
+#define PCI_MAX_DEVICES 32
+
+/* 配置空间寄存器偏移 */
+#define PCI_VENDOR_ID       0x00
+#define PCI_DEVICE_ID       0x02
+#define PCI_COMMAND         0x04
+#define PCI_STATUS          0x06
+#define PCI_PROG_IF         0x09
+#define PCI_SUBCLASS        0x0A
+#define PCI_CLASS           0x0B
+#define PCI_HEADER_TYPE     0x0E
+#define PCI_BAR0            0x10
+#define PCI_SUBSYSTEM_ID    0x2E
+#define PCI_CAP_PTR         0x34
+#define PCI_INTERRUPT_LINE  0x3C
+
+/* 命令寄存器位 */
+#define PCI_COMMAND_IO          0x0001
+#define PCI_COMMAND_MEMORY      0x0002
+#define PCI_COMMAND_BUS_MASTER  0x0004
+
+/* 设备类别 */
+#define PCI_CLASS_STORAGE       0x01
+#define PCI_SUBCLASS_IDE        0x01
+
+/* BAR 最低位为 1 表示 I/O 空间 */
+#define PCI_BAR_IO              0x1
+
+typedef struct {
+    uint8_t bus, dev, func;
+    uint16_t vendor, device;
+    uint8_t class_code, subclass, prog_if;
+    uint8_t irq;                // 中断线（PIC IRQ 号，0xFF 表示未连接）
+    uint32_t bar[6];
+} pci_device_t;
+
+/* 配置空间访问（机制 #1：0xCF8/0xCFC） */
+uint32_t pci_read32(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset);
+uint16_t pci_read16(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset);
+uint8_t pci_read8(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset);
+void pci_write32(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset, uint32_t value);
+void pci_write16(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset, uint16_t value);
+
+/* 枚举所有总线上的设备 */
+void pci_init(void);
+
+/* 按类别查找第 index 个设备，找不到返回 NULL */
+pci_device_t *pci_find_class(uint8_t class_code, uint8_t subclass, uint32_t index);
+
+/* 按厂商/设备 ID 查找第 index 个设备，找不到返回 NULL */
+pci_device_t *pci_find_device(uint16_t vendor, uint16_t device, uint32_t index);
+
+/* 打开 I/O、内存空间解码与总线主控（DMA） */
+void pci_enable_bus_master(pci_device_t *pdev);
+
+#endif /* KERNEL_PCI_H */
@@ -0,0 +1,43 @@
+#ifndef KERNEL_PERCPU_H
+#define KERNEL_PERCPU_H
+
+#include <stdint.h>
+#include <kernel/thread.h>
+#include <kernel/printk.h>
+
+/* 支持的最大 CPU 数量 */
+#define MAX_CPUS 8
+
+/* 每个 AP 启动栈的大小 */
+#define CPU_STACK_SIZE 16384
+
+/* 每 CPU 数据块，通过 GS 段（PERCPU_SEG）访问 */
+typedef struct cpu {
+    struct cpu *self;               // 偏移 0：%gs:0 即本结构地址
+    uint32_t id;                    // 逻辑 CPU 号（BSP 为 0）
+    uint32_t apic_id;               // 本地 APIC ID
+    volatile uint32_t online;       // AP 完成初始化后置 1
+    thread_t *current;              // 当前运行的线程
+    thread_t *idle;                 // 本 CPU 的空闲线程
+    thread_t *zombie;               // 刚退出、栈仍在使用中的线程
+    volatile uint32_t need_resched; // 在下一个抢占点重新调度
+    runqueue_t rq;                  // 本 CPU 的就绪队列
+    uint32_t stack_top;             // 启动栈栈顶
+    thread_t *fpu_owner;            // FPU 寄存器中保存的是哪个线程的状态
+    printk_line_t log;              // printk 行缓冲区
+} cpu_t;
+
+extern cpu_t cpus[MAX_CPUS];
+extern volatile uint32_t cpu_count;
+
+/* 获取当前 CPU 的数据块（GDT 初始化之后才可使用） */
+static inline cpu_t *this_cpu(void) {
+    cpu_t *cpu;
+    asm volatile ("movl %%gs:0, %0" : "=r"(cpu));
+    return cpu;
+}
+
+/* 初始化 CPU 数据块（在该 CPU 加载 GDT 之前调用） */
+void percpu_init(uint32_t id);
+
+#endif /* KERNEL_PERCPU_H */
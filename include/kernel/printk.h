@@ -0,0 +1,72 @@
+#ifndef KERNEL_PRINTK_H
+#define KERNEL_PRINTK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <kernel/string.h>
+
+/* 日志级别（数值越小越重要） */
+#define LOG_ERR   0
+#define LOG_WARN  1
+#define LOG_INFO  2
+#define LOG_DEBUG 3
+
+/* 编译期阈值：高于该级别的 pr_* 调用连同参数一起被去掉 */
+#ifndef CONFIG_LOG_LEVEL
+#define CONFIG_LOG_LEVEL LOG_INFO
+#endif
+
+/* 每 CPU 行缓冲区大小；超长的行被拆开输出 */
+#define PRINTK_LINE_MAX 256
+
+/* 正在拼接的一行：buf 中没有换行，level 取自这一行的第一次 printk */
+typedef struct {
+    char buf[PRINTK_LINE_MAX];
+    uint32_t len;
+    int level;
+} printk_line_t;
+
+/* 最多可注册的输出端 */
+#define PRINTK_MAX_SINKS 4
+
+/* 输出端收到的是完整的一行（含结尾换行，不含 '\0'），调用时已关中断 */
+typedef void (*printk_sink_fn)(int level, const char *line, size_t len);
+
+/* 格式化后追加到当前 CPU 的行缓冲区，遇到换行时交给所有输出端 */
+void printk(int level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void vprintk(int level, const char *format, va_list args);
+
+/* 注册输出端：只接收级别不高于 max_level 的行，成功返回 0 */
+int printk_register_sink(const char *name, int max_level, printk_sink_fn write);
+
+/* GDT 载入 GS 之后调用，从此改用每 CPU 行缓冲区 */
+void printk_init(void);
+
+/* 把当前 CPU 缓冲区中未换行的内容立即输出（panic 路径） */
+void printk_flush(void);
+
+#if CONFIG_LOG_LEVEL >= LOG_ERR
+#define pr_err(...)   printk(LOG_ERR, __VA_ARGS__)
+#else
+#define pr_err(...)   ((void)0)
+#endif
+
+#if CONFIG_LOG_LEVEL >= LOG_WARN
+#define pr_warn(...)  printk(LOG_WARN, __VA_ARGS__)
+#else
+#define pr_warn(...)  ((void)0)
+#endif
+
+#if CONFIG_LOG_LEVEL >= LOG_INFO
+#define pr_info(...)  printk(LOG_INFO, __VA_ARGS__)
+#else
+#define pr_info(...)  ((void)0)
+#endif
+
+#if CONFIG_LOG_LEVEL >= LOG_DEBUG
+#define pr_debug(...) printk(LOG_DEBUG, __VA_ARGS__)
+#else
+#define pr_debug(...) ((void)0)
+#endif
+
+#endif /* KERNEL_PRINTK_H */
@@ -0,0 +1,38 @@
+#ifndef KERNEL_PROCESS_H
+#define KERNEL_PROCESS_H
+
+#include <stdint.h>
+#include <kernel/thread.h>
+#include <kernel/idt.h>
+
+/* 同时存在的用户进程数量上限 */
+#define PROCESS_MAX 8
+
+/* 用户进程：一个地址空间 + 一个线程 */
+typedef struct process {
+    uint32_t pid;
+    uint32_t *page_dir;         // 页目录（物理地址，内核可直接访问）
+    thread_t *thread;
+    uint32_t entry;             // 用户态入口
+    uint8_t used;
+    uint8_t fb_mapped;          // 帧缓冲已映射到 USER_FB_BASE
+    struct surface *surface;    // 共享离屏表面（可为 NULL）
+    char name[THREAD_NAME_LEN];
+} process_t;
+
+/* 将 image 装载到 USER_BASE 并创建进程，失败返回 NULL */
+process_t *process_create(const char *name, const void *image, uint32_t size);
+
+/* 当前线程所属的进程（内核线程返回 NULL） */
+process_t *process_current(void);
+
+/* 映射了帧缓冲的进程数（切换显示模式前检查） */
+uint32_t process_count_fb_mapped(void);
+
+/* 结束当前进程，释放地址空间 */
+void process_exit(int code) __attribute__((noreturn));
+
+/* 异常处理程序开头调用：来自用户态时终止当前进程（不返回），来自内核态时直接返回 */
+void process_handle_fault(struct registers *regs, const char *what);
+
+#endif /* KERNEL_PROCESS_H */
@@ -0,0 +1,51 @@
+#ifndef KERNEL_RAMFS_H
+#define KERNEL_RAMFS_H
+
+#include <stdint.h>
+
+/* 节点数、路径字符串池与哈希桶数（必须是2的幂） */
+#define RAMFS_MAX_NODES     256
+#define RAMFS_NAME_POOL     16384
+#define RAMFS_HASH_SIZE     256
+#define RAMFS_PATH_MAX      256
+
+typedef enum {
+    RAMFS_FILE = 1,
+    RAMFS_DIR = 2,
+} ramfs_type_t;
+
+/* 只读 ramfs 节点：文件内容直接指向引导模块中的 USTAR 数据，不做拷贝 */
+typedef struct ramfs_node {
+    const char *path;           // 规范化的完整路径（无前导 '/'，根为 ""）
+    const char *name;           // 最后一个路径分量
+    const uint8_t *data;        // 文件内容
+    uint32_t size;
+    uint32_t mode;
+    uint32_t mtime;
+    uint8_t type;
+    uint32_t hash;
+    struct ramfs_node *hash_next;
+    struct ramfs_node *parent;
+    struct ramfs_node *first_child;
+    struct ramfs_node *next_sibling;
+} ramfs_node_t;
+
+/* 索引一个 USTAR 归档（内存需在 ramfs 的整个生命周期内保持有效），返回文件数，格式错误返回 -1 */
+int ramfs_init(const void *image, uint32_t size);
+
+/* 根目录 */
+const ramfs_node_t *ramfs_root(void);
+
+/* 按路径查找（前导 '/'、重复 '/'、末尾 '/' 均可），找不到返回 NULL */
+const ramfs_node_t *ramfs_lookup(const char *path);
+
+/* 零拷贝读取：返回 offset 处数据的指针，*len 为从该处到文件末尾的字节数 */
+const void *ramfs_map(const ramfs_node_t *node, uint32_t offset, uint32_t *len);
+
+/* 拷贝读取，返回实际读到的字节数 */
+uint32_t ramfs_read(const ramfs_node_t *node, uint32_t offset, void *dst, uint32_t len);
+
+/* 把已索引的 ramfs 挂载为 VFS 根文件系统（在 vfs_init 与 ramfs_init 之后调用），成功返回 0 */
+int ramfs_mount(void);
+
+#endif /* KERNEL_RAMFS_H */
@@ -0,0 +1,51 @@
+#ifndef KERNEL_RENDER_H
+#define KERNEL_RENDER_H
+
+#include <stdint.h>
+#include <kernel/graphics.h>
+
+/* 瓦片边长：64x64x4 字节 = 16KB，一块瓦片能放进 L1 数据缓存 */
+#define RENDER_TILE_SIZE 64
+
+/* 绘制列表容量 */
+#define RENDER_MAX_OPS  64
+#define RENDER_TEXT_LEN 48
+
+typedef enum {
+    RENDER_OP_FILL = 0,         // 填充矩形（水平/垂直线是宽或高为 1 的矩形）
+    RENDER_OP_OUTLINE,          // 矩形边框
+    RENDER_OP_TEXT              // 位图字体字符串
+} render_op_type_t;
+
+/* 一个绘制操作，按加入顺序绘制（后加入的覆盖先加入的） */
+typedef struct {
+    render_op_type_t type;
+    int32_t x, y;
+    uint32_t width, height;     // 文本操作为包围盒大小
+    uint32_t color;
+    char text[RENDER_TEXT_LEN];
+} render_op_t;
+
+/* 绘制列表：描述一帧画面，可按任意区域重新光栅化 */
+typedef struct {
+    render_op_t ops[RENDER_MAX_OPS];
+    uint32_t count;
+} render_list_t;
+
+void render_list_clear(render_list_t* list);
+void render_fill(render_list_t* list, int32_t x, int32_t y,
+                 uint32_t width, uint32_t height, uint32_t color);
+void render_outline(render_list_t* list, int32_t x, int32_t y,
+                    uint32_t width, uint32_t height, uint32_t color);
+void render_hline(render_list_t* list, int32_t x, int32_t y,
+                  uint32_t length, uint32_t color);
+void render_vline(render_list_t* list, int32_t x, int32_t y,
+                  uint32_t length, uint32_t color);
+void render_text(render_list_t* list, int32_t x, int32_t y,
+                 const char* str, uint32_t color);
+
+/* 重绘损坏区域：按瓦片切分后在所有 CPU 上并行光栅化（仅支持 32bpp） */
+void render_damage(graphics_context_t* ctx, const render_list_t* list,
+                   int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+#endif /* KERNEL_RENDER_H */
@@ -0,0 +1,15 @@
+#ifndef KERNEL_SMP_H
+#define KERNEL_SMP_H
+
+#include <stdint.h>
+
+/* AP 启动蹦床的物理地址（必须低于 1MB 且按页对齐） */
+#define TRAMPOLINE_BASE 0x8000
+
+/* 通过 MADT 发现并启动所有 AP，rsdp 为 NULL 时在 BIOS 区域搜索 */
+void smp_init(const void *rsdp);
+
+/* 在线 CPU 数量 */
+uint32_t smp_cpu_count(void);
+
+#endif /* KERNEL_SMP_H */
@@ -0,0 +1,245 @@
+#ifndef KERNEL_SPINLOCK_H
+#define KERNEL_SPINLOCK_H
+
+#include <stdint.h>
+#include <kernel/io.h>
+#include <kernel/tsc.h>
+
+/* 是否统计锁竞争（获取次数、竞争次数、自旋周期） */
+#ifndef CONFIG_LOCK_STATS
+#define CONFIG_LOCK_STATS 1
+#endif
+
+/* 锁竞争统计，通过 *_init 登记后可由 lock_stats_report 输出 */
+typedef struct lock_stats {
+    const char *name;
+    uint32_t acquired;              // 获取次数
+    uint32_t contended;             // 需要等待的次数
+    uint64_t spin_cycles;           // 等待花费的 TSC 周期
+    struct lock_stats *next;        // 登记链表
+} lock_stats_t;
+
+#if CONFIG_LOCK_STATS
+#define LOCK_STATS_FIELD lock_stats_t stats;
+#define LOCK_STATS_INIT  , { 0, 0, 0, 0, 0 }
+/* 写锁/互斥锁持有期间更新，读锁需原子更新 */
+#define lock_stat_acquired(s)        ((s)->acquired++)
+#define lock_stat_contended(s, c)    ((s)->contended++, (s)->spin_cycles += (c))
+#define lock_stat_acquired_shared(s) __atomic_fetch_add(&(s)->acquired, 1, __ATOMIC_RELAXED)
+#define lock_stat_contended_shared(s, c) \
+    (__atomic_fetch_add(&(s)->contended, 1, __ATOMIC_RELAXED), \
+     __atomic_fetch_add(&(s)->spin_cycles, (c), __ATOMIC_RELAXED))
+#define lock_stat_now()              rdtsc()
+#else
+#define LOCK_STATS_FIELD
+#define LOCK_STATS_INIT
+#define lock_stat_acquired(s)            ((void)0)
+#define lock_stat_contended(s, c)        ((void)0)
+#define lock_stat_acquired_shared(s)     ((void)0)
+#define lock_stat_contended_shared(s, c) ((void)0)
+#define lock_stat_now()                  0
+#endif
+
+/* 登记一个锁的统计信息（name 必须长期有效） */
+void lock_stats_register(lock_stats_t *stats, const char *name);
+
+/* 通过串口输出所有已登记锁的统计 */
+void lock_stats_report(void);
+
+/* ---------- 测试-设置自旋锁：最轻量，不保证公平 ---------- */
+
+typedef struct {
+    volatile uint32_t locked;
+    LOCK_STATS_FIELD
+} spinlock_t;
+
+#define SPINLOCK_INIT { 0 LOCK_STATS_INIT }
+
+static inline void spin_lock_init(spinlock_t *lock, const char *name) {
+    lock->locked = 0;
+#if CONFIG_LOCK_STATS
+    lock_stats_register(&lock->stats, name);
+#endif
+}
+
+static inline void spin_lock(spinlock_t *lock) {
+    if (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+        uint64_t start = lock_stat_now();
+        do {
+            // 只读等待，避免反复抢占缓存行
+            while (lock->locked) {
+                asm volatile ("pause");
+            }
+        } while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE));
+        lock_stat_contended(&lock->stats, lock_stat_now() - start);
+    }
+    lock_stat_acquired(&lock->stats);
+}
+
+static inline void spin_unlock(spinlock_t *lock) {
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t spin_lock_irqsave(spinlock_t *lock) {
+    uint32_t flags = irq_save();
+    spin_lock(lock);
+    return flags;
+}
+
+static inline void spin_unlock_irqrestore(spinlock_t *lock, uint32_t flags) {
+    spin_unlock(lock);
+    irq_restore(flags);
+}
+
+/* ---------- 票据锁：按请求顺序获得，多 CPU 争用时保证公平 ---------- */
+
+typedef struct {
+    volatile uint32_t next;         // 下一张票
+    volatile uint32_t owner;        // 当前持有者的票号
+    LOCK_STATS_FIELD
+} ticket_lock_t;
+
+#define TICKET_LOCK_INIT { 0, 0 LOCK_STATS_INIT }
+
+static inline void ticket_lock_init(ticket_lock_t *lock, const char *name) {
+    lock->next = 0;
+    lock->owner = 0;
+#if CONFIG_LOCK_STATS
+    lock_stats_register(&lock->stats, name);
+#endif
+}
+
+static inline void ticket_lock(ticket_lock_t *lock) {
+    uint32_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket) {
+        uint64_t start = lock_stat_now();
+        while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket) {
+            asm volatile ("pause");
+        }
+        lock_stat_contended(&lock->stats, lock_stat_now() - start);
+    }
+    lock_stat_acquired(&lock->stats);
+}
+
+static inline void ticket_unlock(ticket_lock_t *lock) {
+    // 只有持有者修改 owner，无需原子加
+    __atomic_store_n(&lock->owner, lock->owner + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t ticket_lock_irqsave(ticket_lock_t *lock) {
+    uint32_t flags = irq_save();
+    ticket_lock(lock);
+    return flags;
+}
+
+static inline void ticket_unlock_irqrestore(ticket_lock_t *lock, uint32_t flags) {
+    ticket_unlock(lock);
+    irq_restore(flags);
+}
+
+/* ---------- 读写自旋锁：读者并发，写者优先 ---------- */
+
+#define RWLOCK_WRITER 0x80000000u   // 最高位：写者持有或等待
+#define RWLOCK_READERS 0x7FFFFFFFu  // 低位：当前读者数量
+
+typedef struct {
+    volatile uint32_t value;
+    LOCK_STATS_FIELD
+} rwlock_t;
+
+#define RWLOCK_INIT { 0 LOCK_STATS_INIT }
+
+static inline void rwlock_init(rwlock_t *lock, const char *name) {
+    lock->value = 0;
+#if CONFIG_LOCK_STATS
+    lock_stats_register(&lock->stats, name);
+#endif
+}
+
+static inline void read_lock(rwlock_t *lock) {
+    uint64_t start = 0;
+    int waited = 0;
+
+    while (1) {
+        // 有写者持有或等待时不再进入，避免写者饥饿
+        while (__atomic_load_n(&lock->value, __ATOMIC_RELAXED) & RWLOCK_WRITER) {
+            if (!waited) {
+                start = lock_stat_now();
+                waited = 1;
+            }
+            asm volatile ("pause");
+        }
+        if (!(__atomic_fetch_add(&lock->value, 1, __ATOMIC_ACQUIRE) & RWLOCK_WRITER)) {
+            break;
+        }
+        __atomic_fetch_sub(&lock->value, 1, __ATOMIC_RELAXED);
+    }
+
+    if (waited) {
+        lock_stat_contended_shared(&lock->stats, lock_stat_now() - start);
+    }
+    lock_stat_acquired_shared(&lock->stats);
+    (void)start;
+}
+
+static inline void read_unlock(rwlock_t *lock) {
+    __atomic_fetch_sub(&lock->value, 1, __ATOMIC_RELEASE);
+}
+
+static inline void write_lock(rwlock_t *lock) {
+    uint64_t start = 0;
+    int waited = 0;
+
+    // 先占住写者位，再等待已有读者退出
+    while (__atomic_fetch_or(&lock->value, RWLOCK_WRITER, __ATOMIC_ACQUIRE) & RWLOCK_WRITER) {
+        if (!waited) {
+            start = lock_stat_now();
+            waited = 1;
+        }
+        while (__atomic_load_n(&lock->value, __ATOMIC_RELAXED) & RWLOCK_WRITER) {
+            asm volatile ("pause");
+        }
+    }
+    while (__atomic_load_n(&lock->value, __ATOMIC_ACQUIRE) & RWLOCK_READERS) {
+        if (!waited) {
+            start = lock_stat_now();
+            waited = 1;
+        }
+        asm volatile ("pause");
+    }
+
+    if (waited) {
+        lock_stat_contended(&lock->stats, lock_stat_now() - start);
+    }
+    lock_stat_acquired(&lock->stats);
+    (void)start;
+}
+
+static inline void write_unlock(rwlock_t *lock) {
+    __atomic_fetch_and(&lock->value, ~RWLOCK_WRITER, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t read_lock_irqsave(rwlock_t *lock) {
+    uint32_t flags = irq_save();
+    read_lock(lock);
+    return flags;
+}
+
+static inline void read_unlock_irqrestore(rwlock_t *lock, uint32_t flags) {
+    read_unlock(lock);
+    irq_restore(flags);
+}
+
+static inline uint32_t write_lock_irqsave(rwlock_t *lock) {
+    uint32_t flags = irq_save();
+    write_lock(lock);
+    return flags;
+}
+
+static inline void write_unlock_irqrestore(rwlock_t *lock, uint32_t flags) {
+    write_unlock(lock);
+    irq_restore(flags);
+}
+
+#endif /* KERNEL_SPINLOCK_H */
@@ -5,6 +5,11 @@
 #include <stdarg.h>
 #include <stdint.h>
 
+/* 启动时自检内存操作函数 */
+#ifndef CONFIG_STRING_SELFTEST
+#define CONFIG_STRING_SELFTEST 1
+#endif
+
 /* 可变参数支持 */
 typedef __builtin_va_list va_list;
 #define va_start(v,l)   __builtin_va_start(v,l)
@@ -20,6 +25,16 @@ void* memcpy(void* dest, const void* src, size_t num);
 void* memmove(void* dest, const void* src, size_t num);
 int memcmp(const void* ptr1, const void* ptr2, size_t num);
 
+/* 非临时拷贝：目标只写不读（如帧缓冲）时使用，不污染缓存 */
+void* memcpy_nt(void* dest, const void* src, size_t num);
+
+/* memcpy 的两种实现，由 cpu_dispatch_init 选择 */
+void* memcpy_rep_movsd(void* dest, const void* src, size_t num);
+void* memcpy_rep_movsb(void* dest, const void* src, size_t num);
+
+/* 与逐字节参照实现比较，失败返回 -1（在 cpu_dispatch_init 之后调用） */
+int string_selftest(void);
+
 /* 字符串操作 */
 int strcmp(const char* str1, const char* str2);
 char* strcpy(char* dest, const char* src);
@@ -41,6 +56,8 @@ void string_append(char* dest, const char* src);
 
 /* 格式化输出 */
 int vsnprintf(char* str, size_t size, const char* format, va_list args);
+/* 同 vsnprintf，但丢弃输出的前 skip 个字符（分段格式化超出缓冲区的长输出） */
+int vsnprintf_skip(char* str, size_t size, size_t skip, const char* format, va_list args);
 int snprintf(char* str, size_t size, const char* format, ...);
 
 #endif /* KERNEL_STRING_H */
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef KERNEL_SURFACE_H
+#define KERNEL_SURFACE_H
+
+#include <stdint.h>
+#include <kernel/process.h>
+
+/* 共享表面数量与每个表面的最大字节数（32 位像素） */
+#define SURFACE_MAX       4
+#define SURFACE_SLOT_SIZE 0x100000
+
+/* 用户空间中的映射位置 */
+#define USER_FB_BASE      0x80000000    // 帧缓冲（写合并）
+#define USER_SURFACE_BASE 0x90000000    // 离屏表面
+
+/* surface_create 的标志 */
+#define SURFACE_ALPHA     0x1           // 按像素 alpha 与屏幕上已有内容混合（源覆盖）
+
+/* 返回给用户的帧缓冲信息 */
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t pitch;             // 每行字节数
+    uint32_t bpp;
+} fb_info_t;
+
+/* 内核分配、映射给进程的离屏表面，由内核合成到帧缓冲 */
+typedef struct surface {
+    uint32_t *pixels;           // 内核地址（恒等映射，与用户映射共享同一物理页）
+    uint32_t width, height;
+    uint32_t pitch;             // 每行字节数
+    int32_t x, y;               // 屏幕上的位置
+    process_t *owner;
+    uint8_t used;
+    uint8_t damaged;
+    uint8_t flags;              // SURFACE_*
+    uint8_t shown;              // 已合成到屏幕上
+    int32_t shown_x, shown_y;   // 上次合成时的位置，与 x, y 不同表示有待完成的移动
+    int32_t dx0, dy0, dx1, dy1; // 待合成的损坏区域（表面坐标，已合并）
+} surface_t;
+
+/* 重绘屏幕矩形内的桌面（表面移走后露出的区域） */
+typedef void (*surface_background_fn)(int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+/* 把帧缓冲映射到进程的 USER_FB_BASE，返回用户地址，失败返回 0 */
+uint32_t surface_map_framebuffer(process_t *proc, fb_info_t *info);
+
+/* 为进程分配并映射一个离屏表面（每个进程一个），返回用户地址，失败返回 0 */
+uint32_t surface_create(process_t *proc, uint32_t width, uint32_t height, int32_t x, int32_t y,
+                        uint32_t surface_flags);
+
+/* 标记表面的损坏区域并请求合成，成功返回 0 */
+int surface_present(process_t *proc, int32_t x, int32_t y, uint32_t width, uint32_t height);
+
+/* 把表面移到屏幕上的 (x, y) 并请求合成：已合成的像素在屏幕内直接搬移，
+ * 露出的区域重绘桌面与下方的表面，成功返回 0 */
+int surface_move(process_t *proc, int32_t x, int32_t y);
+
+/* 设置露出区域的桌面重绘函数（NULL 表示填桌面底色） */
+void surface_set_background(surface_background_fn redraw);
+
+/* 把所有表面的损坏区域合成到帧缓冲（EVENT_COMPOSITE 处理函数，只在事件线程中调用） */
+void surface_composite(void);
+
+/* 进程退出时释放其表面 */
+void surface_release(process_t *proc);
+
+#endif /* KERNEL_SURFACE_H */
@@ -0,0 +1,57 @@
+#ifndef KERNEL_SYSCALL_H
+#define KERNEL_SYSCALL_H
+
+#include <stdint.h>
+#include <kernel/idt.h>
+
+/* 系统调用向量（DPL=3 陷阱门） */
+#define SYSCALL_VECTOR 0x80
+
+/* 系统调用号：eax 传入，参数依次为 ebx, ecx, edx, esi, edi，返回值写回 eax
+ * （userprog.asm 中有一份相同的定义） */
+#define SYS_EXIT    0       // exit(code)
+#define SYS_WRITE   1       // write(buf, len) -> 写入串口的字节数
+#define SYS_YIELD   2       // yield()
+#define SYS_GETPID  3       // getpid() -> pid
+#define SYS_SLEEP   4       // sleep(ticks)
+#define SYS_FB_MAP  5       // fb_map(fb_info_t *info) -> 帧缓冲的用户地址
+#define SYS_SURFACE_CREATE  6   // surface_create(width, height, x, y, flags) -> 表面的用户地址
+#define SYS_SURFACE_PRESENT 7   // surface_present(x, y, width, height)
+#define SYS_SURFACE_MOVE    8   // surface_move(x, y)
+#define SYSCALL_COUNT 9
+
+/* vsyscall 页：用户程序 call VSYSCALL_BASE 发起系统调用，
+ * 内核按 CPU 是否支持 SYSENTER 装入不同的实现（vsyscall.asm 中有一份相同的定义） */
+#define VSYSCALL_BASE 0xBFFF0000
+
+/* 错误返回值 */
+#define SYSCALL_ENOSYS ((uint32_t)-1)   // 未知系统调用
+#define SYSCALL_EFAULT ((uint32_t)-2)   // 无效的用户指针
+#define SYSCALL_EINVAL ((uint32_t)-3)   // 参数无效
+#define SYSCALL_ENOMEM ((uint32_t)-4)   // 资源不足
+
+/* 系统调用处理函数直接读写中断栈上的寄存器帧，不做额外复制 */
+typedef void (*syscall_handler_t)(struct registers *regs);
+
+/* 安装 int 0x80 陷阱门 */
+void syscall_init(void);
+
+/* 在 AP 上配置 SYSENTER MSR */
+void syscall_init_ap(void);
+
+/* 上下文切换到用户进程线程时设置 SYSENTER 使用的内核栈 */
+void sysenter_set_stack(uint32_t esp0);
+
+/* 是否启用了 SYSENTER 快速路径 */
+int syscall_sysenter_enabled(void);
+
+/* 返回应装入 vsyscall 页的代码 */
+const void *syscall_vsyscall_image(uint32_t *size);
+
+/* 由 syscall_entry（interrupt.asm）与 sysenter_entry（vsyscall.asm）调用 */
+void syscall_dispatch(struct registers *regs);
+
+/* 各系统调用的调用次数 */
+uint32_t syscall_get_count(uint32_t nr);
+
+#endif /* KERNEL_SYSCALL_H */
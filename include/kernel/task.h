@@ -0,0 +1,42 @@
+#ifndef KERNEL_TASK_H
+#define KERNEL_TASK_H
+
+#include <stdint.h>
+
+/* 每 CPU 任务双端队列容量（必须是2的幂） */
+#define TASK_DEQUE_SIZE 256
+#define TASK_DEQUE_MASK (TASK_DEQUE_SIZE - 1)
+
+/* 并行循环体：处理下标 [begin, end) */
+typedef void (*task_range_func_t)(void *arg, uint32_t begin, uint32_t end);
+
+/* 一次 parallel_for 的共享状态 */
+typedef struct {
+    task_range_func_t fn;
+    void *arg;
+    uint32_t grain;                 // 小于等于该长度的区间不再拆分
+    volatile uint32_t pending;      // 尚未完成的下标数
+} task_group_t;
+
+/* 任务：某个 parallel_for 中的一段下标区间 */
+typedef struct {
+    task_group_t *group;
+    uint32_t begin;
+    uint32_t end;
+} task_t;
+
+/* Chase-Lev 工作窃取双端队列：所有者在 bottom 端压入/弹出，其他 CPU 从 top 端窃取 */
+typedef struct {
+    volatile int32_t top;
+    volatile int32_t bottom;
+    task_t buf[TASK_DEQUE_SIZE];
+} __attribute__((aligned(64))) task_deque_t;
+
+/* 为每个 AP 创建工作线程（在 smp_init 之后调用） */
+void task_pool_init(void);
+
+/* 并行执行 fn(arg, b, e)，覆盖 [begin, end)；调用者参与执行并等待全部完成 */
+void parallel_for(uint32_t begin, uint32_t end, uint32_t grain,
+                  task_range_func_t fn, void *arg);
+
+#endif /* KERNEL_TASK_H */
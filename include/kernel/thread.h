@@ -0,0 +1,118 @@
+#ifndef KERNEL_THREAD_H
+#define KERNEL_THREAD_H
+
+#include <stdint.h>
+#include <kernel/spinlock.h>
+
+/* 线程数量上限与每个线程的栈大小 */
+#define THREAD_MAX          32
+#define THREAD_STACK_SIZE   16384
+#define THREAD_NAME_LEN     16
+
+/* FXSAVE 区域大小（FNSAVE 只用前 108 字节） */
+#define THREAD_FPU_STATE_SIZE 512
+
+/* 优先级：数值越小越优先，高优先级就绪时立即抢占低优先级 */
+#define THREAD_PRIO_LEVELS      8
+#define THREAD_PRIO_INTERACTIVE 1       // 输入、光标等交互任务
+#define THREAD_PRIO_NORMAL      4
+#define THREAD_PRIO_BULK        6       // 全屏重绘等批量任务
+#define THREAD_PRIO_IDLE        (THREAD_PRIO_LEVELS - 1)
+
+/* 时间片长度（定时器 tick） */
+#define THREAD_TIMESLICE        2
+
+/* 线程状态 */
+typedef enum {
+    THREAD_UNUSED = 0,      // 空闲槽位
+    THREAD_READY,           // 在就绪队列中
+    THREAD_RUNNING,         // 正在运行
+    THREAD_SLEEPING,        // 等待定时器唤醒
+    THREAD_BLOCKED,         // 等待 thread_wake
+    THREAD_DEAD             // 已退出，等待切换完成后回收
+} thread_state_t;
+
+typedef void (*thread_func_t)(void *arg);
+
+/* 线程控制块 */
+typedef struct thread {
+    uint32_t esp;               // 保存的栈指针（switch_context 依赖其位于偏移 0）
+    uint32_t id;
+    thread_state_t state;
+    int priority;
+    uint32_t cpu;               // 所属 CPU（线程不跨 CPU 迁移）
+    uint32_t slice;             // 剩余时间片
+    uint32_t kstack_top;        // 内核栈顶（写入 TSS.esp0）
+    uint32_t cr3;               // 页目录（0 表示内核页目录）
+    struct process *process;    // 所属用户进程（内核线程为 NULL）
+    uint32_t wake_tick;         // 睡眠到期的 tick
+    uint8_t wake_pending;       // 运行中被唤醒，下一次 thread_block 立即返回
+    uint8_t *stack;             // 栈底（主线程使用启动栈，为 NULL）
+    struct thread *next;        // 就绪队列链接
+    struct thread *wait_next;   // 等待队列链接
+    char name[THREAD_NAME_LEN];
+    uint8_t fpu_used;           // 用过 FPU/SSE，fpu_state 有效
+    uint8_t fpu_state[THREAD_FPU_STATE_SIZE] __attribute__((aligned(16)));  // 惰性保存的 FPU 状态
+} thread_t;
+
+/* 每 CPU 就绪队列：每个优先级一个 FIFO，位图第 p 位表示队列 p 非空 */
+typedef struct runqueue {
+    spinlock_t lock;
+    thread_t *head[THREAD_PRIO_LEVELS];
+    thread_t *tail[THREAD_PRIO_LEVELS];
+    uint32_t bitmap;
+} runqueue_t;
+
+/* 将当前执行流登记为主线程并创建空闲线程（BSP） */
+void thread_init(void);
+
+/* 将 AP 的启动执行流登记为该 CPU 的空闲线程 */
+void thread_init_ap(void);
+
+/* 进入空闲循环（AP 初始化完成后调用） */
+void thread_run_idle(void) __attribute__((noreturn));
+
+/* 在当前 CPU 上创建线程，失败返回 NULL */
+thread_t *thread_create(const char *name, thread_func_t fn, void *arg, int priority);
+
+/* 在指定 CPU 上创建线程 */
+thread_t *thread_create_on(uint32_t cpu, const char *name, thread_func_t fn,
+                           void *arg, int priority);
+
+/* 修改线程优先级 */
+void thread_set_priority(thread_t *t, int priority);
+
+/* 主动让出 CPU */
+void thread_yield(void);
+
+/* 睡眠指定的定时器 tick 数 */
+void thread_sleep(uint32_t ticks);
+
+/* 阻塞直到 thread_wake */
+void thread_block(void);
+
+/* 阻塞直到 thread_wake 或经过 ticks 个定时器 tick */
+void thread_block_timeout(uint32_t ticks);
+
+/* 唤醒线程（可在中断上下文调用） */
+void thread_wake(thread_t *t);
+
+/* 结束当前线程 */
+void thread_exit(void) __attribute__((noreturn));
+
+/* 获取当前线程 */
+thread_t *thread_current(void);
+
+/* 当前上下文能否阻塞等待：开中断的普通线程（中断处理、关中断区间和空闲线程只能轮询） */
+int thread_can_sleep(void);
+
+/* 定时器中断中调用：唤醒到期的睡眠线程并消耗时间片 */
+void thread_tick(uint32_t now);
+
+/* 抢占点：有更高优先级线程就绪或时间片用完时切换（IRQ 返回前调用） */
+void thread_preempt(void);
+
+/* 上下文切换完成后的收尾（回收已退出线程），由调度器和新线程入口调用 */
+void thread_finish_switch(void);
+
+#endif /* KERNEL_THREAD_H */
@@ -0,0 +1,15 @@
+#ifndef KERNEL_TIMER_H
+#define KERNEL_TIMER_H
+
+#include <stdint.h>
+
+/* PIT 定时器频率 */
+#define TIMER_HZ 100
+
+/* 设置 PIT 通道0 并注册 IRQ0 处理程序 */
+void timer_init(uint32_t hz);
+
+/* 启动以来的 tick 数 */
+uint32_t timer_get_ticks(void);
+
+#endif /* KERNEL_TIMER_H */
@@ -0,0 +1,77 @@
+#ifndef KERNEL_TRACE_H
+#define KERNEL_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <kernel/tsc.h>
+#include <kernel/percpu.h>
+
+/* 设为 0 可在编译期去掉所有跟踪点 */
+#ifndef CONFIG_TRACE
+#define CONFIG_TRACE 1
+#endif
+
+/* 跟踪记录数量（必须是2的幂） */
+#define TRACE_BUF_RECORDS 4096
+#define TRACE_BUF_MASK    (TRACE_BUF_RECORDS - 1)
+
+/* 事件ID（tools/trace_decode.py 从此处解析事件名） */
+enum trace_event {
+    TRACE_NONE          = 0,
+    TRACE_IRQ_ENTER     = 1,    // arg0 = IRQ 号
+    TRACE_IRQ_EXIT      = 2,    // arg0 = IRQ 号
+    TRACE_EXCEPTION     = 3,    // arg0 = 异常号, arg1 = 错误码
+    TRACE_RENDER_BEGIN  = 4,    // arg0 = 绘制区域宽, arg1 = 高
+    TRACE_RENDER_END    = 5,
+    TRACE_MOUSE_PACKET  = 6,    // arg0 = dx, arg1 = dy
+    TRACE_MOUSE_CLICK   = 7,    // arg0 = x, arg1 = y
+    TRACE_KEY_PRESS     = 8,    // arg0 = 扫描码
+    TRACE_MARK          = 9,    // 自定义标记
+    TRACE_SYSCALL       = 10,   // arg0 = 系统调用号, arg1 = ebx
+    TRACE_SYSCALL_EXIT  = 11,   // arg0 = 系统调用号, arg1 = 返回值
+    TRACE_LOG           = 12,   // arg0 = 日志级别, arg1 = 该行（含换行）的 CRC32C
+    TRACE_BLOCK_IO      = 13,   // arg0 = 起始 LBA, arg1 = 扇区数（最高位为 1 表示写）
+    TRACE_BLOCK_DONE    = 14,   // arg0 = 起始 LBA, arg1 = 结果（0 成功）
+};
+
+/* 固定大小的二进制记录（24字节） */
+typedef struct {
+    uint64_t tsc;       // 时间戳
+    uint32_t seq;       // 全局序号，最后写入，用于识别被覆盖或未写完的记录
+    uint16_t event;     // 事件ID
+    uint16_t cpu;       // CPU 号
+    uint32_t arg0;
+    uint32_t arg1;
+} __attribute__((packed)) trace_record_t;
+
+extern trace_record_t trace_buf[TRACE_BUF_RECORDS];
+extern volatile uint32_t trace_head;
+extern volatile uint8_t trace_paused;
+
+/* 记录一个事件：一次原子加 + 几次存储，可在中断上下文调用 */
+static inline void trace(uint16_t event, uint32_t arg0, uint32_t arg1) {
+#if CONFIG_TRACE
+    if (trace_paused) {
+        return;
+    }
+    uint32_t idx = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    trace_record_t *rec = &trace_buf[idx & TRACE_BUF_MASK];
+    rec->tsc = rdtsc();
+    rec->event = event;
+    rec->cpu = (uint16_t)this_cpu()->id;
+    rec->arg0 = arg0;
+    rec->arg1 = arg1;
+    asm volatile ("" : : : "memory");
+    rec->seq = idx;
+#else
+    (void)event; (void)arg0; (void)arg1;
+#endif
+}
+
+/* printk 输出端：每行日志记录一个 TRACE_LOG 事件，解码器按 CRC 从同一份串口日志中找回文本 */
+void trace_printk_sink(int level, const char *line, size_t len);
+
+/* 通过串口导出缓冲区内容（十六进制文本，由 tools/trace_decode.py 解码） */
+void trace_dump(void);
+
+#endif /* KERNEL_TRACE_H */
@@ -0,0 +1,25 @@
+#ifndef KERNEL_TSC_H
+#define KERNEL_TSC_H
+
+#include <stdint.h>
+
+/* 读取时间戳计数器 */
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* 使用 PIT 通道2 校准 TSC 频率 */
+void tsc_init(void);
+
+/* TSC 频率（kHz），未校准时返回 0 */
+uint32_t tsc_get_khz(void);
+
+/* 忙等待指定微秒数（需已校准） */
+void tsc_delay_us(uint32_t us);
+
+/* 将 TSC 周期数换算为微秒 */
+uint32_t tsc_cycles_to_us(uint64_t cycles);
+
+#endif /* KERNEL_TSC_H */
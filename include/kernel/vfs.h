@@ -0,0 +1,127 @@
+#ifndef KERNEL_VFS_H
+#define KERNEL_VFS_H
+
+#include <stdint.h>
+
+/* 路径分量的最大长度 */
+#define VFS_NAME_MAX        63
+
+/* inode、dentry、打开文件的数量；dentry 哈希桶数（必须是2的幂） */
+#define VFS_INODES          256
+#define VFS_DENTRIES        256
+#define VFS_DCACHE_HASH     256
+#define VFS_FILES           32
+
+/* 页缓存：页数（共 512KB）与基数树参数 */
+#define VFS_PAGE_SIZE       4096
+#define VFS_PAGE_SHIFT      12
+#define VFS_PAGES           128
+#define VFS_RADIX_SHIFT     4
+#define VFS_RADIX_SLOTS     (1 << VFS_RADIX_SHIFT)
+/* 32 位文件偏移最多 2^20 页，每层 4 位，树高不超过 5 */
+#define VFS_RADIX_MAX_HEIGHT ((32 - VFS_PAGE_SHIFT + VFS_RADIX_SHIFT - 1) / VFS_RADIX_SHIFT)
+/* 树中每个节点都在通往某个已缓存页的路径上，节点数不会超过页数乘树高 */
+#define VFS_RADIX_NODES     (VFS_PAGES * VFS_RADIX_MAX_HEIGHT)
+
+typedef enum {
+    VFS_FILE = 1,
+    VFS_DIR = 2,
+} vfs_type_t;
+
+struct vfs_inode;
+
+/* 文件系统提供的操作（可以睡眠，调用时不持有 VFS 的锁） */
+typedef struct {
+    /* 在目录 dir 中查找 name（len 字节，不以 NUL 结尾）：
+     * 找到时填写 child 的 type/size/mode/mtime/priv 并返回 0，不存在返回 -1 */
+    int (*lookup)(struct vfs_inode *dir, const char *name, uint32_t len,
+                  struct vfs_inode *child);
+    /* 读取文件第 index 页到 buf（VFS_PAGE_SIZE 字节，文件末尾之后填 0），成功返回 0 */
+    int (*readpage)(struct vfs_inode *inode, uint32_t index, void *buf);
+    /* 可选：内容常驻内存的文件系统返回 offset 处的数据并在 avail 中给出连续可读的字节数，
+     * 失败返回 NULL。提供时 vfs_read 直接从这里复制，不经过页缓存（readpage 可以为 NULL） */
+    const void *(*map)(struct vfs_inode *inode, uint32_t offset, uint32_t *avail);
+} vfs_inode_ops_t;
+
+struct vfs_radix_node;
+
+/* 页号到缓存页的基数树：height 层，每层 VFS_RADIX_SHIFT 位 */
+typedef struct {
+    struct vfs_radix_node *root;
+    uint32_t height;
+} vfs_radix_tree_t;
+
+typedef struct vfs_inode {
+    const vfs_inode_ops_t *ops;
+    void *priv;                 // 文件系统私有数据
+    uint32_t size;
+    uint32_t mode;
+    uint32_t mtime;
+    uint8_t type;
+    uint32_t refcount;          // 引用它的 dentry 数
+    uint32_t nr_pages;          // 已缓存的页数
+    vfs_radix_tree_t pages;
+    struct vfs_inode *free_next;
+} vfs_inode_t;
+
+typedef struct vfs_dentry {
+    char name[VFS_NAME_MAX + 1];
+    uint8_t len;
+    uint8_t flags;
+    uint32_t hash;              // name 的 FNV-1a
+    struct vfs_dentry *parent;
+    vfs_inode_t *inode;         // NULL 表示负项（名字不存在）
+    uint32_t refcount;          // 子 dentry、打开的文件与调用者；为 0 时在 LRU 上
+    struct vfs_dentry *hash_next;
+    struct vfs_dentry *lru_prev;    // LRU 链表：头部最近使用，尾部最先淘汰
+    struct vfs_dentry *lru_next;
+} vfs_dentry_t;
+
+typedef struct {
+    vfs_dentry_t *dentry;
+    uint32_t pos;
+} vfs_file_t;
+
+typedef struct {
+    uint32_t d_hits;
+    uint32_t d_misses;
+    uint32_t d_negative;        // 命中的负项
+    uint32_t d_evictions;
+    uint32_t p_hits;
+    uint32_t p_misses;
+    uint32_t p_evictions;
+} vfs_stats_t;
+
+/* 初始化 dentry/inode/页缓存 */
+void vfs_init(void);
+
+/* 以 ops 与根目录私有数据挂载根文件系统，成功返回 0 */
+int vfs_mount_root(const vfs_inode_ops_t *ops, void *root_priv);
+
+/* 把文件系统挂载到 path：path 可以是已有目录，也可以是不存在的名字（父目录须存在），
+ * 原目录下的内容被遮住。成功返回 0 */
+int vfs_mount(const char *path, const vfs_inode_ops_t *ops, void *root_priv);
+
+/* 解析路径并持有得到的 dentry（'.'、'..'、重复 '/' 均可），不存在返回 NULL */
+vfs_dentry_t *vfs_lookup(const char *path);
+
+/* 释放 vfs_lookup 得到的 dentry */
+void vfs_dput(vfs_dentry_t *dentry);
+
+/* 打开普通文件，失败返回 NULL */
+vfs_file_t *vfs_open(const char *path);
+void vfs_close(vfs_file_t *file);
+
+/* 从当前位置读取（经过页缓存，提供 map 的文件系统直接复制），返回读到的字节数，出错返回 -1 */
+int vfs_read(vfs_file_t *file, void *buf, uint32_t len);
+
+/* 设置读取位置，成功返回 0 */
+int vfs_seek(vfs_file_t *file, uint32_t pos);
+
+/* 读取统计计数 */
+void vfs_get_stats(vfs_stats_t *stats);
+
+/* 通过 printk 输出 dentry 缓存与页缓存命中率 */
+void vfs_report(void);
+
+#endif /* KERNEL_VFS_H */
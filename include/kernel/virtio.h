@@ -0,0 +1,122 @@
+#ifndef KERNEL_VIRTIO_H
+#define KERNEL_VIRTIO_H
+
+#include <stdint.h>
+
+/* virtio PCI 厂商 ID；过渡设备 ID = 0x1000 + 子系统 ID（网卡 1，块设备 2） */
+#define VIRTIO_PCI_VENDOR       0x1AF4
+#define VIRTIO_PCI_DEVICE_BLK   0x1001
+
+/* 传统（legacy）接口：BAR0 的 I/O 寄存器 */
+#define VIRTIO_PCI_HOST_FEATURES    0x00
+#define VIRTIO_PCI_GUEST_FEATURES   0x04
+#define VIRTIO_PCI_QUEUE_PFN        0x08
+#define VIRTIO_PCI_QUEUE_SIZE       0x0C
+#define VIRTIO_PCI_QUEUE_SEL        0x0E
+#define VIRTIO_PCI_QUEUE_NOTIFY     0x10
+#define VIRTIO_PCI_STATUS           0x12
+#define VIRTIO_PCI_ISR              0x13    // 读取即清除
+#define VIRTIO_PCI_CONFIG           0x14    // 设备专属配置（未启用 MSI-X）
+
+/* 设备状态位 */
+#define VIRTIO_STATUS_ACKNOWLEDGE   0x01
+#define VIRTIO_STATUS_DRIVER        0x02
+#define VIRTIO_STATUS_DRIVER_OK     0x04
+#define VIRTIO_STATUS_FAILED        0x80
+
+/* ISR 位 */
+#define VIRTIO_ISR_QUEUE            0x01
+#define VIRTIO_ISR_CONFIG           0x02
+
+/* 通用特性位 */
+#define VIRTIO_RING_F_EVENT_IDX     (1u << 29)
+
+/* 描述符标志 */
+#define VRING_DESC_F_NEXT           1
+#define VRING_DESC_F_WRITE          2   // 设备写、驱动读
+
+#define VRING_AVAIL_F_NO_INTERRUPT  1
+#define VRING_USED_F_NO_NOTIFY      1
+
+/* 传统接口的队列大小由设备决定，这里按最大 256 项预留内存 */
+#define VIRTQ_MAX_SIZE  256
+
+struct vring_desc {
+    uint64_t addr;              // 物理地址
+    uint32_t len;
+    uint16_t flags;
+    uint16_t next;
+} __attribute__((packed));
+
+/* ring[size] 之后紧跟 used_event（EVENT_IDX） */
+struct vring_avail {
+    uint16_t flags;
+    uint16_t idx;
+    uint16_t ring[];
+} __attribute__((packed));
+
+struct vring_used_elem {
+    uint32_t id;                // 描述符链头
+    uint32_t len;               // 设备写入的字节数
+} __attribute__((packed));
+
+/* ring[size] 之后紧跟 avail_event（EVENT_IDX） */
+struct vring_used {
+    uint16_t flags;
+    uint16_t idx;
+    struct vring_used_elem ring[];
+} __attribute__((packed));
+
+/* 传统布局：描述符表 + 可用环，按页对齐后是已用环 */
+#define VRING_ALIGN(x)  (((x) + 4095) & ~4095u)
+#define VRING_SIZE(n)   (VRING_ALIGN(16 * (n) + 6 + 2 * (n)) + VRING_ALIGN(6 + 8 * (n)))
+
+/* 一段缓冲区 */
+typedef struct {
+    uint32_t addr;              // 物理地址
+    uint32_t len;
+} virtq_sg_t;
+
+/* 虚拟队列：除 virtqueue_notify 外都要求调用者持有保护该队列的锁 */
+typedef struct {
+    uint16_t iobase;
+    uint16_t index;             // 队列号
+    uint16_t size;              // 项数（2 的幂）
+    uint16_t num_free;          // 空闲描述符数
+    uint16_t free_head;         // 空闲描述符链表（经 next 链接）
+    uint16_t avail_idx;         // 下一个写入的可用环位置
+    uint16_t kicked_idx;        // 上次通知设备时的 avail_idx
+    uint16_t last_used;         // 已处理到的已用环位置
+    uint8_t event_idx;          // 已协商 VIRTIO_RING_F_EVENT_IDX
+    volatile struct vring_desc *desc;
+    volatile struct vring_avail *avail;
+    volatile struct vring_used *used;
+} virtqueue_t;
+
+/* 复位设备并协商特性，返回双方都支持的特性位 */
+uint32_t virtio_pci_negotiate(uint16_t iobase, uint32_t wanted);
+
+/* 设置状态寄存器（在已有状态上追加） */
+void virtio_pci_add_status(uint16_t iobase, uint8_t status);
+
+/* 在 mem（页对齐、物理连续）上建立第 index 个队列并告知设备，成功返回 0 */
+int virtio_pci_setup_queue(virtqueue_t *vq, uint16_t iobase, uint16_t index,
+                           void *mem, uint32_t mem_size, int event_idx);
+
+/* 把 out 个只读段和 in 个可写段作为一条链加入可用环（不通知设备），
+ * 描述符不足时返回 -1，否则返回链头 */
+int virtqueue_add(virtqueue_t *vq, const virtq_sg_t *sg, uint32_t out, uint32_t in);
+
+/* 判断自上次通知以来加入的请求是否需要通知设备（EVENT_IDX 下设备忙时不需要） */
+int virtqueue_kick_prepare(virtqueue_t *vq);
+
+/* 通知设备（写 QUEUE_NOTIFY 会导致一次 VM exit，最好在锁外调用） */
+void virtqueue_notify(virtqueue_t *vq);
+
+/* 取出一个已完成的链并回收其描述符，没有时返回 -1 */
+int virtqueue_get_used(virtqueue_t *vq, uint32_t *len);
+
+/* 处理完已用环后重新打开完成中断；返回 1 表示期间又有新的完成，需要继续处理 */
+int virtqueue_enable_cb(virtqueue_t *vq);
+
+#endif /* KERNEL_VIRTIO_H */
@@ -0,0 +1,15 @@
+#ifndef KERNEL_VIRTIO_BLK_H
+#define KERNEL_VIRTIO_BLK_H
+
+#include <stdint.h>
+
+/* 同时在途的最大请求数 */
+#define VIRTIO_BLK_MAX_REQS 32
+
+/* 单个请求最多传输的扇区数（64KB），更大的读写拆成多个请求一次性提交 */
+#define VIRTIO_BLK_REQ_SECTORS 128
+
+/* 查找 virtio 块设备并注册为 vda */
+void virtio_blk_init(void);
+
+#endif /* KERNEL_VIRTIO_BLK_H */
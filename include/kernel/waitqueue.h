@@ -0,0 +1,57 @@
+#ifndef KERNEL_WAITQUEUE_H
+#define KERNEL_WAITQUEUE_H
+
+#include <stdint.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/timer.h>
+
+/* 等待队列：线程在条件不满足时挂起，生产者（可在中断中）唤醒 */
+typedef struct {
+    spinlock_t lock;
+    thread_t *head;             // 通过 thread_t.wait_next 链接
+} waitqueue_t;
+
+#define WAITQUEUE_INIT { SPINLOCK_INIT, NULL }
+
+void wait_queue_init(waitqueue_t *wq, const char *name);
+
+/* 将当前线程挂入队列（之后检查条件，再 thread_block） */
+void wait_queue_prepare(waitqueue_t *wq);
+
+/* 将当前线程从队列中摘除（被唤醒或条件已满足时） */
+void wait_queue_finish(waitqueue_t *wq);
+
+/* 唤醒队列中所有线程 */
+void wait_queue_wake_all(waitqueue_t *wq);
+
+/* 阻塞直到 condition 成立。
+ * 先入队再检查条件：检查后到来的唤醒会留下 wake_pending，thread_block 立即返回，不会丢失。 */
+#define wait_event(wq, condition)               \
+    do {                                        \
+        while (!(condition)) {                  \
+            wait_queue_prepare(wq);             \
+            if (!(condition)) {                 \
+                thread_block();                 \
+            }                                   \
+            wait_queue_finish(wq);              \
+        }                                       \
+    } while (0)
+
+/* 同 wait_event，但最多等待 ticks 个定时器 tick；返回 condition 最终是否成立 */
+#define wait_event_timeout(wq, condition, ticks)                            \
+    ({                                                                      \
+        uint32_t __deadline = timer_get_ticks() + (ticks);                  \
+        int32_t __left;                                                     \
+        while (!(condition) &&                                              \
+               (__left = (int32_t)(__deadline - timer_get_ticks())) > 0) {  \
+            wait_queue_prepare(wq);                                         \
+            if (!(condition)) {                                             \
+                thread_block_timeout((uint32_t)__left);                     \
+            }                                                               \
+            wait_queue_finish(wq);                                          \
+        }                                                                   \
+        (condition);                                                        \
+    })
+
+#endif /* KERNEL_WAITQUEUE_H */
@@ -9,11 +9,14 @@ global isr16, isr17, isr18, isr19, isr20, isr21, isr22, isr23
 global isr24, isr25, isr26, isr27, isr28, isr29, isr30, isr31
 global irq0, irq1, irq2, irq3, irq4, irq5, irq6, irq7
 global irq8, irq9, irq10, irq11, irq12, irq13, irq14, irq15
+global isr239, isr240, isr255
+global syscall_entry
 global isr_common_stub, irq_common_stub
 
 ; 外部C函数声明
 extern isr_handler
 extern irq_handler
+extern syscall_dispatch
 
 ; 宏：定义无错误代码的异常处理程序
 %macro ISR_NOERRCODE 1
@@ -41,6 +44,15 @@ irq%1:
     jmp irq_common_stub
 %endmacro
 
+; 宏：定义本地 APIC 中断向量（>=128，push byte 会符号扩展）
+%macro ISR_VECTOR 1
+isr%1:
+    cli
+    push dword 0
+    push dword %1
+    jmp isr_common_stub
+%endmacro
+
 ; 定义异常处理程序
 ISR_NOERRCODE 0   ; 除法错误
 ISR_NOERRCODE 1   ; 调试异常
@@ -94,6 +106,11 @@ IRQ 13, 45   ; 协处理器
 IRQ 14, 46   ; 主IDE
 IRQ 15, 47   ; 从IDE
 
+; 本地 APIC 向量（由 lapic_eoi 应答，不经过 PIC）
+ISR_VECTOR 239  ; APIC 定时器
+ISR_VECTOR 240  ; 重新调度 IPI
+ISR_VECTOR 255  ; 伪中断
+
 ; 通用ISR存根
 isr_common_stub:
     ; 保存所有通用寄存器
@@ -105,12 +122,14 @@ isr_common_stub:
     push fs
     push gs
     
-    ; 加载内核数据段选择子
+    ; 加载内核数据段选择子，GS 指向本 CPU 的数据块
     mov ax, 0x10
     mov ds, ax
     mov es, ax
     mov fs, ax
+    mov ax, 0x30
     mov gs, ax
+    cld                     ; C 代码假定 DF=0（用户态或被打断的 memmove 可能置位）
     
     ; 调用C ISR处理函数（传递栈指针作为参数）
     push esp
@@ -143,12 +162,14 @@ irq_common_stub:
     push fs
     push gs
     
-    ; 加载内核数据段选择子
+    ; 加载内核数据段选择子，GS 指向本 CPU 的数据块
     mov ax, 0x10
     mov ds, ax
     mov es, ax
     mov fs, ax
+    mov ax, 0x30
     mov gs, ax
+    cld                     ; C 代码假定 DF=0（用户态或被打断的 memmove 可能置位）
     
     ; 调用C IRQ处理函数（传递栈指针作为参数）
     push esp
@@ -170,6 +191,38 @@ irq_common_stub:
     ; 中断返回
     iret
 
+; 系统调用入口（int 0x80，陷阱门，保持用户态的 IF）
+; 寄存器帧与 struct registers 相同，C 处理函数直接在帧上读取参数、写回返回值
+syscall_entry:
+    push dword 0
+    push dword 0x80
+    pusha
+    
+    push ds
+    push es
+    push fs
+    push gs
+    
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov ax, 0x30
+    mov gs, ax
+    cld                     ; C 代码假定 DF=0（用户态或被打断的 memmove 可能置位）
+    
+    push esp
+    call syscall_dispatch
+    add esp, 4
+    
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    add esp, 8
+    iret
+
 ; IDT加载函数
 idt_flush:
     mov eax, [esp + 4]  ; 获取参数（idt_ptr地址）
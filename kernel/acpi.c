@@ -0,0 +1,129 @@
+#include <kernel/acpi.h>
+#include <kernel/string.h>
+
+/* MADT 表头之后的字段 */
+typedef struct {
+    acpi_sdt_header_t header;
+    uint32_t lapic_address;
+    uint32_t flags;
+} __attribute__((packed)) acpi_madt_t;
+
+/* MADT 条目类型 */
+#define MADT_LOCAL_APIC          0
+#define MADT_IO_APIC             1
+#define MADT_LAPIC_ADDR_OVERRIDE 5
+
+static const acpi_sdt_header_t *rsdt = NULL;
+static int use_xsdt = 0;
+
+/* 字节校验和为 0 表示有效 */
+static int acpi_checksum(const void *data, uint32_t length) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        sum += p[i];
+    }
+    return sum == 0;
+}
+
+/* 在 [start, end) 中按 16 字节对齐搜索 RSDP */
+static const acpi_rsdp_t *acpi_scan_rsdp(uint32_t start, uint32_t end) {
+    for (uint32_t addr = start; addr < end; addr += 16) {
+        const acpi_rsdp_t *rsdp = (const acpi_rsdp_t *)addr;
+        if (memcmp(rsdp->signature, "RSD PTR ", 8) == 0 && acpi_checksum(rsdp, 20)) {
+            return rsdp;
+        }
+    }
+    return NULL;
+}
+
+int acpi_init(const acpi_rsdp_t *rsdp) {
+    if (!rsdp) {
+        // EBDA 的前 1KB，然后是 BIOS 只读区
+        uint32_t ebda = (uint32_t)(*(volatile uint16_t *)0x40E) << 4;
+        if (ebda) {
+            rsdp = acpi_scan_rsdp(ebda, ebda + 1024);
+        }
+        if (!rsdp) {
+            rsdp = acpi_scan_rsdp(0xE0000, 0x100000);
+        }
+    }
+    if (!rsdp || !acpi_checksum(rsdp, 20)) {
+        return 0;
+    }
+
+    // 优先使用 XSDT（仅支持 4GB 以下的表）
+    if (rsdp->revision >= 2 && rsdp->xsdt_address && (rsdp->xsdt_address >> 32) == 0) {
+        rsdt = (const acpi_sdt_header_t *)(uint32_t)rsdp->xsdt_address;
+        use_xsdt = 1;
+    } else {
+        rsdt = (const acpi_sdt_header_t *)rsdp->rsdt_address;
+        use_xsdt = 0;
+    }
+
+    if (!acpi_checksum(rsdt, rsdt->length)) {
+        rsdt = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+const acpi_sdt_header_t *acpi_find_table(const char *signature) {
+    if (!rsdt) {
+        return NULL;
+    }
+
+    uint32_t entry_size = use_xsdt ? 8 : 4;
+    uint32_t count = (rsdt->length - sizeof(acpi_sdt_header_t)) / entry_size;
+    const uint8_t *entries = (const uint8_t *)rsdt + sizeof(acpi_sdt_header_t);
+
+    for (uint32_t i = 0; i < count; i++) {
+        // XSDT 条目为 64 位，高 32 位非零的表无法访问
+        const uint32_t *entry = (const uint32_t *)(entries + i * entry_size);
+        if (use_xsdt && entry[1] != 0) {
+            continue;
+        }
+        const acpi_sdt_header_t *table = (const acpi_sdt_header_t *)entry[0];
+        if (memcmp(table->signature, signature, 4) == 0 &&
+            acpi_checksum(table, table->length)) {
+            return table;
+        }
+    }
+    return NULL;
+}
+
+int acpi_parse_madt(acpi_madt_info_t *info) {
+    const acpi_madt_t *madt = (const acpi_madt_t *)acpi_find_table("APIC");
+    if (!madt) {
+        return 0;
+    }
+
+    memset(info, 0, sizeof(*info));
+    info->lapic_address = madt->lapic_address;
+
+    const uint8_t *p = (const uint8_t *)madt + sizeof(acpi_madt_t);
+    const uint8_t *end = (const uint8_t *)madt + madt->header.length;
+
+    while (p + 2 <= end && p[1] >= 2) {
+        uint8_t type = p[0];
+        uint8_t length = p[1];
+
+        if (type == MADT_LOCAL_APIC && length >= 8) {
+            // p[2] = ACPI 处理器 ID, p[3] = APIC ID, p[4..7] = 标志（位0 = 已启用）
+            uint32_t flags = *(const uint32_t *)(p + 4);
+            if ((flags & 1) && info->cpu_count < ACPI_MAX_CPUS) {
+                info->apic_ids[info->cpu_count++] = p[3];
+            }
+        } else if (type == MADT_IO_APIC && length >= 12 && info->ioapic_address == 0) {
+            info->ioapic_address = *(const uint32_t *)(p + 4);
+            info->ioapic_gsi_base = *(const uint32_t *)(p + 8);
+        } else if (type == MADT_LAPIC_ADDR_OVERRIDE && length >= 12) {
+            uint64_t addr = *(const uint64_t *)(p + 4);
+            if ((addr >> 32) == 0) {
+                info->lapic_address = (uint32_t)addr;
+            }
+        }
+        p += length;
+    }
+    return 1;
+}
@@ -0,0 +1,119 @@
+#include <kernel/apic.h>
+#include <kernel/tsc.h>
+#include <kernel/io.h>
+
+/* 本地 APIC 寄存器偏移 */
+#define LAPIC_ID          0x020
+#define LAPIC_EOI         0x0B0
+#define LAPIC_SVR         0x0F0
+#define LAPIC_ESR         0x280
+#define LAPIC_ICR_LOW     0x300
+#define LAPIC_ICR_HIGH    0x310
+#define LAPIC_LVT_TIMER   0x320
+#define LAPIC_TIMER_INIT  0x380
+#define LAPIC_TIMER_CUR   0x390
+#define LAPIC_TIMER_DIV   0x3E0
+
+#define LAPIC_SVR_ENABLE      0x100
+#define LAPIC_ICR_PENDING     (1 << 12)
+#define LAPIC_ICR_INIT        0x00000500
+#define LAPIC_ICR_STARTUP     0x00000600
+#define LAPIC_ICR_ASSERT      0x00004000
+#define LAPIC_ICR_LEVEL       0x00008000
+#define LAPIC_TIMER_PERIODIC  0x00020000
+#define LAPIC_LVT_MASKED      0x00010000
+
+static volatile uint32_t *lapic = 0;
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return lapic[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    lapic[reg / 4] = value;
+    (void)lapic[LAPIC_ID / 4];  // 读回以确保写入完成
+}
+
+void lapic_set_base(uint32_t base) {
+    lapic = (volatile uint32_t *)base;
+}
+
+int lapic_available(void) {
+    return lapic != 0;
+}
+
+void lapic_init(void) {
+    if (!lapic) {
+        return;
+    }
+    // 软件启用 APIC，设置伪中断向量
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | LAPIC_SPURIOUS_VECTOR);
+    lapic_write(LAPIC_ESR, 0);
+    lapic_write(LAPIC_EOI, 0);
+}
+
+uint32_t lapic_id(void) {
+    if (!lapic) {
+        return 0;
+    }
+    return lapic_read(LAPIC_ID) >> 24;
+}
+
+void lapic_eoi(void) {
+    lapic_write(LAPIC_EOI, 0);
+}
+
+/* 等待上一个 IPI 发送完成 */
+static void lapic_wait_icr(void) {
+    while (lapic_read(LAPIC_ICR_LOW) & LAPIC_ICR_PENDING) {
+        asm volatile ("pause");
+    }
+}
+
+static void lapic_send_icr(uint32_t apic_id, uint32_t low) {
+    uint32_t flags = irq_save();
+
+    lapic_wait_icr();
+    lapic_write(LAPIC_ICR_HIGH, apic_id << 24);
+    lapic_write(LAPIC_ICR_LOW, low);
+    lapic_wait_icr();
+
+    irq_restore(flags);
+}
+
+void lapic_send_ipi(uint32_t apic_id, uint8_t vector) {
+    if (!lapic) {
+        return;
+    }
+    lapic_send_icr(apic_id, vector);
+}
+
+void lapic_send_init(uint32_t apic_id) {
+    lapic_write(LAPIC_ESR, 0);
+    // 电平触发 INIT 置位，再撤销
+    lapic_send_icr(apic_id, LAPIC_ICR_INIT | LAPIC_ICR_LEVEL | LAPIC_ICR_ASSERT);
+    tsc_delay_us(200);
+    lapic_send_icr(apic_id, LAPIC_ICR_INIT | LAPIC_ICR_LEVEL);
+}
+
+void lapic_send_sipi(uint32_t apic_id, uint8_t page) {
+    lapic_write(LAPIC_ESR, 0);
+    lapic_send_icr(apic_id, LAPIC_ICR_STARTUP | page);
+}
+
+void lapic_timer_init(uint32_t hz) {
+    if (!lapic) {
+        return;
+    }
+
+    // 16 分频，用 TSC 测量 10ms 内的计数
+    lapic_write(LAPIC_TIMER_DIV, 0x3);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_TIMER_INIT, 0xFFFFFFFF);
+    tsc_delay_us(10000);
+    uint32_t ticks_10ms = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CUR);
+
+    lapic_write(LAPIC_TIMER_INIT, 0);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | LAPIC_TIMER_VECTOR);
+    lapic_write(LAPIC_TIMER_INIT, ticks_10ms * 100 / hz);
+}
@@ -0,0 +1,594 @@
+#include <kernel/ata.h>
+#include <kernel/blkdev.h>
+#include <kernel/pci.h>
+#include <kernel/io.h>
+#include <kernel/idt.h>
+#include <kernel/paging.h>
+#include <kernel/thread.h>
+#include <kernel/printk.h>
+#include <kernel/spinlock.h>
+#include <kernel/string.h>
+#include <kernel/tsc.h>
+#include <kernel/waitqueue.h>
+#include <stddef.h>
+
+/* 命令块寄存器偏移 */
+#define ATA_REG_DATA        0
+#define ATA_REG_ERROR       1
+#define ATA_REG_SECCOUNT    2
+#define ATA_REG_LBA_LO      3
+#define ATA_REG_LBA_MID     4
+#define ATA_REG_LBA_HI      5
+#define ATA_REG_DRIVE       6
+#define ATA_REG_STATUS      7   // 读
+#define ATA_REG_COMMAND     7   // 写
+
+/* 状态寄存器位 */
+#define ATA_SR_ERR  0x01
+#define ATA_SR_DRQ  0x08
+#define ATA_SR_DF   0x20
+#define ATA_SR_BSY  0x80
+
+/* 设备控制寄存器（与备用状态寄存器同一端口） */
+#define ATA_CTRL_NIEN 0x02      // 屏蔽设备中断
+#define ATA_CTRL_SRST 0x04      // 软件复位
+
+/* 命令 */
+#define ATA_CMD_READ_PIO    0x20
+#define ATA_CMD_WRITE_PIO   0x30
+#define ATA_CMD_READ_DMA    0xC8
+#define ATA_CMD_WRITE_DMA   0xCA
+#define ATA_CMD_FLUSH       0xE7
+#define ATA_CMD_IDENTIFY    0xEC
+
+/* 总线主控寄存器（相对每个通道的 BMIDE 基址） */
+#define BM_REG_COMMAND  0
+#define BM_REG_STATUS   2
+#define BM_REG_PRDT     4
+
+#define BM_CMD_START    0x01
+#define BM_CMD_READ     0x08    // 设备 -> 内存
+#define BM_SR_ACTIVE    0x01
+#define BM_SR_ERR       0x02
+#define BM_SR_IRQ       0x04    // 写 1 清除
+
+/* 兼容模式下的固定资源 */
+#define ATA_PRIMARY_IO      0x1F0
+#define ATA_PRIMARY_CTRL    0x3F6
+#define ATA_PRIMARY_IRQ     14
+#define ATA_SECONDARY_IO    0x170
+#define ATA_SECONDARY_CTRL  0x376
+#define ATA_SECONDARY_IRQ   15
+
+/* 超时（毫秒） */
+#define ATA_TIMEOUT_MS  5000
+
+/* PRD 表项：描述一段物理连续、不跨 64KB 边界的缓冲区 */
+typedef struct {
+    uint32_t addr;
+    uint16_t bytes;             // 0 表示 64KB
+    uint16_t flags;             // 最高位为 1 表示最后一项
+} __attribute__((packed)) ata_prd_t;
+
+#define ATA_PRD_EOT 0x8000
+
+typedef struct {
+    uint16_t io;                // 命令块基址
+    uint16_t ctrl;              // 备用状态 / 设备控制寄存器
+    uint16_t bmide;             // 总线主控寄存器基址，0 表示不支持 DMA
+    uint8_t irq;                // 0xFF 表示没有可用的 IRQ，DMA 完成靠轮询
+    uint8_t selected;           // 最近一次选择的驱动器（0xFF 表示未知）
+    spinlock_t lock;            // 保护下面的状态
+    uint8_t busy;               // 通道被某次传输占用
+    volatile uint8_t dma_active;
+    volatile uint8_t dma_done;
+    volatile uint8_t dma_status;    // 完成时的 BMISTA
+    volatile uint8_t ata_status;    // 完成时的设备状态
+    waitqueue_t wq;             // 等待通道空闲与 DMA 完成
+    ata_prd_t *prd;
+} ata_channel_t;
+
+typedef struct {
+    ata_channel_t *chan;
+    uint8_t slave;
+    uint8_t dma;
+    char model[41];
+    blkdev_t blk;
+} ata_drive_t;
+
+/* PRD 表必须 4 字节对齐且不能跨 64KB；按 512 对齐即可保证 */
+static ata_prd_t ata_prd_tables[2][ATA_PRD_ENTRIES] __attribute__((aligned(512)));
+static ata_channel_t ata_channels[2];
+static ata_drive_t ata_drives[4];
+
+/* ========== 底层寄存器访问 ========== */
+
+/* 读 4 次备用状态寄存器约等于 400ns，给设备更新状态的时间 */
+static void ata_delay400(ata_channel_t *chan) {
+    for (int i = 0; i < 4; i++) {
+        inb(chan->ctrl);
+    }
+}
+
+/* 把超时换算成 TSC 截止值（频率未知时按 1GHz 估计） */
+static uint64_t ata_deadline(uint32_t ms) {
+    uint32_t khz = tsc_get_khz();
+    return rdtsc() + (uint64_t)(khz ? khz : 1000000) * ms;
+}
+
+/* 等待 BSY 清零，返回最终状态；超时返回 -1 */
+static int ata_wait_not_busy(ata_channel_t *chan, uint32_t ms) {
+    uint64_t deadline = ata_deadline(ms);
+    uint8_t status;
+
+    while ((status = inb(chan->ctrl)) & ATA_SR_BSY) {
+        if (rdtsc() > deadline) {
+            return -1;
+        }
+        asm volatile ("pause");
+    }
+    return status;
+}
+
+/* 等待 DRQ（PIO 数据就绪），出错或超时返回 -1 */
+static int ata_wait_drq(ata_channel_t *chan) {
+    int status = ata_wait_not_busy(chan, ATA_TIMEOUT_MS);
+    if (status < 0 || (status & (ATA_SR_ERR | ATA_SR_DF)) || !(status & ATA_SR_DRQ)) {
+        return -1;
+    }
+    return 0;
+}
+
+static void ata_select(ata_channel_t *chan, uint8_t slave, uint32_t lba) {
+    uint8_t value = 0xE0 | (slave << 4) | ((lba >> 24) & 0x0F);
+    outb(chan->io + ATA_REG_DRIVE, value);
+    // 切换驱动器后要等待其状态稳定
+    if (chan->selected != slave) {
+        ata_delay400(chan);
+        chan->selected = slave;
+    }
+}
+
+/* 选择驱动器并写入 LBA28 地址与扇区数，然后发出命令 */
+static int ata_issue(ata_channel_t *chan, uint8_t slave, uint32_t lba,
+                     uint32_t count, uint8_t cmd) {
+    ata_select(chan, slave, lba);
+    if (ata_wait_not_busy(chan, ATA_TIMEOUT_MS) < 0) {
+        return -1;
+    }
+
+    outb(chan->io + ATA_REG_SECCOUNT, (uint8_t)count);     // 256 写作 0
+    outb(chan->io + ATA_REG_LBA_LO, lba & 0xFF);
+    outb(chan->io + ATA_REG_LBA_MID, (lba >> 8) & 0xFF);
+    outb(chan->io + ATA_REG_LBA_HI, (lba >> 16) & 0xFF);
+    outb(chan->io + ATA_REG_COMMAND, cmd);
+    return 0;
+}
+
+/* ========== 通道占用 ========== */
+
+static int ata_try_claim(ata_channel_t *chan) {
+    uint32_t flags = spin_lock_irqsave(&chan->lock);
+    int ok = !chan->busy;
+    if (ok) {
+        chan->busy = 1;
+    }
+    spin_unlock_irqrestore(&chan->lock, flags);
+    return ok;
+}
+
+static void ata_claim(ata_channel_t *chan) {
+    while (!ata_try_claim(chan)) {
+        if (thread_can_sleep()) {
+            wait_event(&chan->wq, !chan->busy);
+        } else {
+            asm volatile ("pause");
+        }
+    }
+}
+
+static void ata_release(ata_channel_t *chan) {
+    uint32_t flags = spin_lock_irqsave(&chan->lock);
+    chan->busy = 0;
+    spin_unlock_irqrestore(&chan->lock, flags);
+    wait_queue_wake_all(&chan->wq);
+}
+
+/* ========== 中断 ========== */
+
+/* 每个通道单独注册在（可能与其他 PCI 设备共享的）IRQ 线上，返回该通道是否发出了中断 */
+static int ata_irq_handler(struct registers *regs, void *dev) {
+    ata_channel_t *chan = dev;
+    int claimed = 0;
+    int done = 0;
+
+    (void)regs;
+    spin_lock(&chan->lock);
+    if (chan->bmide) {
+        // 总线主控状态的 IRQ 位反映设备的 INTRQ，可以判断中断是否来自本通道
+        uint8_t bm = inb(chan->bmide + BM_REG_STATUS);
+        if (bm & BM_SR_IRQ) {
+            claimed = 1;
+            if (chan->dma_active) {
+                // 停止引擎，读状态寄存器应答设备，再清除控制器的中断位
+                outb(chan->bmide + BM_REG_COMMAND, 0);
+                chan->ata_status = inb(chan->io + ATA_REG_STATUS);
+                outb(chan->bmide + BM_REG_STATUS, BM_SR_IRQ | BM_SR_ERR);
+                chan->dma_status = bm;
+                chan->dma_active = 0;
+                chan->dma_done = 1;
+                done = 1;
+            } else {
+                // PIO 或识别期间的中断：读状态寄存器让设备撤销 INTRQ
+                inb(chan->io + ATA_REG_STATUS);
+                outb(chan->bmide + BM_REG_STATUS, BM_SR_IRQ);
+            }
+        }
+    } else {
+        // 没有总线主控时无法分辨来源，只能是独占的兼容模式 IRQ
+        inb(chan->io + ATA_REG_STATUS);
+        claimed = 1;
+    }
+    spin_unlock(&chan->lock);
+
+    if (done) {
+        wait_queue_wake_all(&chan->wq);
+    }
+    return claimed;
+}
+
+/* 没有中断可用时轮询控制器的中断位，语义与中断处理程序相同；ms 为 0 时只检查一次 */
+static int ata_dma_poll(ata_channel_t *chan, uint32_t ms) {
+    uint64_t deadline = ata_deadline(ms);
+
+    while (!chan->dma_done) {
+        uint32_t flags = spin_lock_irqsave(&chan->lock);
+        uint8_t bm = inb(chan->bmide + BM_REG_STATUS);
+        if (chan->dma_active && (bm & (BM_SR_IRQ | BM_SR_ERR))) {
+            outb(chan->bmide + BM_REG_COMMAND, 0);
+            chan->ata_status = inb(chan->io + ATA_REG_STATUS);
+            outb(chan->bmide + BM_REG_STATUS, BM_SR_IRQ | BM_SR_ERR);
+            chan->dma_status = bm;
+            chan->dma_active = 0;
+            chan->dma_done = 1;
+        }
+        spin_unlock_irqrestore(&chan->lock, flags);
+
+        if (rdtsc() > deadline) {
+            return -1;
+        }
+        asm volatile ("pause");
+    }
+    return 0;
+}
+
+/* ========== DMA ========== */
+
+/* 按物理页拆分缓冲区构建 PRD 表，相邻且同一 64KB 内的物理页合并为一项 */
+static int ata_build_prd(ata_channel_t *chan, uint32_t vaddr, uint32_t bytes) {
+    ata_prd_t *prd = chan->prd;
+    int n = -1;
+    uint32_t cur_len = 0;
+
+    while (bytes) {
+        uint32_t chunk = PAGE_SIZE - (vaddr & (PAGE_SIZE - 1));
+        if (chunk > bytes) {
+            chunk = bytes;
+        }
+        uint32_t phys = paging_virt_to_phys(vaddr);
+        if (!phys) {
+            return -1;
+        }
+
+        if (n >= 0 && prd[n].addr + cur_len == phys &&
+            (prd[n].addr & 0xFFFF0000) == ((phys + chunk - 1) & 0xFFFF0000)) {
+            cur_len += chunk;
+        } else {
+            if (++n >= ATA_PRD_ENTRIES) {
+                return -1;
+            }
+            prd[n].addr = phys;
+            prd[n].flags = 0;
+            cur_len = chunk;
+        }
+        prd[n].bytes = (uint16_t)cur_len;   // 正好 64KB 时截断为 0
+
+        vaddr += chunk;
+        bytes -= chunk;
+    }
+
+    prd[n].flags = ATA_PRD_EOT;
+    return 0;
+}
+
+static int ata_dma_transfer(ata_drive_t *drive, uint32_t lba, uint32_t count,
+                            void *buf, int write) {
+    ata_channel_t *chan = drive->chan;
+
+    if (ata_build_prd(chan, (uint32_t)buf, count * BLKDEV_SECTOR_SIZE) < 0) {
+        return -1;
+    }
+
+    outl(chan->bmide + BM_REG_PRDT, (uint32_t)chan->prd);
+    outb(chan->bmide + BM_REG_COMMAND, write ? 0 : BM_CMD_READ);
+    outb(chan->bmide + BM_REG_STATUS, BM_SR_IRQ | BM_SR_ERR);
+
+    uint32_t flags = spin_lock_irqsave(&chan->lock);
+    chan->dma_done = 0;
+    chan->dma_active = 1;
+    spin_unlock_irqrestore(&chan->lock, flags);
+
+    if (ata_issue(chan, drive->slave, lba, count,
+                  write ? ATA_CMD_WRITE_DMA : ATA_CMD_READ_DMA) < 0) {
+        chan->dma_active = 0;
+        return -1;
+    }
+    outb(chan->bmide + BM_REG_COMMAND, (write ? 0 : BM_CMD_READ) | BM_CMD_START);
+
+    int ret = 0;
+    if (chan->irq != 0xFF && thread_can_sleep()) {
+        // 中断可能丢失：超时后直接检查一次控制器状态再判定失败
+        if (!wait_event_timeout(&chan->wq, chan->dma_done,
+                                ATA_TIMEOUT_MS * TIMER_HZ / 1000)) {
+            ret = ata_dma_poll(chan, 0);
+        }
+    } else {
+        ret = ata_dma_poll(chan, ATA_TIMEOUT_MS);
+    }
+
+    if (ret < 0) {
+        // 停止总线主控引擎，避免它在请求失败后继续写缓冲区
+        flags = spin_lock_irqsave(&chan->lock);
+        outb(chan->bmide + BM_REG_COMMAND, 0);
+        outb(chan->bmide + BM_REG_STATUS, BM_SR_IRQ | BM_SR_ERR);
+        chan->dma_active = 0;
+        spin_unlock_irqrestore(&chan->lock, flags);
+        pr_warn("ata%d: DMA timed out\n", (int)(chan - ata_channels));
+        return -1;
+    }
+    if ((chan->dma_status & BM_SR_ERR) || (chan->ata_status & (ATA_SR_ERR | ATA_SR_DF))) {
+        return -1;
+    }
+    return 0;
+}
+
+/* ========== PIO ========== */
+
+static int ata_pio_transfer(ata_drive_t *drive, uint32_t lba, uint32_t count,
+                            void *buf, int write) {
+    ata_channel_t *chan = drive->chan;
+    uint16_t *p = (uint16_t *)buf;
+
+    if (ata_issue(chan, drive->slave, lba, count,
+                  write ? ATA_CMD_WRITE_PIO : ATA_CMD_READ_PIO) < 0) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        ata_delay400(chan);
+        if (ata_wait_drq(chan) < 0) {
+            return -1;
+        }
+        if (write) {
+            outsw(chan->io + ATA_REG_DATA, p, BLKDEV_SECTOR_SIZE / 2);
+        } else {
+            insw(chan->io + ATA_REG_DATA, p, BLKDEV_SECTOR_SIZE / 2);
+        }
+        p += BLKDEV_SECTOR_SIZE / 2;
+    }
+
+    int status = ata_wait_not_busy(chan, ATA_TIMEOUT_MS);
+    if (status < 0 || (status & (ATA_SR_ERR | ATA_SR_DF))) {
+        return -1;
+    }
+    return 0;
+}
+
+/* ========== 块设备接口 ========== */
+
+static int ata_transfer(blkdev_t *dev, uint32_t lba, uint32_t count, void *buf, int write) {
+    ata_drive_t *drive = dev->priv;
+    ata_channel_t *chan = drive->chan;
+    uint8_t *p = buf;
+    uint32_t n = 0;
+    int ret = 0;
+
+    ata_claim(chan);
+    while (count) {
+        n = count > ATA_MAX_SECTORS ? ATA_MAX_SECTORS : count;
+
+        // 总线主控要求缓冲区按字对齐，否则退回 PIO
+        if (drive->dma && !((uint32_t)p & 1)) {
+            ret = ata_dma_transfer(drive, lba, n, p, write);
+        } else {
+            ret = ata_pio_transfer(drive, lba, n, p, write);
+        }
+        if (ret < 0) {
+            break;
+        }
+
+        lba += n;
+        count -= n;
+        p += n * BLKDEV_SECTOR_SIZE;
+    }
+    ata_release(chan);
+
+    // 出错时 lba/n 仍是失败的那一段
+    if (ret < 0) {
+        pr_err("ata: %s %s error at lba %u (%u sectors)\n", dev->name,
+               write ? "write" : "read", lba, n);
+    }
+    return ret;
+}
+
+static int ata_read(blkdev_t *dev, uint32_t lba, uint32_t count, void *buf) {
+    return ata_transfer(dev, lba, count, buf, 0);
+}
+
+static int ata_write(blkdev_t *dev, uint32_t lba, uint32_t count, const void *buf) {
+    return ata_transfer(dev, lba, count, (void *)buf, 1);
+}
+
+static int ata_flush(blkdev_t *dev) {
+    ata_drive_t *drive = dev->priv;
+    ata_channel_t *chan = drive->chan;
+    int status;
+
+    ata_claim(chan);
+    ata_select(chan, drive->slave, 0);
+    status = ata_wait_not_busy(chan, ATA_TIMEOUT_MS);
+    if (status >= 0) {
+        outb(chan->io + ATA_REG_COMMAND, ATA_CMD_FLUSH);
+        ata_delay400(chan);
+        // 刷缓存可能很慢，给足时间
+        status = ata_wait_not_busy(chan, ATA_TIMEOUT_MS * 6);
+    }
+    ata_release(chan);
+
+    return (status < 0 || (status & (ATA_SR_ERR | ATA_SR_DF))) ? -1 : 0;
+}
+
+static const blkdev_ops_t ata_blk_ops = {
+    .read = ata_read,
+    .write = ata_write,
+    .flush = ata_flush,
+};
+
+/* ========== 探测 ========== */
+
+/* IDENTIFY DEVICE，成功时填充 256 个字；不存在或是 ATAPI 设备返回 -1 */
+static int ata_identify(ata_channel_t *chan, uint8_t slave, uint16_t *id) {
+    ata_select(chan, slave, 0);
+    outb(chan->io + ATA_REG_SECCOUNT, 0);
+    outb(chan->io + ATA_REG_LBA_LO, 0);
+    outb(chan->io + ATA_REG_LBA_MID, 0);
+    outb(chan->io + ATA_REG_LBA_HI, 0);
+    outb(chan->io + ATA_REG_COMMAND, ATA_CMD_IDENTIFY);
+    ata_delay400(chan);
+
+    // 状态为 0 表示该位置没有设备
+    if (inb(chan->io + ATA_REG_STATUS) == 0) {
+        return -1;
+    }
+    if (ata_wait_not_busy(chan, 1000) < 0) {
+        return -1;
+    }
+    // ATAPI / SATA 设备会在 LBA 中、高字节留下签名
+    if (inb(chan->io + ATA_REG_LBA_MID) || inb(chan->io + ATA_REG_LBA_HI)) {
+        return -1;
+    }
+    if (ata_wait_drq(chan) < 0) {
+        return -1;
+    }
+
+    insw(chan->io + ATA_REG_DATA, id, 256);
+    return 0;
+}
+
+/* IDENTIFY 中的字符串每个字高低字节颠倒，末尾用空格填充 */
+static void ata_copy_model(char *dst, const uint16_t *id) {
+    for (int i = 0; i < 20; i++) {
+        dst[i * 2] = id[27 + i] >> 8;
+        dst[i * 2 + 1] = id[27 + i] & 0xFF;
+    }
+    dst[40] = '\0';
+    for (int i = 39; i >= 0 && dst[i] == ' '; i--) {
+        dst[i] = '\0';
+    }
+}
+
+static void ata_probe_channel(int index) {
+    ata_channel_t *chan = &ata_channels[index];
+    uint16_t id[256];
+
+    // 浮空总线读出 0xFF：通道上没有任何设备
+    if (inb(chan->io + ATA_REG_STATUS) == 0xFF) {
+        chan->io = 0;
+        return;
+    }
+
+    // 识别阶段屏蔽设备中断，全部轮询
+    outb(chan->ctrl, ATA_CTRL_NIEN);
+    chan->selected = 0xFF;
+
+    for (uint8_t slave = 0; slave < 2; slave++) {
+        ata_drive_t *drive = &ata_drives[index * 2 + slave];
+
+        if (ata_identify(chan, slave, id) < 0) {
+            continue;
+        }
+
+        // 只支持 LBA28（字 49 第 9 位为 LBA 支持）
+        uint32_t sectors = id[60] | ((uint32_t)id[61] << 16);
+        if (!(id[49] & (1 << 9)) || sectors == 0) {
+            continue;
+        }
+
+        drive->chan = chan;
+        drive->slave = slave;
+        drive->dma = CONFIG_ATA_DMA && chan->bmide && (id[49] & (1 << 8));
+        ata_copy_model(drive->model, id);
+
+        drive->blk.name[0] = 'h';
+        drive->blk.name[1] = 'd';
+        drive->blk.name[2] = 'a' + index * 2 + slave;
+        drive->blk.name[3] = '\0';
+        drive->blk.sector_count = sectors;
+        drive->blk.sector_size = BLKDEV_SECTOR_SIZE;
+        drive->blk.ops = &ata_blk_ops;
+        drive->blk.priv = drive;
+
+        pr_info("ata: %s \"%s\" %s\n", drive->blk.name, drive->model,
+                drive->dma ? "DMA" : "PIO");
+        blkdev_register(&drive->blk);
+    }
+
+    // 恢复设备中断：DMA 完成依赖它
+    outb(chan->ctrl, 0);
+    inb(chan->io + ATA_REG_STATUS);
+}
+
+void ata_init(void) {
+    pci_device_t *pdev = pci_find_class(PCI_CLASS_STORAGE, PCI_SUBCLASS_IDE, 0);
+    uint16_t bmide = 0;
+
+    // 兼容模式的默认资源；没有 PCI 控制器时仍按 ISA 方式尝试 PIO
+    ata_channels[0].io = ATA_PRIMARY_IO;
+    ata_channels[0].ctrl = ATA_PRIMARY_CTRL;
+    ata_channels[0].irq = ATA_PRIMARY_IRQ;
+    ata_channels[1].io = ATA_SECONDARY_IO;
+    ata_channels[1].ctrl = ATA_SECONDARY_CTRL;
+    ata_channels[1].irq = ATA_SECONDARY_IRQ;
+
+    if (pdev) {
+        // prog_if 第 0/2 位：主/从通道工作在 PCI 原生模式，资源来自 BAR
+        for (int i = 0; i < 2; i++) {
+            if (pdev->prog_if & (1 << (i * 2))) {
+                ata_channels[i].io = pdev->bar[i * 2] & ~3;
+                ata_channels[i].ctrl = (pdev->bar[i * 2 + 1] & ~3) + 2;
+                ata_channels[i].irq = pdev->irq < IRQ_COUNT ? pdev->irq : 0xFF;
+            }
+        }
+        // prog_if 第 7 位：支持总线主控，寄存器在 BAR4（I/O 空间）
+        if ((pdev->prog_if & 0x80) && (pdev->bar[4] & PCI_BAR_IO)) {
+            bmide = pdev->bar[4] & ~3;
+            pci_enable_bus_master(pdev);
+        }
+    }
+
+    for (int i = 0; i < 2; i++) {
+        ata_channel_t *chan = &ata_channels[i];
+        chan->bmide = bmide ? bmide + i * 8 : 0;
+        chan->prd = ata_prd_tables[i];
+        chan->selected = 0xFF;
+        spin_lock_init(&chan->lock, i ? "ata1" : "ata0");
+        wait_queue_init(&chan->wq, i ? "ata1_wq" : "ata0_wq");
+
+        ata_probe_channel(i);
+        if (chan->io && chan->irq != 0xFF &&
+            register_irq_shared(chan->irq, ata_irq_handler, chan) < 0) {
+            pr_warn("ata%d: irq %u unavailable, polling\n", i, chan->irq);
+            chan->irq = 0xFF;
+        }
+    }
+}
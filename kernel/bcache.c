@@ -0,0 +1,567 @@
+#include <kernel/bcache.h>
+#include <kernel/crc32c.h>
+#include <kernel/printk.h>
+#include <kernel/spinlock.h>
+#include <kernel/string.h>
+#include <kernel/thread.h>
+#include <kernel/timer.h>
+#include <kernel/waitqueue.h>
+#include <stddef.h>
+
+/* 每个设备的顺序访问检测状态 */
+typedef struct {
+    blkdev_t *dev;
+    uint32_t next;              // 顺序访问时预期的下一个块
+    uint32_t window;            // 当前预读窗口（块数，0 表示未在顺序读）
+} bcache_ra_t;
+
+static uint8_t bcache_data[BCACHE_BLOCKS][BCACHE_BLOCK_SIZE] __attribute__((aligned(4096)));
+static bcache_buf_t bcache_bufs[BCACHE_BLOCKS];
+static bcache_buf_t *bcache_hash[BCACHE_HASH_SIZE];
+static bcache_buf_t bcache_lru;         // 哨兵：lru_next 为最近使用，lru_prev 为最久未用
+static bcache_ra_t bcache_ra[BLKDEV_MAX];
+static bcache_stats_t stats;
+
+/* 预读先把连续的若干块一次读入暂存区，再分发到各缓存块 */
+static uint8_t ra_staging[BCACHE_RA_MAX * BCACHE_BLOCK_SIZE] __attribute__((aligned(4096)));
+static uint8_t ra_staging_busy = 0;
+
+static spinlock_t bcache_lock = SPINLOCK_INIT;
+static waitqueue_t bcache_wq;
+static volatile uint32_t bcache_events = 0;     // 每次状态变化加一，等待者据此判断进展
+static uint8_t bcache_starved = 0;              // 有线程在等待可淘汰的块
+
+/* ========== 哈希表与 LRU（调用者持有 bcache_lock） ========== */
+
+static inline uint32_t bcache_hashfn(blkdev_t *dev, uint32_t block) {
+    return (((uint32_t)dev >> 4) ^ (block * 2654435761u)) & (BCACHE_HASH_SIZE - 1);
+}
+
+static bcache_buf_t *hash_find(blkdev_t *dev, uint32_t block) {
+    bcache_buf_t *b = bcache_hash[bcache_hashfn(dev, block)];
+    while (b && (b->dev != dev || b->block != block)) {
+        b = b->hash_next;
+    }
+    return b;
+}
+
+static void hash_insert(bcache_buf_t *b) {
+    uint32_t h = bcache_hashfn(b->dev, b->block);
+    b->hash_next = bcache_hash[h];
+    bcache_hash[h] = b;
+}
+
+static void hash_remove(bcache_buf_t *b) {
+    bcache_buf_t **pp = &bcache_hash[bcache_hashfn(b->dev, b->block)];
+    while (*pp && *pp != b) {
+        pp = &(*pp)->hash_next;
+    }
+    if (*pp) {
+        *pp = b->hash_next;
+    }
+    b->hash_next = NULL;
+}
+
+static void lru_remove(bcache_buf_t *b) {
+    b->lru_prev->lru_next = b->lru_next;
+    b->lru_next->lru_prev = b->lru_prev;
+}
+
+static void lru_push_front(bcache_buf_t *b) {
+    b->lru_next = bcache_lru.lru_next;
+    b->lru_prev = &bcache_lru;
+    bcache_lru.lru_next->lru_prev = b;
+    bcache_lru.lru_next = b;
+}
+
+static void lru_push_back(bcache_buf_t *b) {
+    b->lru_prev = bcache_lru.lru_prev;
+    b->lru_next = &bcache_lru;
+    bcache_lru.lru_prev->lru_next = b;
+    bcache_lru.lru_prev = b;
+}
+
+static void lru_touch(bcache_buf_t *b) {
+    lru_remove(b);
+    lru_push_front(b);
+}
+
+/* 从最久未用的一端找一个可以淘汰的块；clean_only 时跳过脏块 */
+static bcache_buf_t *find_victim(int clean_only) {
+    for (bcache_buf_t *b = bcache_lru.lru_prev; b != &bcache_lru; b = b->lru_prev) {
+        if (b->refcount || (b->flags & (BCACHE_BUSY | BCACHE_WRITING))) {
+            continue;
+        }
+        if (clean_only && (b->flags & BCACHE_DIRTY)) {
+            continue;
+        }
+        return b;
+    }
+    return NULL;
+}
+
+/* 把一个可淘汰的块改为缓存 (dev, block)，数据待读入 */
+static void claim(bcache_buf_t *b, blkdev_t *dev, uint32_t block, uint16_t flags) {
+    if (b->flags & BCACHE_VALID) {
+        hash_remove(b);
+        stats.evictions++;
+    }
+    b->dev = dev;
+    b->block = block;
+    b->flags = BCACHE_BUSY | flags;
+    hash_insert(b);
+    lru_touch(b);
+}
+
+/* 使块失效并放到最先被复用的位置 */
+static void drop(bcache_buf_t *b) {
+    hash_remove(b);
+    b->flags = 0;
+    b->dev = NULL;
+    lru_remove(b);
+    lru_push_back(b);
+}
+
+/* ========== 预读 ========== */
+
+static bcache_ra_t *ra_lookup(blkdev_t *dev) {
+    bcache_ra_t *free_slot = &bcache_ra[0];
+    for (uint32_t i = 0; i < BLKDEV_MAX; i++) {
+        if (bcache_ra[i].dev == dev) {
+            return &bcache_ra[i];
+        }
+        if (!bcache_ra[i].dev) {
+            free_slot = &bcache_ra[i];
+        }
+    }
+    free_slot->dev = dev;
+    free_slot->next = 0xFFFFFFFF;
+    free_slot->window = 0;
+    return free_slot;
+}
+
+/* 记录一次访问；未命中时返回本次应读入的块数（含请求的块） */
+static uint32_t ra_update(blkdev_t *dev, uint32_t block, int miss) {
+    bcache_ra_t *ra = ra_lookup(dev);
+    int sequential = (block == ra->next);
+    ra->next = block + 1;
+
+    if (!miss) {
+        return 0;
+    }
+    if (!sequential) {
+        ra->window = 0;
+        return 1;
+    }
+    // 顺序读每次未命中都把窗口翻倍：命中率越高，单次 I/O 越大
+    ra->window = ra->window ? ra->window * 2 : BCACHE_RA_MIN;
+    if (ra->window > BCACHE_RA_MAX) {
+        ra->window = BCACHE_RA_MAX;
+    }
+    return ra->window;
+}
+
+/* ========== 磁盘 I/O（不持锁） ========== */
+
+static uint32_t dev_blocks(blkdev_t *dev) {
+    return (dev->sector_count >> 3) + ((dev->sector_count & 7) != 0);
+}
+
+/* 从 block 开始 n 个块实际存在的扇区数（设备末尾可能不足一块） */
+static uint32_t span_sectors(blkdev_t *dev, uint32_t block, uint32_t n) {
+    uint32_t first = block * BCACHE_BLOCK_SECTORS;
+    uint32_t left = dev->sector_count - first;
+    uint32_t want = n * BCACHE_BLOCK_SECTORS;
+    return want < left ? want : left;
+}
+
+/* 读入 [block, block+n)：n 为 1 时直接读进缓存块，否则经暂存区分发 */
+static int read_blocks(blkdev_t *dev, uint32_t block, bcache_buf_t **bufs, uint32_t n) {
+    uint32_t sectors = span_sectors(dev, block, n);
+    uint8_t *dst = (n == 1) ? bufs[0]->data : ra_staging;
+
+    if (blkdev_read(dev, block * BCACHE_BLOCK_SECTORS, sectors, dst) < 0) {
+        return -1;
+    }
+    if (sectors < n * BCACHE_BLOCK_SECTORS) {
+        memset(dst + sectors * BLKDEV_SECTOR_SIZE, 0,
+               (n * BCACHE_BLOCK_SECTORS - sectors) * BLKDEV_SECTOR_SIZE);
+    }
+    if (n > 1) {
+        for (uint32_t i = 0; i < n; i++) {
+            memcpy(bufs[i]->data, ra_staging + i * BCACHE_BLOCK_SIZE, BCACHE_BLOCK_SIZE);
+        }
+    }
+    return 0;
+}
+
+static int write_block(bcache_buf_t *b) {
+    return blkdev_write(b->dev, b->block * BCACHE_BLOCK_SECTORS,
+                        span_sectors(b->dev, b->block, 1), b->data);
+}
+
+/* 等待任意状态变化（seen 是持锁时读到的 bcache_events） */
+static void bcache_wait(uint32_t seen) {
+    if (thread_can_sleep()) {
+        wait_event(&bcache_wq, bcache_events != seen);
+    } else {
+        asm volatile ("pause");
+    }
+}
+
+/* 写回一个已标记 BCACHE_WRITING 的块；调用前释放锁，返回后重新持锁 */
+static int writeback_unlocked(bcache_buf_t *b, uint32_t *flags) {
+    spin_unlock_irqrestore(&bcache_lock, *flags);
+    int ret = write_block(b);
+    *flags = spin_lock_irqsave(&bcache_lock);
+
+    b->flags &= ~BCACHE_WRITING;
+    if (ret == 0) {
+        stats.writebacks++;
+    }
+    bcache_events++;
+    return ret;
+}
+
+/* 写回 dev（NULL 为全部）的脏块，返回写失败的块数 */
+static uint32_t bcache_writeback(blkdev_t *dev);
+
+/* 回写线程：周期性写回脏块（刷设备写缓存留给显式的 bcache_sync） */
+static void bcache_flush_thread(void *arg) {
+    (void)arg;
+    for (;;) {
+        thread_sleep(CONFIG_BCACHE_WRITEBACK_MS * TIMER_HZ / 1000);
+        bcache_writeback(NULL);
+    }
+}
+
+/* ========== 接口 ========== */
+
+void bcache_init(void) {
+    spin_lock_init(&bcache_lock, "bcache");
+    wait_queue_init(&bcache_wq, "bcache_wq");
+    memset(&stats, 0, sizeof(stats));
+
+    bcache_lru.lru_next = bcache_lru.lru_prev = &bcache_lru;
+    for (uint32_t i = 0; i < BCACHE_BLOCKS; i++) {
+        bcache_bufs[i].data = bcache_data[i];
+        lru_push_back(&bcache_bufs[i]);
+    }
+
+    if (!thread_create("bcache_flush", bcache_flush_thread, NULL, THREAD_PRIO_BULK)) {
+        pr_warn("bcache: no writeback thread, dirty blocks are written on sync only\n");
+    }
+}
+
+bcache_buf_t *bcache_get(blkdev_t *dev, uint32_t block) {
+    if (!dev || block >= dev_blocks(dev)) {
+        return NULL;
+    }
+
+    bcache_buf_t *bufs[BCACHE_RA_MAX];
+    uint32_t flags = spin_lock_irqsave(&bcache_lock);
+    uint32_t seen;
+    int wake = 0;
+
+    for (;;) {
+        bcache_buf_t *b = hash_find(dev, block);
+        if (b) {
+            // 别的线程正在读这个块：等它完成（失败时块已被移出哈希表）
+            if (b->flags & BCACHE_BUSY) {
+                seen = bcache_events;
+                spin_unlock_irqrestore(&bcache_lock, flags);
+                bcache_wait(seen);
+                flags = spin_lock_irqsave(&bcache_lock);
+                continue;
+            }
+            b->refcount++;
+            stats.hits++;
+            if (b->flags & BCACHE_RA) {
+                b->flags &= ~BCACHE_RA;
+                stats.ra_hits++;
+            }
+            ra_update(dev, block, 0);
+            lru_touch(b);
+            spin_unlock_irqrestore(&bcache_lock, flags);
+            if (wake) {
+                wait_queue_wake_all(&bcache_wq);
+            }
+            return b;
+        }
+
+        bufs[0] = find_victim(0);
+        if (!bufs[0]) {
+            // 所有块都被持有或在 I/O 中：等有块释放
+            bcache_starved = 1;
+            seen = bcache_events;
+            spin_unlock_irqrestore(&bcache_lock, flags);
+            bcache_wait(seen);
+            flags = spin_lock_irqsave(&bcache_lock);
+            continue;
+        }
+        if (bufs[0]->flags & BCACHE_DIRTY) {
+            // 淘汰脏块之前先写回；写失败时数据已无法保存，丢弃并报告
+            bcache_buf_t *v = bufs[0];
+            v->flags = (v->flags & ~BCACHE_DIRTY) | BCACHE_WRITING;
+            if (writeback_unlocked(v, &flags) < 0) {
+                pr_err("bcache: %s block %u lost on writeback\n", v->dev->name, v->block);
+            }
+            wake = 1;
+            continue;
+        }
+        break;
+    }
+
+    // 未命中：按顺序访问检测的结果决定一次读入多少块
+    stats.misses++;
+    uint32_t window = ra_update(dev, block, 1);
+    uint32_t n = 1;
+    claim(bufs[0], dev, block, 0);
+
+    if (window > 1 && !ra_staging_busy) {
+        ra_staging_busy = 1;
+        uint32_t limit = dev_blocks(dev) - block;
+        // 预读区间必须连续：遇到已缓存的块或没有干净的块可用就停止
+        while (n < window && n < limit && !hash_find(dev, block + n)) {
+            bcache_buf_t *v = find_victim(1);
+            if (!v) {
+                break;
+            }
+            claim(v, dev, block + n, BCACHE_RA);
+            bufs[n++] = v;
+        }
+        if (n == 1) {
+            ra_staging_busy = 0;
+        }
+    }
+    spin_unlock_irqrestore(&bcache_lock, flags);
+
+    int ret = read_blocks(dev, block, bufs, n);
+
+    flags = spin_lock_irqsave(&bcache_lock);
+    if (n > 1) {
+        ra_staging_busy = 0;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (ret < 0) {
+            drop(bufs[i]);
+        } else {
+            bufs[i]->flags = (bufs[i]->flags & ~BCACHE_BUSY) | BCACHE_VALID;
+        }
+    }
+    if (ret == 0) {
+        stats.ra_blocks += n - 1;
+        bufs[0]->refcount = 1;
+    }
+    bcache_events++;
+    spin_unlock_irqrestore(&bcache_lock, flags);
+    wait_queue_wake_all(&bcache_wq);
+
+    return ret == 0 ? bufs[0] : NULL;
+}
+
+void bcache_mark_dirty(bcache_buf_t *buf) {
+    uint32_t flags = spin_lock_irqsave(&bcache_lock);
+    buf->flags |= BCACHE_DIRTY;
+    spin_unlock_irqrestore(&bcache_lock, flags);
+}
+
+void bcache_release(bcache_buf_t *buf) {
+    int wake = 0;
+    uint32_t flags = spin_lock_irqsave(&bcache_lock);
+    if (buf->refcount && --buf->refcount == 0 && bcache_starved) {
+        bcache_starved = 0;
+        bcache_events++;
+        wake = 1;
+    }
+    spin_unlock_irqrestore(&bcache_lock, flags);
+
+    if (wake) {
+        wait_queue_wake_all(&bcache_wq);
+    }
+}
+
+int bcache_read(blkdev_t *dev, uint32_t offset, void *dst, uint32_t len) {
+    uint8_t *p = dst;
+
+    while (len) {
+        uint32_t block = offset / BCACHE_BLOCK_SIZE;
+        uint32_t off = offset % BCACHE_BLOCK_SIZE;
+        uint32_t n = BCACHE_BLOCK_SIZE - off;
+        if (n > len) {
+            n = len;
+        }
+
+        bcache_buf_t *b = bcache_get(dev, block);
+        if (!b) {
+            return -1;
+        }
+        memcpy(p, b->data + off, n);
+        bcache_release(b);
+
+        p += n;
+        offset += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int bcache_write(blkdev_t *dev, uint32_t offset, const void *src, uint32_t len) {
+    const uint8_t *p = src;
+
+    while (len) {
+        uint32_t block = offset / BCACHE_BLOCK_SIZE;
+        uint32_t off = offset % BCACHE_BLOCK_SIZE;
+        uint32_t n = BCACHE_BLOCK_SIZE - off;
+        if (n > len) {
+            n = len;
+        }
+
+        bcache_buf_t *b = bcache_get(dev, block);
+        if (!b) {
+            return -1;
+        }
+        memcpy(b->data + off, p, n);
+        bcache_mark_dirty(b);
+        bcache_release(b);
+
+        p += n;
+        offset += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static uint32_t bcache_writeback(blkdev_t *dev) {
+    uint32_t errors = 0;
+    int wrote = 0;
+    uint32_t flags = spin_lock_irqsave(&bcache_lock);
+
+    for (uint32_t i = 0; i < BCACHE_BLOCKS; i++) {
+        bcache_buf_t *b = &bcache_bufs[i];
+        if ((dev && b->dev != dev) || (b->flags & (BCACHE_DIRTY | BCACHE_WRITING)) != BCACHE_DIRTY) {
+            continue;
+        }
+        // 先清脏位：写回期间再次修改会重新置位，不会丢失
+        b->flags = (b->flags & ~BCACHE_DIRTY) | BCACHE_WRITING;
+        if (writeback_unlocked(b, &flags) < 0) {
+            b->flags |= BCACHE_DIRTY;
+            errors++;
+        }
+        wrote = 1;
+    }
+
+    spin_unlock_irqrestore(&bcache_lock, flags);
+    if (wrote) {
+        wait_queue_wake_all(&bcache_wq);
+    }
+    return errors;
+}
+
+int bcache_sync(blkdev_t *dev) {
+    int ret = bcache_writeback(dev) ? -1 : 0;
+
+    if (dev) {
+        return blkdev_flush(dev) < 0 ? -1 : ret;
+    }
+    for (uint32_t i = 0; blkdev_get_index(i); i++) {
+        if (blkdev_flush(blkdev_get_index(i)) < 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+void bcache_invalidate(blkdev_t *dev) {
+    bcache_sync(dev);
+
+    uint32_t flags = spin_lock_irqsave(&bcache_lock);
+    for (uint32_t i = 0; i < BCACHE_BLOCKS; i++) {
+        bcache_buf_t *b = &bcache_bufs[i];
+        if (b->dev == dev && !b->refcount &&
+            !(b->flags & (BCACHE_BUSY | BCACHE_WRITING | BCACHE_DIRTY))) {
+            drop(b);
+        }
+    }
+    for (uint32_t i = 0; i < BLKDEV_MAX; i++) {
+        if (bcache_ra[i].dev == dev) {
+            bcache_ra[i].dev = NULL;
+        }
+    }
+    spin_unlock_irqrestore(&bcache_lock, flags);
+}
+
+void bcache_get_stats(bcache_stats_t *out) {
+    uint32_t flags = spin_lock_irqsave(&bcache_lock);
+    *out = stats;
+    spin_unlock_irqrestore(&bcache_lock, flags);
+}
+
+/* part * 100 / total，避免 64 位除法 */
+static uint32_t percent(uint32_t part, uint32_t total) {
+    if (!total) {
+        return 0;
+    }
+    return total >= 0x01000000 ? part / (total / 100) : part * 100 / total;
+}
+
+#if CONFIG_BCACHE_SELFTEST
+static uint8_t selftest_buf[BCACHE_BLOCK_SIZE];
+
+/* 按块顺序读 [0, bytes)，返回内容的 CRC32C；读失败时 *ok 置 0 */
+static uint32_t selftest_pass(blkdev_t *dev, uint32_t bytes, int *ok) {
+    uint32_t crc = 0;
+    for (uint32_t off = 0; off < bytes; off += BCACHE_BLOCK_SIZE) {
+        uint32_t n = bytes - off < BCACHE_BLOCK_SIZE ? bytes - off : BCACHE_BLOCK_SIZE;
+        if (bcache_read(dev, off, selftest_buf, n) < 0) {
+            *ok = 0;
+            break;
+        }
+        crc = crc32c(crc, selftest_buf, n);
+    }
+    return crc;
+}
+
+int bcache_selftest(void) {
+    blkdev_t *dev = blkdev_get_index(0);
+    if (!dev) {
+        return 0;
+    }
+
+    // 缓存装不下时第二遍无法全部命中
+    uint32_t bytes = BCACHE_SELFTEST_BYTES;
+    if (bytes / BLKDEV_SECTOR_SIZE > dev->sector_count) {
+        bytes = dev->sector_count * BLKDEV_SECTOR_SIZE;
+    }
+
+    bcache_invalidate(dev);
+    bcache_stats_t s0, s1, s2;
+    int ok = 1;
+    bcache_get_stats(&s0);
+    uint32_t crc1 = selftest_pass(dev, bytes, &ok);
+    bcache_get_stats(&s1);
+    uint32_t crc2 = ok ? selftest_pass(dev, bytes, &ok) : 0;
+    bcache_get_stats(&s2);
+
+    uint32_t blocks = (bytes + BCACHE_BLOCK_SIZE - 1) / BCACHE_BLOCK_SIZE;
+    pr_info("bcache: self-test %s %u KB: pass 1 %u hits, %u misses, read-ahead %u blocks (%u used); "
+            "pass 2 %u hits, %u misses\n", dev->name, bytes / 1024,
+            s1.hits - s0.hits, s1.misses - s0.misses, s1.ra_blocks - s0.ra_blocks,
+            s1.ra_hits - s0.ra_hits, s2.hits - s1.hits, s2.misses - s1.misses);
+    if (!ok || crc1 != crc2 || s2.hits - s1.hits != blocks) {
+        pr_err("bcache: self-test failed on %s\n", dev->name);
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+void bcache_report(void) {
+    bcache_stats_t s;
+    bcache_get_stats(&s);
+
+    pr_info("bcache: %u hits, %u misses (%u%% hit rate), %u evictions, %u writebacks\n",
+            s.hits, s.misses, percent(s.hits, s.hits + s.misses), s.evictions, s.writebacks);
+    pr_info("bcache: read-ahead %u blocks, %u used (%u%%)\n",
+            s.ra_blocks, s.ra_hits, percent(s.ra_hits, s.ra_blocks));
+}
@@ -0,0 +1,156 @@
+#include <kernel/bga.h>
+#include <kernel/io.h>
+#include <kernel/printk.h>
+#include <stddef.h>
+
+/* VGA 输入状态寄存器 1：bit 3 为垂直回扫 */
+#define VGA_INPUT_STATUS_1      0x3DA
+#define VGA_STATUS_VRETRACE     0x08
+#define VGA_VSYNC_SPIN          1000000
+
+static graphics_context_t *front_ctx = NULL;    // 当前显示的页（即 gfx_ctx）
+static graphics_context_t back_ctx;
+static uint8_t *fb_base = NULL;                 // 显存起点（第 0 页）
+static uint32_t vram_size = 0;
+static uint32_t pages = 0;
+static uint32_t front = 0;
+
+static inline uint16_t dispi_read(uint16_t index) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    return inw(VBE_DISPI_IOPORT_DATA);
+}
+
+static inline void dispi_write(uint16_t index, uint16_t value) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    outw(VBE_DISPI_IOPORT_DATA, value);
+}
+
+/* 等待下一次垂直回扫开始（有上限，模拟器不实现时不会卡死） */
+static void wait_vretrace(void) {
+    uint32_t spin = VGA_VSYNC_SPIN;
+    while ((inb(VGA_INPUT_STATUS_1) & VGA_STATUS_VRETRACE) && --spin) {
+    }
+    while (!(inb(VGA_INPUT_STATUS_1) & VGA_STATUS_VRETRACE) && --spin) {
+    }
+}
+
+static inline uint8_t *page_addr(uint32_t page) {
+    return fb_base + page * front_ctx->pitch * front_ctx->height;
+}
+
+/* 按当前模式申请 CONFIG_BGA_PAGES 页的虚拟高度，以设备回读的值为准 */
+static void setup_pages(void) {
+    uint32_t height = front_ctx->height;
+    uint32_t want = CONFIG_BGA_PAGES;
+    while (want > 1 && front_ctx->pitch * height * want > vram_size) {
+        want--;
+    }
+
+    dispi_write(VBE_DISPI_INDEX_VIRT_WIDTH, front_ctx->pitch / (front_ctx->bpp / 8));
+    dispi_write(VBE_DISPI_INDEX_VIRT_HEIGHT, height * want);
+    dispi_write(VBE_DISPI_INDEX_X_OFFSET, 0);
+    dispi_write(VBE_DISPI_INDEX_Y_OFFSET, 0);
+    pages = dispi_read(VBE_DISPI_INDEX_VIRT_HEIGHT) / height;
+    if (pages > want) {
+        pages = want;
+    }
+
+    front = 0;
+    front_ctx->framebuffer = (uint32_t *)page_addr(0);
+    back_ctx = *front_ctx;
+    back_ctx.framebuffer = (uint32_t *)page_addr(pages > 1 ? 1 : 0);
+}
+
+static int program_mode(uint32_t width, uint32_t height, uint32_t bpp) {
+    dispi_write(VBE_DISPI_INDEX_ENABLE, 0);
+    dispi_write(VBE_DISPI_INDEX_XRES, width);
+    dispi_write(VBE_DISPI_INDEX_YRES, height);
+    dispi_write(VBE_DISPI_INDEX_BPP, bpp);
+    dispi_write(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_ENABLED | VBE_DISPI_LFB_ENABLED);
+    return (dispi_read(VBE_DISPI_INDEX_XRES) == width &&
+            dispi_read(VBE_DISPI_INDEX_YRES) == height &&
+            dispi_read(VBE_DISPI_INDEX_BPP) == bpp) ? 0 : -1;
+}
+
+uint32_t bga_init(graphics_context_t *ctx) {
+    uint16_t id = dispi_read(VBE_DISPI_INDEX_ID);
+    if (id < VBE_DISPI_ID0 || id > VBE_DISPI_ID5) {
+        return 0;
+    }
+
+    // GRUB 设置的模式必须就是 DISPI 当前的模式，帧缓冲地址才是显存起点
+    if (!(dispi_read(VBE_DISPI_INDEX_ENABLE) & VBE_DISPI_ENABLED) ||
+        dispi_read(VBE_DISPI_INDEX_XRES) != ctx->width ||
+        dispi_read(VBE_DISPI_INDEX_YRES) != ctx->height ||
+        dispi_read(VBE_DISPI_INDEX_BPP) != ctx->bpp ||
+        dispi_read(VBE_DISPI_INDEX_Y_OFFSET) != 0) {
+        pr_warn("bga: framebuffer is not the active DISPI mode, page flipping disabled\n");
+        return 0;
+    }
+
+    front_ctx = ctx;
+    fb_base = (uint8_t *)ctx->framebuffer;
+    // 显存大小寄存器在 ID5 之前的实现中不存在，此时只按一页使用
+    vram_size = (id >= VBE_DISPI_ID5) ? (uint32_t)dispi_read(VBE_DISPI_INDEX_VIDEO_MEMORY_64K) << 16 : 0;
+    if (vram_size < ctx->pitch * ctx->height) {
+        vram_size = ctx->pitch * ctx->height;
+    }
+
+    setup_pages();
+    pr_info("bga: DISPI 0x%x, %u KB VRAM, %u page(s) of %ux%u\n",
+            id, vram_size >> 10, pages, ctx->width, ctx->height);
+    return pages;
+}
+
+uint32_t bga_vram_size(void) {
+    return vram_size;
+}
+
+uint32_t bga_page_count(void) {
+    return pages;
+}
+
+graphics_context_t *bga_back_buffer(void) {
+    return pages > 1 ? &back_ctx : NULL;
+}
+
+void bga_flip(void) {
+    if (pages < 2) {
+        return;
+    }
+
+    // 双缓冲时旧的前台页马上会成为绘制目标，必须等它扫描完；
+    // 三缓冲时下一个绘制目标是更早显示过的页，不用等
+    uint32_t next = (front + 1) % pages;
+    if (pages == 2) {
+        wait_vretrace();
+    }
+    dispi_write(VBE_DISPI_INDEX_Y_OFFSET, next * front_ctx->height);
+
+    front = next;
+    front_ctx->framebuffer = (uint32_t *)page_addr(front);
+    back_ctx.framebuffer = (uint32_t *)page_addr((front + 1) % pages);
+}
+
+int bga_set_mode(uint32_t width, uint32_t height, uint32_t bpp) {
+    if (!front_ctx || !width || !height || (bpp != 32 && bpp != 24 && bpp != 16) ||
+        (width * (bpp / 8)) * height > vram_size) {
+        return -1;
+    }
+
+    // 设备可能拒绝不支持的组合，以回读为准；失败时恢复原来的模式
+    if (program_mode(width, height, bpp) < 0) {
+        pr_err("bga: mode %ux%ux%u rejected\n", width, height, bpp);
+        program_mode(front_ctx->width, front_ctx->height, front_ctx->bpp);
+        setup_pages();
+        return -1;
+    }
+
+    front_ctx->width = width;
+    front_ctx->height = height;
+    front_ctx->bpp = bpp;
+    front_ctx->pitch = width * (bpp / 8);
+    setup_pages();
+    pr_info("bga: mode %ux%ux%u, %u page(s)\n", width, height, bpp, pages);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <kernel/blkdev.h>
+#include <kernel/printk.h>
+#include <kernel/trace.h>
+#include <kernel/string.h>
+#include <stddef.h>
+
+static blkdev_t *blkdevs[BLKDEV_MAX];
+static uint32_t blkdev_count = 0;
+
+int blkdev_register(blkdev_t *dev) {
+    if (blkdev_count >= BLKDEV_MAX || !dev->ops || blkdev_get(dev->name)) {
+        return -1;
+    }
+    if (dev->sector_size == 0) {
+        dev->sector_size = BLKDEV_SECTOR_SIZE;
+    }
+
+    blkdevs[blkdev_count++] = dev;
+    // 扇区数右移 11 位即 MB（512 字节扇区）
+    pr_info("blk: %s %u sectors (%u MB)\n", dev->name, dev->sector_count,
+            dev->sector_count >> 11);
+    return 0;
+}
+
+blkdev_t *blkdev_get(const char *name) {
+    for (uint32_t i = 0; i < blkdev_count; i++) {
+        if (strcmp(blkdevs[i]->name, name) == 0) {
+            return blkdevs[i];
+        }
+    }
+    return NULL;
+}
+
+blkdev_t *blkdev_get_index(uint32_t index) {
+    return index < blkdev_count ? blkdevs[index] : NULL;
+}
+
+/* 检查 [lba, lba+count) 是否在设备范围内（注意回绕） */
+static int blkdev_check_range(blkdev_t *dev, uint32_t lba, uint32_t count) {
+    return dev && count != 0 && lba < dev->sector_count &&
+           count <= dev->sector_count - lba;
+}
+
+int blkdev_read(blkdev_t *dev, uint32_t lba, uint32_t count, void *buf) {
+    if (!blkdev_check_range(dev, lba, count) || !dev->ops->read) {
+        return -1;
+    }
+
+    trace(TRACE_BLOCK_IO, lba, count);
+    int ret = dev->ops->read(dev, lba, count, buf);
+    trace(TRACE_BLOCK_DONE, lba, (uint32_t)ret);
+    return ret;
+}
+
+int blkdev_write(blkdev_t *dev, uint32_t lba, uint32_t count, const void *buf) {
+    if (!blkdev_check_range(dev, lba, count) || !dev->ops->write) {
+        return -1;
+    }
+
+    trace(TRACE_BLOCK_IO, lba, count | 0x80000000u);
+    int ret = dev->ops->write(dev, lba, count, buf);
+    trace(TRACE_BLOCK_DONE, lba, (uint32_t)ret);
+    return ret;
+}
+
+int blkdev_flush(blkdev_t *dev) {
+    if (!dev) {
+        return -1;
+    }
+    return dev->ops->flush ? dev->ops->flush(dev) : 0;
+}
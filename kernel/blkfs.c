@@ -0,0 +1,130 @@
+#include <kernel/blkfs.h>
+#include <kernel/bcache.h>
+#include <kernel/blkdev.h>
+#include <kernel/crc32c.h>
+#include <kernel/printk.h>
+#include <kernel/string.h>
+#include <kernel/vfs.h>
+#include <stddef.h>
+
+/* 文件大小是 32 位：超过 4GB 的设备只露出前面按页对齐的部分 */
+#define BLKFS_MAX_SIZE  (0xFFFFFFFFu & ~(VFS_PAGE_SIZE - 1))
+
+static uint32_t blkfs_size(const blkdev_t *dev) {
+    uint32_t limit = BLKFS_MAX_SIZE / BLKDEV_SECTOR_SIZE;
+    return (dev->sector_count > limit ? limit : dev->sector_count) * BLKDEV_SECTOR_SIZE;
+}
+
+/* 根目录下只有设备文件，名字就是块设备名 */
+static int blkfs_lookup(vfs_inode_t *dir, const char *name, uint32_t len,
+                        vfs_inode_t *child) {
+    (void)dir;
+    for (uint32_t i = 0; ; i++) {
+        blkdev_t *dev = blkdev_get_index(i);
+        if (!dev) {
+            return -1;
+        }
+        if (strlen(dev->name) == len && memcmp(dev->name, name, len) == 0) {
+            child->priv = dev;
+            child->type = VFS_FILE;
+            child->size = blkfs_size(dev);
+            child->mode = 0444;
+            child->mtime = 0;
+            return 0;
+        }
+    }
+}
+
+/* 页缓存未命中时从块缓存取数据，顺序读取会触发块缓存的预读 */
+static int blkfs_readpage(vfs_inode_t *inode, uint32_t index, void *buf) {
+    uint32_t offset = index << VFS_PAGE_SHIFT;
+    uint32_t len = VFS_PAGE_SIZE;
+
+    if (offset >= inode->size) {
+        memset(buf, 0, VFS_PAGE_SIZE);
+        return 0;
+    }
+    if (len > inode->size - offset) {
+        len = inode->size - offset;
+        memset((uint8_t *)buf + len, 0, VFS_PAGE_SIZE - len);
+    }
+    return bcache_read(inode->priv, offset, buf, len);
+}
+
+static const vfs_inode_ops_t blkfs_vfs_ops = {
+    .lookup = blkfs_lookup,
+    .readpage = blkfs_readpage,
+};
+
+static const char *blkfs_path = NULL;
+
+int blkfs_mount(const char *path) {
+    if (vfs_mount(path, &blkfs_vfs_ops, NULL) < 0) {
+        return -1;
+    }
+    blkfs_path = path;
+    return 0;
+}
+
+#if CONFIG_BLKFS_SELFTEST
+static uint8_t selftest_buf[VFS_PAGE_SIZE];
+
+/* 从头顺序读 bytes 字节，返回内容的 CRC32C；读不满时 *ok 置 0 */
+static uint32_t selftest_pass(vfs_file_t *file, uint32_t bytes, int *ok) {
+    uint32_t crc = 0;
+    if (vfs_seek(file, 0) < 0) {
+        *ok = 0;
+        return 0;
+    }
+    while (bytes) {
+        uint32_t n = bytes < sizeof(selftest_buf) ? bytes : sizeof(selftest_buf);
+        if (vfs_read(file, selftest_buf, n) != (int)n) {
+            *ok = 0;
+            break;
+        }
+        crc = crc32c(crc, selftest_buf, n);
+        bytes -= n;
+    }
+    return crc;
+}
+
+int blkfs_selftest(void) {
+    blkdev_t *dev = blkdev_get_index(0);
+    if (!dev || !blkfs_path) {
+        return 0;
+    }
+
+    char path[VFS_NAME_MAX + 1];
+    snprintf(path, sizeof(path), "%s/%s", blkfs_path, dev->name);
+    vfs_file_t *file = vfs_open(path);
+    if (!file) {
+        pr_err("blkfs: self-test cannot open %s\n", path);
+        return -1;
+    }
+
+    uint32_t bytes = BLKFS_SELFTEST_BYTES;
+    if (bytes > file->dentry->inode->size) {
+        bytes = file->dentry->inode->size;
+    }
+    uint32_t pages = (bytes + VFS_PAGE_SIZE - 1) >> VFS_PAGE_SHIFT;
+
+    vfs_stats_t s0, s1, s2;
+    int ok = 1;
+    vfs_get_stats(&s0);
+    uint32_t crc1 = selftest_pass(file, bytes, &ok);
+    vfs_get_stats(&s1);
+    uint32_t crc2 = ok ? selftest_pass(file, bytes, &ok) : 0;
+    vfs_get_stats(&s2);
+    vfs_close(file);
+
+    pr_info("blkfs: self-test %s %u KB: pass 1 %u page misses, pass 2 %u page hits, %u misses\n",
+            path, bytes / 1024, s1.p_misses - s0.p_misses, s2.p_hits - s1.p_hits,
+            s2.p_misses - s1.p_misses);
+    if (!ok || crc1 != crc2 || s1.p_misses - s0.p_misses != pages ||
+        s2.p_hits - s1.p_hits != pages) {
+        pr_err("blkfs: self-test failed on %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+#endif
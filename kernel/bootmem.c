@@ -0,0 +1,84 @@
+#include <kernel/bootmem.h>
+#include <kernel/bootmod.h>
+#include <kernel/multiboot.h>
+#include <kernel/paging.h>
+#include <kernel/printk.h>
+#include <stddef.h>
+
+/* 内核映像结束地址（链接脚本） */
+extern uint8_t _end[];
+
+/* 只从一段连续可用内存中顺序分配，启动期用不到更复杂的策略 */
+static uint32_t bootmem_next = 0;
+static uint32_t bootmem_limit = 0;
+
+static inline uint32_t page_round_up(uint32_t x) {
+    return (x + PAGE_SIZE - 1) & PAGE_MASK;
+}
+
+void bootmem_init(uint32_t mb_info_addr) {
+    // 起点：内核映像、Multiboot2 信息结构（之后还要读 ACPI 标签）与所有模块之后
+    uint32_t start = (uint32_t)_end;
+    if (mb_info_addr) {
+        uint32_t mb_end = mb_info_addr + ((multiboot2_info_header_t*)mb_info_addr)->total_size;
+        if (mb_end > start) {
+            start = mb_end;
+        }
+    }
+    for (uint32_t i = 0; bootmod_get(i); i++) {
+        if (bootmod_get(i)->end > start) {
+            start = bootmod_get(i)->end;
+        }
+    }
+    start = page_round_up(start);
+
+    // 找到包含起点的可用内存区域，分配不越过它，也不越过低端恒等映射
+    multiboot_tag_mmap_t* mmap = (multiboot_tag_mmap_t*)multiboot_find_tag(mb_info_addr,
+                                                                          MULTIBOOT_TAG_MMAP);
+    bootmem_next = start;
+    bootmem_limit = start;
+    if (mmap) {
+        uint8_t* p = (uint8_t*)(mmap + 1);
+        uint8_t* end = (uint8_t*)mmap + mmap->header.size;
+        for (; p + sizeof(multiboot_mmap_entry_t) <= end; p += mmap->entry_size) {
+            multiboot_mmap_entry_t* e = (multiboot_mmap_entry_t*)p;
+            if (e->type != MULTIBOOT_MEMORY_AVAILABLE || e->addr > start ||
+                e->addr + e->len <= start) {
+                continue;
+            }
+            uint64_t region_end = e->addr + e->len;
+            bootmem_limit = region_end > USER_BASE ? USER_BASE : (uint32_t)region_end;
+            bootmem_limit &= PAGE_MASK;
+            break;
+        }
+    }
+
+    pr_info("bootmem: 0x%x-0x%x (%u KB)\n", bootmem_next, bootmem_limit,
+            (bootmem_limit - bootmem_next) >> 10);
+}
+
+void *bootmem_alloc(uint32_t size) {
+    size = page_round_up(size);
+    if (size == 0 || size > bootmem_limit - bootmem_next) {
+        return NULL;
+    }
+    // 起点已在所有模块之后，这里只是防御性检查
+    if (bootmod_is_reserved(bootmem_next, size)) {
+        return NULL;
+    }
+
+    void *p = (void *)bootmem_next;
+    bootmem_next += size;
+    return p;
+}
+
+void bootmem_shrink(void *ptr, uint32_t old_size, uint32_t new_size) {
+    // 只有最近一次分配能够归还尾部
+    if ((uint32_t)ptr + page_round_up(old_size) == bootmem_next) {
+        bootmem_next = (uint32_t)ptr + page_round_up(new_size);
+    }
+}
+
+uint32_t bootmem_available(void) {
+    return bootmem_limit - bootmem_next;
+}
@@ -0,0 +1,138 @@
+#include <kernel/bootmod.h>
+#include <kernel/bootmem.h>
+#include <kernel/lz4.h>
+#include <kernel/multiboot.h>
+#include <kernel/paging.h>
+#include <kernel/printk.h>
+#include <kernel/string.h>
+#include <kernel/tsc.h>
+#include <stddef.h>
+
+/* 内核映像结束地址（链接脚本） */
+extern uint8_t _end[];
+
+/* 内核映像起始地址（链接脚本中的 . = 1M） */
+#define KERNEL_IMAGE_START 0x100000
+
+static bootmod_t bootmods[BOOTMOD_MAX];
+static uint32_t bootmod_count = 0;
+
+/* 模块必须完整落在内核恒等映射的低端区域内，且不能与内核映像重叠 */
+static int bootmod_usable(uint32_t start, uint32_t end) {
+    if (end <= start || end > USER_BASE) {
+        return 0;
+    }
+    return end <= KERNEL_IMAGE_START || start >= (uint32_t)_end;
+}
+
+void bootmod_init(uint32_t mb_info_addr) {
+    bootmod_count = 0;
+
+    for (multiboot_tag_header_t* tag = multiboot_next_tag(mb_info_addr, NULL); tag;
+         tag = multiboot_next_tag(mb_info_addr, tag)) {
+        if (tag->type != MULTIBOOT_TAG_MODULE) {
+            continue;
+        }
+
+        multiboot_tag_module_t* mod = (multiboot_tag_module_t*)tag;
+        if (!bootmod_usable(mod->mod_start, mod->mod_end)) {
+            pr_warn("bootmod: ignoring \"%s\" at 0x%x-0x%x\n",
+                    mod->string, mod->mod_start, mod->mod_end);
+            continue;
+        }
+        if (bootmod_count >= BOOTMOD_MAX) {
+            pr_warn("bootmod: too many modules, ignoring \"%s\"\n", mod->string);
+            continue;
+        }
+
+        bootmod_t *m = &bootmods[bootmod_count++];
+        m->start = mod->mod_start;
+        m->end = mod->mod_end;
+        strlcpy(m->name, mod->string, sizeof(m->name));
+        m->data = NULL;
+        m->size = 0;
+        pr_info("bootmod: \"%s\" 0x%x-0x%x (%u KB)\n", m->name, m->start, m->end,
+                (m->end - m->start + 1023) >> 10);
+    }
+}
+
+const bootmod_t *bootmod_find(const char *name) {
+    size_t len = strlen(name);
+    if (len >= BOOTMOD_NAME_LEN) {
+        return NULL;
+    }
+    // name 缓冲区足够长，memcmp 不会越界；再检查词边界
+    for (uint32_t i = 0; i < bootmod_count; i++) {
+        const char *s = bootmods[i].name;
+        if (memcmp(s, name, len) == 0 && (s[len] == '\0' || s[len] == ' ')) {
+            return &bootmods[i];
+        }
+    }
+    return NULL;
+}
+
+/* 把 LZ4 帧解压到新分配的页中，打印解压吞吐量 */
+static int bootmod_decompress(bootmod_t *m) {
+    const void *src = (const void *)m->start;
+    uint32_t len = m->end - m->start;
+
+    // 帧头没有内容大小时按块数估计上界，解压后归还多余的页
+    uint32_t bound = lz4_frame_bound(src, len);
+    void *dst = bound ? bootmem_alloc(bound) : NULL;
+    if (!dst) {
+        pr_err("bootmod: cannot decompress \"%s\" (%u KB needed, %u KB free)\n",
+               m->name, bound >> 10, bootmem_available() >> 10);
+        return -1;
+    }
+
+    uint64_t t0 = rdtsc();
+    int n = lz4_frame_decompress(src, len, dst, bound);
+    uint32_t us = tsc_cycles_to_us(rdtsc() - t0);
+    if (n < 0) {
+        bootmem_shrink(dst, bound, 0);
+        pr_err("bootmod: \"%s\" is not a valid LZ4 frame\n", m->name);
+        return -1;
+    }
+    bootmem_shrink(dst, bound, n);
+
+    // 字节/微秒即 MB/s
+    pr_info("lz4: \"%s\" %u KB -> %u KB in %u us (%u MB/s)\n", m->name,
+            len >> 10, (uint32_t)n >> 10, us, us ? (uint32_t)n / us : 0);
+    m->data = dst;
+    m->size = n;
+    return 0;
+}
+
+const void *bootmod_data(const bootmod_t *mod, uint32_t *size) {
+    bootmod_t *m = &bootmods[mod - bootmods];
+
+    if (!m->data) {
+        if (lz4_is_frame((const void *)m->start, m->end - m->start)) {
+            if (bootmod_decompress(m) < 0) {
+                return NULL;
+            }
+        } else {
+            m->data = (const void *)m->start;
+            m->size = m->end - m->start;
+        }
+    }
+
+    *size = m->size;
+    return m->data;
+}
+
+const bootmod_t *bootmod_get(uint32_t index) {
+    return index < bootmod_count ? &bootmods[index] : NULL;
+}
+
+int bootmod_is_reserved(uint32_t addr, uint32_t size) {
+    for (uint32_t i = 0; i < bootmod_count; i++) {
+        // 按整页保留：模块首尾所在的页都不可再分配
+        uint32_t start = bootmods[i].start & PAGE_MASK;
+        uint32_t end = (bootmods[i].end + PAGE_SIZE - 1) & PAGE_MASK;
+        if (addr < end && addr + size > start) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <kernel/bootprof.h>
+#include <kernel/tsc.h>
+#include <kernel/io.h>
+#include <kernel/string.h>
+
+uint8_t boot_quiet = CONFIG_BOOT_QUIET;
+
+/* 阶段标记：名称 + 开始时的 TSC */
+static struct {
+    const char *name;
+    uint64_t tsc;
+} stages[BOOTPROF_MAX_STAGES + 1];
+
+static int stage_count = 0;
+
+void bootprof_mark(const char *stage) {
+    if (stage_count >= BOOTPROF_MAX_STAGES) {
+        return;
+    }
+    stages[stage_count].name = stage;
+    stages[stage_count].tsc = rdtsc();
+    stage_count++;
+}
+
+/* 右对齐输出数字 */
+static void put_padded(const char *str, int width) {
+    for (int i = strlen(str); i < width; i++) {
+        serial_putc(' ');
+    }
+    serial_puts(str);
+}
+
+void bootprof_report(void) {
+    char buf[16];
+
+    if (stage_count == 0) {
+        return;
+    }
+
+    // 结束时间戳作为最后一个阶段的终点
+    uint64_t end = rdtsc();
+    stages[stage_count].tsc = end;
+
+    uint32_t total_us = tsc_cycles_to_us(end - stages[0].tsc);
+
+    serial_puts("\nBoot profile (tsc ");
+    utoa(tsc_get_khz(), buf, 10);
+    serial_puts(buf);
+    serial_puts(" kHz)\n");
+    serial_puts("  stage                         us      %\n");
+
+    for (int i = 0; i < stage_count; i++) {
+        uint32_t us = tsc_cycles_to_us(stages[i + 1].tsc - stages[i].tsc);
+
+        serial_puts("  ");
+        serial_puts(stages[i].name);
+        for (int pad = strlen(stages[i].name); pad < 24; pad++) {
+            serial_putc(' ');
+        }
+
+        utoa(us, buf, 10);
+        put_padded(buf, 10);
+
+        // 千分比，保留一位小数（总耗时超过 4s 时降低精度以免溢出）
+        uint32_t permille = 0;
+        if (total_us > 4000000) {
+            permille = us / (total_us / 1000);
+        } else if (total_us) {
+            permille = us * 1000 / total_us;
+        }
+        utoa(permille / 10, buf, 10);
+        put_padded(buf, 5);
+        serial_putc('.');
+        utoa(permille % 10, buf, 10);
+        serial_puts(buf);
+        serial_putc('\n');
+    }
+
+    serial_puts("  total                   ");
+    utoa(total_us, buf, 10);
+    put_padded(buf, 10);
+    serial_puts("\n\n");
+}
@@ -0,0 +1,203 @@
+#include <kernel/cirrus.h>
+#include <kernel/io.h>
+#include <kernel/pci.h>
+#include <kernel/printk.h>
+#include <kernel/spinlock.h>
+#include <stddef.h>
+
+/* 等待 BLT 完成的轮询上限 */
+#define CIRRUS_BLT_SPIN 1000000
+
+static graphics_context_t *screen = NULL;   // 只加速屏幕本身（显存偏移 0 起）
+static uint8_t pixel_mode = 0;              // GR30 的像素宽度位
+static spinlock_t blt_lock = SPINLOCK_INIT;
+static uint32_t blt_timeouts = 0;
+
+static inline void gr_write(uint8_t index, uint8_t value) {
+    outb(CIRRUS_GR_INDEX, index);
+    outb(CIRRUS_GR_DATA, value);
+}
+
+static inline uint8_t gr_read(uint8_t index) {
+    outb(CIRRUS_GR_INDEX, index);
+    return inb(CIRRUS_GR_DATA);
+}
+
+static void gr_write16(uint8_t index, uint16_t value) {
+    gr_write(index, value & 0xFF);
+    gr_write(index + 1, value >> 8);
+}
+
+static void gr_write24(uint8_t index, uint32_t value) {
+    gr_write(index, value & 0xFF);
+    gr_write(index + 1, (value >> 8) & 0xFF);
+    gr_write(index + 2, (value >> 16) & 0x3F);
+}
+
+/* 等待引擎空闲；超时时复位引擎，调用者改用 CPU 绘制 */
+static int blt_wait(void) {
+    for (uint32_t spin = CIRRUS_BLT_SPIN; spin; spin--) {
+        if (!(gr_read(CIRRUS_GR_BLT_STATUS) & CIRRUS_BLT_BUSY)) {
+            return 0;
+        }
+    }
+    gr_write(CIRRUS_GR_BLT_STATUS, CIRRUS_BLT_RESET);
+    gr_write(CIRRUS_GR_BLT_STATUS, 0);
+    if (blt_timeouts++ == 0) {
+        pr_warn("cirrus: BitBLT timed out, engine reset\n");
+    }
+    return -1;
+}
+
+static void set_fg_color(uint32_t color) {
+    gr_write(CIRRUS_GR_FG_COLOR0, color & 0xFF);
+    gr_write(0x11, (color >> 8) & 0xFF);
+    gr_write(0x13, (color >> 16) & 0xFF);
+    gr_write(0x15, color >> 24);
+}
+
+static inline uint32_t bytes_per_pixel(const graphics_context_t *ctx) {
+    return ctx->bpp / 8;
+}
+
+static inline uint32_t vram_offset(const graphics_context_t *ctx, uint32_t x, uint32_t y) {
+    return y * ctx->pitch + x * bytes_per_pixel(ctx);
+}
+
+/* 设置目标矩形（宽度以字节计） */
+static int blt_setup(const graphics_context_t *ctx, uint32_t width, uint32_t height) {
+    uint32_t bytes = width * bytes_per_pixel(ctx);
+    if (!bytes || !height || bytes > CIRRUS_BLT_MAX_WIDTH || height > CIRRUS_BLT_MAX_HEIGHT) {
+        return -1;
+    }
+    gr_write16(CIRRUS_GR_BLT_WIDTH, bytes - 1);
+    gr_write16(CIRRUS_GR_BLT_HEIGHT, height - 1);
+    gr_write16(CIRRUS_GR_BLT_DST_PITCH, ctx->pitch);
+    return 0;
+}
+
+/* ========== 加速操作 ========== */
+
+static int cirrus_supports(const graphics_context_t *ctx) {
+    return screen && ctx->framebuffer == screen->framebuffer && ctx->pitch == screen->pitch &&
+           ctx->bpp == screen->bpp;
+}
+
+static int cirrus_fill_rect(graphics_context_t *ctx, uint32_t x, uint32_t y,
+                            uint32_t width, uint32_t height, uint32_t color) {
+    uint32_t flags = spin_lock_irqsave(&blt_lock);
+    int ret = blt_setup(ctx, width, height);
+    if (ret == 0) {
+        // 实心填充：以前景色作为图案做颜色扩展，不需要源数据
+        set_fg_color(color);
+        gr_write24(CIRRUS_GR_BLT_DST_ADDR, vram_offset(ctx, x, y));
+        gr_write(CIRRUS_GR_BLT_MODE,
+                 CIRRUS_BLTMODE_COLOREXPAND | CIRRUS_BLTMODE_PATTERNCOPY | pixel_mode);
+        gr_write(CIRRUS_GR_BLT_MODE_EXT, CIRRUS_BLTMODEEXT_SOLIDFILL);
+        gr_write(CIRRUS_GR_BLT_ROP, CIRRUS_ROP_SRC);
+        gr_write(CIRRUS_GR_BLT_STATUS, CIRRUS_BLT_START);
+        ret = blt_wait();
+    }
+    spin_unlock_irqrestore(&blt_lock, flags);
+    return ret;
+}
+
+static int cirrus_copy_rect(graphics_context_t *ctx, uint32_t dst_x, uint32_t dst_y,
+                            uint32_t src_x, uint32_t src_y, uint32_t width, uint32_t height) {
+    uint32_t dst = vram_offset(ctx, dst_x, dst_y);
+    uint32_t src = vram_offset(ctx, src_x, src_y);
+    uint8_t mode = pixel_mode;
+
+    // 目标在源之后且可能重叠时倒序拷贝：地址指向矩形最后一个字节
+    if (dst > src) {
+        uint32_t last = (height - 1) * ctx->pitch + width * bytes_per_pixel(ctx) - 1;
+        dst += last;
+        src += last;
+        mode |= CIRRUS_BLTMODE_BACKWARDS;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&blt_lock);
+    int ret = blt_setup(ctx, width, height);
+    if (ret == 0) {
+        gr_write16(CIRRUS_GR_BLT_SRC_PITCH, ctx->pitch);
+        gr_write24(CIRRUS_GR_BLT_DST_ADDR, dst);
+        gr_write24(CIRRUS_GR_BLT_SRC_ADDR, src);
+        gr_write(CIRRUS_GR_BLT_MODE, mode);
+        gr_write(CIRRUS_GR_BLT_MODE_EXT, 0);
+        gr_write(CIRRUS_GR_BLT_ROP, CIRRUS_ROP_SRC);
+        gr_write(CIRRUS_GR_BLT_STATUS, CIRRUS_BLT_START);
+        ret = blt_wait();
+    }
+    spin_unlock_irqrestore(&blt_lock, flags);
+    return ret;
+}
+
+static int cirrus_expand_mono(graphics_context_t *ctx, uint32_t x, uint32_t y,
+                              uint32_t width, uint32_t height, const uint8_t *bits,
+                              uint32_t color) {
+    uint32_t flags = spin_lock_irqsave(&blt_lock);
+    int ret = blt_setup(ctx, width, height);
+    if (ret == 0) {
+        // 透明颜色扩展：位图由 CPU 逐字节写入 BLT 数据口（线性帧缓冲窗口），
+        // 每行 (width + 7) / 8 字节紧密排列；地址递增，写合并不会把字节合并掉
+        set_fg_color(color);
+        gr_write24(CIRRUS_GR_BLT_DST_ADDR, vram_offset(ctx, x, y));
+        gr_write(CIRRUS_GR_BLT_MODE, CIRRUS_BLTMODE_COLOREXPAND | CIRRUS_BLTMODE_MEMSYSSRC |
+                                     CIRRUS_BLTMODE_TRANSPARENT | pixel_mode);
+        gr_write(CIRRUS_GR_BLT_MODE_EXT, 0);
+        gr_write(CIRRUS_GR_BLT_ROP, CIRRUS_ROP_SRC);
+        gr_write(CIRRUS_GR_BLT_STATUS, CIRRUS_BLT_START);
+
+        volatile uint8_t *port = (volatile uint8_t *)screen->framebuffer;
+        uint32_t count = ((width + 7) / 8) * height;
+        for (uint32_t i = 0; i < count; i++) {
+            port[i] = bits[i];
+        }
+        ret = blt_wait();
+    }
+    spin_unlock_irqrestore(&blt_lock, flags);
+    return ret;
+}
+
+static const graphics_ops_t cirrus_ops = {
+    .name = "cirrus",
+    .supports = cirrus_supports,
+    .fill_rect = cirrus_fill_rect,
+    .copy_rect = cirrus_copy_rect,
+    .expand_mono = cirrus_expand_mono,
+};
+
+int cirrus_init(graphics_context_t *ctx) {
+    pci_device_t *pdev = pci_find_device(CIRRUS_VENDOR_ID, CIRRUS_DEVICE_GD5446, 0);
+    if (!pdev) {
+        return -1;
+    }
+
+    // 帧缓冲必须就是 BAR0（线性显存）的起点，BLT 地址才等于屏幕偏移
+    if ((pdev->bar[0] & ~0xFu) != (uint32_t)ctx->framebuffer) {
+        pr_warn("cirrus: framebuffer 0x%x is not BAR0 0x%x, acceleration disabled\n",
+                (uint32_t)ctx->framebuffer, pdev->bar[0] & ~0xFu);
+        return -1;
+    }
+    switch (ctx->bpp) {
+        case 8:  pixel_mode = CIRRUS_BLTMODE_PIXELWIDTH8; break;
+        case 16: pixel_mode = CIRRUS_BLTMODE_PIXELWIDTH16; break;
+        case 24: pixel_mode = CIRRUS_BLTMODE_PIXELWIDTH24; break;
+        case 32: pixel_mode = CIRRUS_BLTMODE_PIXELWIDTH32; break;
+        default: return -1;
+    }
+    if (ctx->pitch * ctx->height > CIRRUS_BLT_ADDR_MASK + 1) {
+        return -1;
+    }
+
+    spin_lock_init(&blt_lock, "cirrus_blt");
+    outb(CIRRUS_SEQ_INDEX, 0x06);
+    outb(CIRRUS_SEQ_DATA, CIRRUS_SR6_UNLOCK);
+    gr_write(CIRRUS_GR_BLT_STATUS, CIRRUS_BLT_RESET);
+    gr_write(CIRRUS_GR_BLT_STATUS, 0);
+
+    screen = ctx;
+    graphics_set_ops(&cirrus_ops);
+    pr_info("cirrus: GD5446 BitBLT enabled for %ux%ux%u\n", ctx->width, ctx->height, ctx->bpp);
+    return 0;
+}
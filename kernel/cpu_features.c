@@ -0,0 +1,178 @@
+#include <kernel/cpu_features.h>
+#include <kernel/string.h>
+#include <kernel/graphics.h>
+#include <kernel/crc32c.h>
+#include <kernel/fpu.h>
+#include <kernel/io.h>
+#include <kernel/bootprof.h>
+#include <kernel/printk.h>
+
+/* CPUID.1:EDX */
+#define ID1_EDX_FPU     (1u << 0)
+#define ID1_EDX_PSE     (1u << 3)
+#define ID1_EDX_TSC     (1u << 4)
+#define ID1_EDX_MSR     (1u << 5)
+#define ID1_EDX_APIC    (1u << 9)
+#define ID1_EDX_SEP     (1u << 11)
+#define ID1_EDX_PAT     (1u << 16)
+#define ID1_EDX_FXSR    (1u << 24)
+#define ID1_EDX_SSE     (1u << 25)
+#define ID1_EDX_SSE2    (1u << 26)
+/* CPUID.1:ECX */
+#define ID1_ECX_SSE3    (1u << 0)
+#define ID1_ECX_SSSE3   (1u << 9)
+#define ID1_ECX_SSE41   (1u << 19)
+#define ID1_ECX_SSE42   (1u << 20)
+#define ID1_ECX_X2APIC  (1u << 21)
+#define ID1_ECX_AVX     (1u << 28)
+/* CPUID.7.0:EBX */
+#define ID7_EBX_ERMS    (1u << 9)
+/* CPUID.80000007:EDX */
+#define IDX7_EDX_INVTSC (1u << 8)
+
+cpu_info_t cpu_info;
+uint32_t cpu_feature_bits = 0;
+
+/* 在 cpu_dispatch_init 之前使用的通用实现 */
+cpu_dispatch_t cpu_dispatch = {
+    .memcpy = memcpy_rep_movsd,
+    .fill_span = fill_span_generic,
+    .blend = blend_span_generic,
+    .checksum = crc32c_generic,
+    .memcpy_name = "rep movsd",
+    .fill_span_name = "generic",
+    .blend_name = "generic",
+    .checksum_name = "generic",
+};
+
+static const char *const feature_names[CPU_FEATURE_COUNT] = {
+    [CPU_FEATURE_FPU] = "fpu",
+    [CPU_FEATURE_PSE] = "pse",
+    [CPU_FEATURE_TSC] = "tsc",
+    [CPU_FEATURE_MSR] = "msr",
+    [CPU_FEATURE_APIC] = "apic",
+    [CPU_FEATURE_SEP] = "sep",
+    [CPU_FEATURE_PAT] = "pat",
+    [CPU_FEATURE_FXSR] = "fxsr",
+    [CPU_FEATURE_SSE] = "sse",
+    [CPU_FEATURE_SSE2] = "sse2",
+    [CPU_FEATURE_SSE3] = "sse3",
+    [CPU_FEATURE_SSSE3] = "ssse3",
+    [CPU_FEATURE_SSE41] = "sse4.1",
+    [CPU_FEATURE_SSE42] = "sse4.2",
+    [CPU_FEATURE_X2APIC] = "x2apic",
+    [CPU_FEATURE_AVX] = "avx",
+    [CPU_FEATURE_ERMS] = "erms",
+    [CPU_FEATURE_INVARIANT_TSC] = "invariant_tsc",
+};
+
+static void set_feature(cpu_feature_t feature, int present) {
+    if (present) {
+        cpu_feature_bits |= 1u << feature;
+    }
+}
+
+void cpu_features_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    cpuid(0, &eax, &ebx, &ecx, &edx);
+    cpu_info.max_leaf = eax;
+    // 厂商字符串按 EBX、EDX、ECX 顺序排列
+    memcpy(cpu_info.vendor, &ebx, 4);
+    memcpy(cpu_info.vendor + 4, &edx, 4);
+    memcpy(cpu_info.vendor + 8, &ecx, 4);
+    cpu_info.vendor[12] = '\0';
+
+    if (cpu_info.max_leaf >= 1) {
+        cpuid(1, &eax, &ebx, &ecx, &edx);
+
+        uint32_t family = (eax >> 8) & 0xF;
+        uint32_t model = (eax >> 4) & 0xF;
+        if (family == 0xF) {
+            family += (eax >> 20) & 0xFF;
+        }
+        if (family == 0x6 || family >= 0xF) {
+            model |= ((eax >> 16) & 0xF) << 4;
+        }
+        cpu_info.family = family;
+        cpu_info.model = model;
+        cpu_info.stepping = eax & 0xF;
+
+        set_feature(CPU_FEATURE_FPU, edx & ID1_EDX_FPU);
+        set_feature(CPU_FEATURE_PSE, edx & ID1_EDX_PSE);
+        set_feature(CPU_FEATURE_TSC, edx & ID1_EDX_TSC);
+        set_feature(CPU_FEATURE_MSR, edx & ID1_EDX_MSR);
+        set_feature(CPU_FEATURE_APIC, edx & ID1_EDX_APIC);
+        // 早期 Pentium Pro（family 6, model < 3, stepping < 3）误报 SEP
+        set_feature(CPU_FEATURE_SEP, (edx & ID1_EDX_SEP) &&
+                    !(family == 6 && model < 3 && cpu_info.stepping < 3));
+        set_feature(CPU_FEATURE_PAT, edx & ID1_EDX_PAT);
+        set_feature(CPU_FEATURE_FXSR, edx & ID1_EDX_FXSR);
+        set_feature(CPU_FEATURE_SSE, edx & ID1_EDX_SSE);
+        set_feature(CPU_FEATURE_SSE2, edx & ID1_EDX_SSE2);
+        set_feature(CPU_FEATURE_SSE3, ecx & ID1_ECX_SSE3);
+        set_feature(CPU_FEATURE_SSSE3, ecx & ID1_ECX_SSSE3);
+        set_feature(CPU_FEATURE_SSE41, ecx & ID1_ECX_SSE41);
+        set_feature(CPU_FEATURE_SSE42, ecx & ID1_ECX_SSE42);
+        set_feature(CPU_FEATURE_X2APIC, ecx & ID1_ECX_X2APIC);
+        set_feature(CPU_FEATURE_AVX, ecx & ID1_ECX_AVX);
+    }
+
+    if (cpu_info.max_leaf >= 7) {
+        cpuid(7, &eax, &ebx, &ecx, &edx);
+        set_feature(CPU_FEATURE_ERMS, ebx & ID7_EBX_ERMS);
+    }
+
+    cpuid(0x80000000, &eax, &ebx, &ecx, &edx);
+    cpu_info.max_ext_leaf = eax;
+    if (cpu_info.max_ext_leaf >= 0x80000007) {
+        cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        set_feature(CPU_FEATURE_INVARIANT_TSC, edx & IDX7_EDX_INVTSC);
+    }
+}
+
+void cpu_dispatch_init(void) {
+    // 使用 XMM 寄存器的实现还需要 fpu_init 开启 CR4.OSFXSR
+    int sse2 = cpu_has(CPU_FEATURE_SSE2) && fpu_sse_enabled();
+
+    if (cpu_has(CPU_FEATURE_ERMS)) {
+        cpu_dispatch.memcpy = memcpy_rep_movsb;
+        cpu_dispatch.memcpy_name = "rep movsb (erms)";
+    }
+
+    if (sse2) {
+        cpu_dispatch.fill_span = fill_span_sse2;
+        cpu_dispatch.fill_span_name = "sse2";
+        cpu_dispatch.blend = blend_span_sse2;
+        cpu_dispatch.blend_name = "sse2";
+    } else {
+        cpu_dispatch.fill_span = fill_span_stosd;
+        cpu_dispatch.fill_span_name = "rep stosd";
+    }
+
+    // crc32 指令不使用 XMM 寄存器，不依赖 FPU 状态
+    if (cpu_has(CPU_FEATURE_SSE42)) {
+        cpu_dispatch.checksum = crc32c_sse42;
+        cpu_dispatch.checksum_name = "sse4.2 crc32";
+    }
+}
+
+void cpu_features_report(void) {
+    if (boot_quiet) {
+        return;
+    }
+
+    pr_info("CPU: %s family %xh model %xh stepping %u\n",
+            cpu_info.vendor, cpu_info.family, cpu_info.model, cpu_info.stepping);
+    // 特性列表分多次追加，printk 在换行时整行输出
+    pr_info("CPU features:");
+    for (int i = 0; i < CPU_FEATURE_COUNT; i++) {
+        if (cpu_has((cpu_feature_t)i)) {
+            pr_info(" %s", feature_names[i]);
+        }
+    }
+    pr_info("\n");
+    pr_info("Dispatch: memcpy=%s fill_span=%s blend=%s checksum=%s\n",
+            cpu_dispatch.memcpy_name, cpu_dispatch.fill_span_name,
+            cpu_dispatch.blend_name, cpu_dispatch.checksum_name);
+}
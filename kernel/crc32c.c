@@ -0,0 +1,43 @@
+#include <kernel/crc32c.h>
+
+/* 反射多项式 0x82F63B78 的半字节查表：比逐位快，又不需要运行时生成 1KB 的整字节表 */
+static const uint32_t crc32c_nibble[16] = {
+    0x00000000, 0x105EC76F, 0x20BD8EDE, 0x30E349B1,
+    0x417B1DBC, 0x5125DAD3, 0x61C69362, 0x7198540D,
+    0x82F63B78, 0x92A8FC17, 0xA24BB5A6, 0xB21572C9,
+    0xC38D26C4, 0xD3D3E1AB, 0xE330A81A, 0xF36E6F75,
+};
+
+uint32_t crc32c_generic(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ crc32c_nibble[crc & 0xF];
+        crc = (crc >> 4) ^ crc32c_nibble[crc & 0xF];
+    }
+    return ~crc;
+}
+
+/* SSE4.2 crc32 指令：每次处理 4 字节 */
+uint32_t crc32c_sse42(uint32_t crc, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (len && ((uintptr_t)p & 3)) {
+        asm("crc32b %1, %0" : "+r"(crc) : "m"(*p));
+        p++;
+        len--;
+    }
+    while (len >= 4) {
+        asm("crc32l %1, %0" : "+r"(crc) : "m"(*(const uint32_t *)p));
+        p += 4;
+        len -= 4;
+    }
+    while (len--) {
+        asm("crc32b %1, %0" : "+r"(crc) : "m"(*p));
+        p++;
+    }
+    return ~crc;
+}
@@ -0,0 +1,116 @@
+#include <kernel/event.h>
+#include <kernel/waitqueue.h>
+#include <kernel/io.h>
+#include <kernel/timer.h>
+#include <kernel/string.h>
+#include <stddef.h>
+
+typedef struct {
+    const char *name;
+    event_handler_t handler;
+    uint32_t period;            // 周期（tick），0 表示非周期事件
+    uint32_t next_tick;         // 下一次触发的 tick
+    uint32_t signaled;          // 触发次数（合并前）
+    uint32_t dispatched;        // 处理函数调用次数
+} event_slot_t;
+
+static event_slot_t events[EVENT_COUNT];
+static volatile uint32_t event_pending = 0;
+static volatile uint32_t periodic_mask = 0;
+static waitqueue_t event_wq;
+
+void event_init(void) {
+    memset(events, 0, sizeof(events));
+    event_pending = 0;
+    periodic_mask = 0;
+    wait_queue_init(&event_wq, "event_wq");
+}
+
+void event_register(event_id_t id, const char *name, event_handler_t handler) {
+    if (id >= EVENT_COUNT) {
+        return;
+    }
+    events[id].name = name;
+    events[id].handler = handler;
+}
+
+void event_signal(event_id_t id) {
+    if (id >= EVENT_COUNT) {
+        return;
+    }
+    __atomic_fetch_add(&events[id].signaled, 1, __ATOMIC_RELAXED);
+
+    // 事件已在等待处理时合并，无需重复唤醒
+    uint32_t old = __atomic_fetch_or(&event_pending, 1u << id, __ATOMIC_RELEASE);
+    if (old == 0) {
+        wait_queue_wake_all(&event_wq);
+    }
+}
+
+void event_set_periodic(event_id_t id, uint32_t period) {
+    if (id >= EVENT_COUNT) {
+        return;
+    }
+    uint32_t flags = irq_save();
+    events[id].period = period;
+    events[id].next_tick = timer_get_ticks() + period;
+    if (period) {
+        periodic_mask |= 1u << id;
+    } else {
+        periodic_mask &= ~(1u << id);
+    }
+    irq_restore(flags);
+}
+
+void event_timer_tick(uint32_t now) {
+    uint32_t mask = periodic_mask;
+
+    while (mask) {
+        uint32_t id = __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        event_slot_t *ev = &events[id];
+        if ((int32_t)(now - ev->next_tick) >= 0) {
+            ev->next_tick = now + ev->period;
+            event_signal((event_id_t)id);
+        }
+    }
+}
+
+void event_loop(void) {
+    while (1) {
+        wait_event(&event_wq, event_pending != 0);
+
+        // 一次取走所有待处理事件，处理期间的新事件留到下一轮
+        uint32_t mask = __atomic_exchange_n(&event_pending, 0, __ATOMIC_ACQUIRE);
+        while (mask) {
+            uint32_t id = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            if (events[id].handler) {
+                events[id].dispatched++;
+                events[id].handler();
+            }
+        }
+    }
+}
+
+void event_report(void) {
+    char buf[16];
+
+    serial_puts("\n=== Event statistics ===\n");
+    for (uint32_t id = 0; id < EVENT_COUNT; id++) {
+        if (!events[id].name) {
+            continue;
+        }
+        serial_puts(events[id].name);
+        serial_puts(": signaled ");
+        utoa(events[id].signaled, buf, 10);
+        serial_puts(buf);
+        serial_puts(", dispatched ");
+        utoa(events[id].dispatched, buf, 10);
+        serial_puts(buf);
+        serial_puts("\n");
+    }
+    serial_puts("========================\n");
+}
@@ -0,0 +1,219 @@
+#include <kernel/fpu.h>
+#include <kernel/percpu.h>
+#include <kernel/process.h>
+#include <kernel/idt.h>
+#include <kernel/io.h>
+#include <kernel/cpu_features.h>
+#include <kernel/bootprof.h>
+#include <stddef.h>
+
+#define CR0_MP          0x00000002
+#define CR0_EM          0x00000004
+#define CR0_TS          0x00000008
+#define CR0_NE          0x00000020
+#define CR4_OSFXSR      0x00000200
+#define CR4_OSXMMEXCPT  0x00000400
+
+/* 异常向量 */
+#define VEC_NM 7                // 设备不可用
+#define VEC_MF 16               // x87 浮点异常
+#define VEC_XM 19               // SIMD 浮点异常
+
+static uint8_t fpu_present = 0;
+static uint8_t fpu_fxsr = 0;            // 使用 FXSAVE/FXRSTOR（否则 FNSAVE/FRSTOR）
+static uint8_t fpu_sse = 0;
+static uint8_t fpu_lazy = 0;            // 已开启惰性保存
+static uint32_t fpu_switches = 0;
+
+/* fninit 之后的干净状态，线程第一次使用 FPU 时载入 */
+static uint8_t fpu_initial_state[THREAD_FPU_STATE_SIZE] __attribute__((aligned(16)));
+
+static inline uint32_t read_cr0(void) {
+    uint32_t cr0;
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    return cr0;
+}
+
+static inline void write_cr0(uint32_t cr0) {
+    asm volatile("mov %0, %%cr0" : : "r"(cr0) : "memory");
+}
+
+static inline void clts(void) {
+    asm volatile("clts");
+}
+
+static inline void stts(void) {
+    write_cr0(read_cr0() | CR0_TS);
+}
+
+static void fpu_save(uint8_t *area) {
+    if (fpu_fxsr) {
+        asm volatile("fxsave (%0)" : : "r"(area) : "memory");
+    } else {
+        // fnsave 会重新初始化 FPU，调用方随后总是载入另一份状态
+        asm volatile("fnsave (%0)" : : "r"(area) : "memory");
+    }
+}
+
+static void fpu_restore(const uint8_t *area) {
+    if (fpu_fxsr) {
+        asm volatile("fxrstor (%0)" : : "r"(area) : "memory");
+    } else {
+        asm volatile("frstor (%0)" : : "r"(area) : "memory");
+    }
+}
+
+/* 设置当前 CPU 的 CR0/CR4 并初始化 FPU */
+static void fpu_setup_cpu(void) {
+    uint32_t cr0 = read_cr0();
+    cr0 &= ~(CR0_EM | CR0_TS);
+    cr0 |= CR0_MP | CR0_NE;
+    write_cr0(cr0);
+
+    if (fpu_sse) {
+        uint32_t cr4;
+        asm volatile("mov %%cr4, %0" : "=r"(cr4));
+        asm volatile("mov %0, %%cr4" : : "r"(cr4 | CR4_OSFXSR | CR4_OSXMMEXCPT));
+    }
+
+    asm volatile("fninit");
+}
+
+void fpu_init(void) {
+    fpu_present = cpu_has(CPU_FEATURE_FPU);
+    if (!fpu_present) {
+        return;
+    }
+    fpu_fxsr = cpu_has(CPU_FEATURE_FXSR);
+    fpu_sse = fpu_fxsr && cpu_has(CPU_FEATURE_SSE);
+
+    fpu_setup_cpu();
+
+    // 保存复位后的状态（FXSAVE 同时包含 MXCSR 的默认值 0x1F80）
+    fpu_save(fpu_initial_state);
+
+    if (!boot_quiet) {
+        serial_puts("FPU: x87");
+        serial_puts(fpu_fxsr ? " + FXSR" : "");
+        serial_puts(fpu_sse ? " + SSE" : "");
+        serial_puts(", lazy context switch\n");
+    }
+}
+
+void fpu_init_ap(void) {
+    if (!fpu_present) {
+        return;
+    }
+    fpu_setup_cpu();
+
+    // AP 的空闲线程不持有 FPU，第一个使用者通过 #NM 载入自己的状态
+    this_cpu()->fpu_owner = NULL;
+    if (fpu_lazy) {
+        stts();
+    }
+}
+
+int fpu_sse_enabled(void) {
+    return fpu_sse;
+}
+
+/* #NM：把 FPU 寄存器交给当前线程 */
+static void fpu_nm_handler(struct registers *regs) {
+    cpu_t *cpu = this_cpu();
+    thread_t *cur = cpu->current;
+
+    (void)regs;
+    clts();
+    if (cpu->fpu_owner == cur) {
+        return;
+    }
+
+    if (cpu->fpu_owner) {
+        fpu_save(cpu->fpu_owner->fpu_state);
+    }
+    if (cur->fpu_used) {
+        fpu_restore(cur->fpu_state);
+    } else {
+        fpu_restore(fpu_initial_state);
+        cur->fpu_used = 1;
+    }
+    cpu->fpu_owner = cur;
+    __atomic_fetch_add(&fpu_switches, 1, __ATOMIC_RELAXED);
+}
+
+/* #MF / #XM：用户态只终止该进程，内核态停机 */
+static void fpu_exception_handler(struct registers *regs) {
+    const char *what = regs->int_no == VEC_MF ? "x87 FPU exception" : "SIMD exception";
+
+    process_handle_fault(regs, what);
+
+    serial_puts("\n!!! ");
+    serial_puts(what);
+    serial_puts(" in kernel !!!\nSystem halted.\n");
+    serial_flush();
+    asm volatile("cli\n" "hlt");
+}
+
+void fpu_enable_lazy(void) {
+    if (!fpu_present) {
+        return;
+    }
+
+    register_interrupt_handler(VEC_NM, fpu_nm_handler);
+    register_interrupt_handler(VEC_MF, fpu_exception_handler);
+    register_interrupt_handler(VEC_XM, fpu_exception_handler);
+
+    // 启动阶段的 FPU 状态属于主线程
+    uint32_t flags = irq_save();
+    cpu_t *cpu = this_cpu();
+    cpu->fpu_owner = cpu->current;
+    cpu->current->fpu_used = 1;
+    fpu_lazy = 1;
+    irq_restore(flags);
+}
+
+void fpu_switch(thread_t *next) {
+    if (!fpu_lazy) {
+        return;
+    }
+
+    // 只有寄存器中的状态属于 next 时才允许直接使用，否则第一次 SIMD 指令触发 #NM
+    uint32_t cr0 = read_cr0();
+    uint32_t want = next == this_cpu()->fpu_owner ? 0 : CR0_TS;
+    if ((cr0 & CR0_TS) != want) {
+        write_cr0((cr0 & ~CR0_TS) | want);
+    }
+}
+
+void fpu_thread_exit(thread_t *t) {
+    cpu_t *cpu = this_cpu();
+    if (cpu->fpu_owner == t) {
+        cpu->fpu_owner = NULL;
+    }
+}
+
+uint32_t kernel_fpu_begin(void) {
+    uint32_t flags = irq_save();
+
+    if (fpu_lazy) {
+        cpu_t *cpu = this_cpu();
+        clts();
+        if (cpu->fpu_owner) {
+            fpu_save(cpu->fpu_owner->fpu_state);
+            cpu->fpu_owner = NULL;
+        }
+    }
+    return flags;
+}
+
+void kernel_fpu_end(uint32_t flags) {
+    // 寄存器内容已不属于任何线程，下一次使用重新触发 #NM
+    if (fpu_lazy) {
+        stts();
+    }
+    irq_restore(flags);
+}
+
+uint32_t fpu_get_switch_count(void) {
+    return fpu_switches;
+}
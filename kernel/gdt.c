@@ -1,17 +1,24 @@
 #include "kernel/gdt.h"
+#include "kernel/io.h"
+#include "kernel/string.h"
+#include "kernel/percpu.h"
 #include <stddef.h>
 
-// GDT 表
-static struct gdt_entry gdt[6];
-static struct gdt_ptr gp;
+// 每个 CPU 一份 GDT：TSS 与每 CPU 数据段的基址各不相同
+#define GDT_ENTRIES 7
+static struct gdt_entry gdt[MAX_CPUS][GDT_ENTRIES];
+static struct gdt_ptr gp[MAX_CPUS];
+
+// 每个 CPU 的任务状态段
+static struct tss_entry tss[MAX_CPUS];
 
 // 外部汇编函数声明
 extern void gdt_flush(uint32_t);
 
 // 设置单个GDT条目
-void gdt_set_entry(int index, uint32_t base, uint32_t limit, 
+void gdt_set_entry(uint32_t cpu, int index, uint32_t base, uint32_t limit, 
                    uint8_t access, uint8_t flags) {
-    struct gdt_entry *entry = &gdt[index];
+    struct gdt_entry *entry = &gdt[cpu][index];
     
     // 设置段基址
     entry->base_low = (base & 0xFFFF);
@@ -28,48 +35,74 @@ void gdt_set_entry(int index, uint32_t base, uint32_t limit,
     entry->access = access;
 }
 
-// 初始化 GDT
+// 初始化 BSP 的 GDT
 void gdt_init(void) {
+    gdt_init_cpu(0);
+}
+
+// 初始化并加载指定 CPU 的 GDT（在该 CPU 上调用）
+void gdt_init_cpu(uint32_t cpu) {
     // 设置 GDT 指针
-    gp.limit = (sizeof(struct gdt_entry) * 6) - 1;
-    gp.base = (uint32_t)&gdt;
+    gp[cpu].limit = (sizeof(struct gdt_entry) * GDT_ENTRIES) - 1;
+    gp[cpu].base = (uint32_t)&gdt[cpu];
     
     // 空描述符（索引 0，必须为0）
-    gdt_set_entry(0, 0, 0, 0, 0);
+    gdt_set_entry(cpu, 0, 0, 0, 0, 0);
     
     // 内核代码段
-    gdt_set_entry(1, 0, 0xFFFFFFFF,
+    gdt_set_entry(cpu, 1, 0, 0xFFFFFFFF,
                   GDT_ACCESS_PRESENT | GDT_ACCESS_CODE_DATA | 
                   GDT_ACCESS_EXECUTABLE | GDT_ACCESS_READ_WRITE,
                   GDT_FLAG_32BIT | GDT_FLAG_4K_GRANULARITY);
     
     // 内核数据段
-    gdt_set_entry(2, 0, 0xFFFFFFFF,
+    gdt_set_entry(cpu, 2, 0, 0xFFFFFFFF,
                   GDT_ACCESS_PRESENT | GDT_ACCESS_CODE_DATA | 
                   GDT_ACCESS_READ_WRITE,
                   GDT_FLAG_32BIT | GDT_FLAG_4K_GRANULARITY);
     
     // 用户代码段 (DPL = 3)
-    gdt_set_entry(3, 0, 0xFFFFFFFF,
+    gdt_set_entry(cpu, 3, 0, 0xFFFFFFFF,
                   GDT_ACCESS_PRESENT | GDT_ACCESS_CODE_DATA | 
                   GDT_ACCESS_EXECUTABLE | GDT_ACCESS_READ_WRITE | 
                   GDT_ACCESS_PRIV_USER,
                   GDT_FLAG_32BIT | GDT_FLAG_4K_GRANULARITY);
     
     // 用户数据段 (DPL = 3)
-    gdt_set_entry(4, 0, 0xFFFFFFFF,
+    gdt_set_entry(cpu, 4, 0, 0xFFFFFFFF,
                   GDT_ACCESS_PRESENT | GDT_ACCESS_CODE_DATA | 
                   GDT_ACCESS_READ_WRITE | GDT_ACCESS_PRIV_USER,
                   GDT_FLAG_32BIT | GDT_FLAG_4K_GRANULARITY);
     
+    // 任务状态段（字节粒度）
+    memset(&tss[cpu], 0, sizeof(struct tss_entry));
+    tss[cpu].ss0 = KERNEL_DATA_SEG;
+    tss[cpu].iomap_base = sizeof(struct tss_entry);
+    gdt_set_entry(cpu, 5, (uint32_t)&tss[cpu], sizeof(struct tss_entry) - 1,
+                  GDT_ACCESS_PRESENT | GDT_ACCESS_TSS_32, 0);
+    
+    // 每 CPU 数据段（字节粒度），GS 指向 cpus[cpu]
+    gdt_set_entry(cpu, 6, (uint32_t)&cpus[cpu], sizeof(cpu_t) - 1,
+                  GDT_ACCESS_PRESENT | GDT_ACCESS_CODE_DATA |
+                  GDT_ACCESS_READ_WRITE,
+                  GDT_FLAG_32BIT);
+    
     // 加载新的GDT
-    gdt_load();
+    gdt_load(cpu);
+    
+    // 加载任务寄存器
+    asm volatile("ltr %%ax" : : "a"(TSS_SEG));
+}
+
+// 设置特权级切换时使用的内核栈
+void tss_set_kernel_stack(uint32_t esp0) {
+    tss[this_cpu()->id].esp0 = esp0;
 }
 
 // 加载 GDT 并刷新段寄存器
-void gdt_load(void) {
+void gdt_load(uint32_t cpu) {
     // 加载 GDTR 寄存器
-    asm volatile("lgdt %0" : : "m"(gp));
+    asm volatile("lgdt %0" : : "m"(gp[cpu]));
     
     // 重新加载段选择子
     asm volatile(
@@ -77,11 +110,14 @@ void gdt_load(void) {
         "movw %%ax, %%ds\n"
         "movw %%ax, %%es\n"
         "movw %%ax, %%fs\n"
-        "movw %%ax, %%gs\n"
         "movw %%ax, %%ss\n"
+        "movw $0x30, %%ax\n"   // 每 CPU 数据段选择子
+        "movw %%ax, %%gs\n"
         "ljmp $0x08, $1f\n"    // 远跳转刷新CS
         "1:\n"
         : : : "eax"
     );
-    serial_puts("GDT loaded successfully\n");
+    if (cpu == 0) {
+        serial_puts("GDT loaded successfully\n");
+    }
 }
\ No newline at end of file
@@ -1,8 +1,18 @@
 #include <kernel/graphics.h>
 #include <kernel/font.h>
+#include <kernel/cpu_features.h>
+#include <kernel/string.h>
 
-#define NULL ((void*)0)
 static graphics_context_t* current_ctx = NULL;
+static const graphics_ops_t* accel_ops = NULL;
+
+void graphics_set_ops(const graphics_ops_t* ops) {
+    accel_ops = ops;
+}
+
+const graphics_ops_t* graphics_accel(const graphics_context_t* ctx) {
+    return (accel_ops && ctx && accel_ops->supports(ctx)) ? accel_ops : NULL;
+}
 
 /* 内部像素绘制函数 */
 void put_pixel(uint32_t x, uint32_t y, uint32_t yor) {
@@ -50,24 +60,64 @@ void graphics_draw_pixel(graphics_context_t* ctx, int x, int y, uint32_t color)
 void graphics_clear_screen(graphics_context_t* ctx, uint32_t yor) {
     if (!ctx) return;
     current_ctx = ctx;
+
+    const graphics_ops_t* ops = graphics_accel(ctx);
+    if (ops && ops->fill_rect(ctx, 0, 0, ctx->width, ctx->height, yor) == 0) {
+        return;
+    }
     
+    uint32_t* row = ctx->framebuffer;
     for (uint32_t y = 0; y < ctx->height; y++) {
-        for (uint32_t x = 0; x < ctx->width; x++) {
-            put_pixel(x, y, yor);
-        }
+        cpu_dispatch.fill_span(row, yor, ctx->width);
+        row += ctx->pitch / 4;
     }
 }
 
 /* 绘制矩形 */
 void graphics_draw_rect(graphics_context_t* ctx, uint32_t x, uint32_t y, 
                         uint32_t width, uint32_t height, uint32_t yor) {
-    if (!ctx) return;
+    if (!ctx || x >= ctx->width || y >= ctx->height) return;
     current_ctx = ctx;
-    
+
+    if (width > ctx->width - x) width = ctx->width - x;
+    if (height > ctx->height - y) height = ctx->height - y;
+
+    const graphics_ops_t* ops = graphics_accel(ctx);
+    if (ops && ops->fill_rect(ctx, x, y, width, height, yor) == 0) {
+        return;
+    }
+
+    uint32_t* row = ctx->framebuffer + y * (ctx->pitch / 4) + x;
     for (uint32_t i = 0; i < height; i++) {
-        for (uint32_t j = 0; j < width; j++) {
-            put_pixel(x + j, y + i, yor);
-        }
+        cpu_dispatch.fill_span(row, yor, width);
+        row += ctx->pitch / 4;
+    }
+}
+
+/* 屏幕内矩形拷贝 */
+void graphics_copy_rect(graphics_context_t* ctx, uint32_t dst_x, uint32_t dst_y,
+                        uint32_t src_x, uint32_t src_y, uint32_t width, uint32_t height) {
+    if (!ctx || dst_x >= ctx->width || dst_y >= ctx->height ||
+        src_x >= ctx->width || src_y >= ctx->height) return;
+
+    uint32_t max_x = dst_x > src_x ? dst_x : src_x;
+    uint32_t max_y = dst_y > src_y ? dst_y : src_y;
+    if (width > ctx->width - max_x) width = ctx->width - max_x;
+    if (height > ctx->height - max_y) height = ctx->height - max_y;
+    if (!width || !height) return;
+
+    const graphics_ops_t* ops = graphics_accel(ctx);
+    if (ops && ops->copy_rect(ctx, dst_x, dst_y, src_x, src_y, width, height) == 0) {
+        return;
+    }
+
+    // 目标在源下方时自底向上拷贝，避免覆盖尚未读取的源行；行内重叠由 memmove 处理
+    uint32_t bytes = width * (ctx->bpp / 8);
+    uint8_t* base = (uint8_t*)ctx->framebuffer;
+    for (uint32_t i = 0; i < height; i++) {
+        uint32_t row = (dst_y > src_y) ? height - 1 - i : i;
+        memmove(base + (dst_y + row) * ctx->pitch + dst_x * (ctx->bpp / 8),
+                base + (src_y + row) * ctx->pitch + src_x * (ctx->bpp / 8), bytes);
     }
 }
 
@@ -122,6 +172,14 @@ void graphics_draw_char(graphics_context_t* ctx, uint32_t x, uint32_t y,
                        char c, uint32_t yor) {
     if (!ctx) return;
     current_ctx = ctx;
+
+    // 完全在屏幕内的字符交给颜色扩展（字形位图每行一个字节，正好是扩展的源格式）
+    const graphics_ops_t* ops = graphics_accel(ctx);
+    if (ops && x + FONT_WIDTH <= ctx->width && y + FONT_HEIGHT <= ctx->height &&
+        ops->expand_mono(ctx, x, y, FONT_WIDTH, FONT_HEIGHT,
+                         font_data[(uint8_t)c & 0x7F], yor) == 0) {
+        return;
+    }
     draw_char(x, y, c, yor);
 }
 
@@ -130,7 +188,22 @@ void graphics_draw_string(graphics_context_t* ctx, uint32_t x, uint32_t y,
                          const char* str, uint32_t yor) {
     if (!ctx) return;
     current_ctx = ctx;
-    draw_string(x, y, str, yor);
+
+    if (!graphics_accel(ctx)) {
+        draw_string(x, y, str, yor);
+        return;
+    }
+    // 与 draw_string 相同的排版，逐字符走加速路径
+    uint32_t cx = x;
+    for (; *str; str++) {
+        if (*str == '\n') {
+            y += FONT_HEIGHT + 2;
+            cx = x;
+        } else {
+            graphics_draw_char(ctx, cx, y, *str, yor);
+            cx += FONT_WIDTH + 1;
+        }
+    }
 }
 
 uint32_t graphics_get_pixel(graphics_context_t* ctx, int x, int y) {
@@ -154,4 +227,144 @@ uint32_t graphics_get_pixel(graphics_context_t* ctx, int x, int y) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+
+/* ---- 行填充 ---- */
+
+void fill_span_generic(uint32_t* dst, uint32_t color, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+void fill_span_stosd(uint32_t* dst, uint32_t color, size_t count) {
+    asm volatile("rep stosl" : "+D"(dst), "+c"(count) : "a"(color) : "memory");
+}
+
+/* 对齐到 16 字节后每次写 64 字节；XMM 状态由 #NM 惰性保存，只能在线程上下文中调用 */
+void fill_span_sse2(uint32_t* dst, uint32_t color, size_t count) {
+    while (count && ((uintptr_t)dst & 15)) {
+        *dst++ = color;
+        count--;
+    }
+
+    size_t blocks = count >> 4;
+    if (blocks) {
+        asm volatile(
+            "movd %2, %%xmm0\n\t"
+            "pshufd $0, %%xmm0, %%xmm0\n\t"
+            "1:\n\t"
+            "movdqa %%xmm0,   (%0)\n\t"
+            "movdqa %%xmm0, 16(%0)\n\t"
+            "movdqa %%xmm0, 32(%0)\n\t"
+            "movdqa %%xmm0, 48(%0)\n\t"
+            "addl $64, %0\n\t"
+            "decl %1\n\t"
+            "jnz 1b"
+            : "+r"(dst), "+r"(blocks)
+            : "r"(color)
+            : "memory");
+    }
+
+    fill_span_generic(dst, color, count & 15);
+}
+
+/* ---- ARGB 源覆盖混合 ---- */
+
+/* x / 255 的精确舍入：x + 128 后加上自身右移 8 位，再右移 8 位（x <= 255 * 255） */
+static inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+void blend_span_generic(uint32_t* dst, const uint32_t* src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t s = src[i];
+        uint32_t a = s >> 24;
+
+        // 完全不透明或完全透明时结果与公式一致，直接跳过计算
+        if (a == 255) {
+            dst[i] = s;
+            continue;
+        }
+        if (a == 0) {
+            continue;
+        }
+
+        uint32_t d = dst[i];
+        uint32_t out = div255(255 * a + (d >> 24) * (255 - a)) << 24;
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t sc = (s >> shift) & 0xFF;
+            uint32_t dc = (d >> shift) & 0xFF;
+            out |= div255(sc * a + dc * (255 - a)) << shift;
+        }
+        dst[i] = out;
+    }
+}
+
+/* 每个 16 位通道：源 alpha 通道替换为 255、常数 255 与舍入偏置 128 */
+static const uint16_t blend_alpha_mask[8] __attribute__((aligned(16))) = {
+    0, 0, 0, 255, 0, 0, 0, 255
+};
+static const uint16_t blend_c255[8] __attribute__((aligned(16))) = {
+    255, 255, 255, 255, 255, 255, 255, 255
+};
+static const uint16_t blend_c128[8] __attribute__((aligned(16))) = {
+    128, 128, 128, 128, 128, 128, 128, 128
+};
+
+/* 每次 4 个像素：展开为 16 位通道后按与通用实现相同的公式计算，结果逐位一致。
+ * 只能在线程上下文中调用 */
+void blend_span_sse2(uint32_t* dst, const uint32_t* src, size_t count) {
+    size_t blocks = count >> 2;
+    if (blocks) {
+        asm volatile(
+            "pxor %%xmm7, %%xmm7\n\t"
+            "1:\n\t"
+            "movdqu (%1), %%xmm0\n\t"
+            "movdqu (%0), %%xmm1\n\t"
+            "movdqa %%xmm0, %%xmm2\n\t"
+            "punpcklbw %%xmm7, %%xmm0\n\t"        // 源像素 0、1
+            "punpckhbw %%xmm7, %%xmm2\n\t"        // 源像素 2、3
+            "movdqa %%xmm1, %%xmm3\n\t"
+            "punpcklbw %%xmm7, %%xmm1\n\t"
+            "punpckhbw %%xmm7, %%xmm3\n\t"
+            "pshuflw $0xFF, %%xmm0, %%xmm4\n\t"   // 把 alpha 广播到像素的四个通道
+            "pshufhw $0xFF, %%xmm4, %%xmm4\n\t"
+            "pshuflw $0xFF, %%xmm2, %%xmm5\n\t"
+            "pshufhw $0xFF, %%xmm5, %%xmm5\n\t"
+            "por %3, %%xmm0\n\t"
+            "por %3, %%xmm2\n\t"
+            "pmullw %%xmm4, %%xmm0\n\t"           // s * a
+            "pmullw %%xmm5, %%xmm2\n\t"
+            "movdqa %4, %%xmm6\n\t"
+            "psubw %%xmm4, %%xmm6\n\t"
+            "pmullw %%xmm6, %%xmm1\n\t"           // d * (255 - a)
+            "movdqa %4, %%xmm6\n\t"
+            "psubw %%xmm5, %%xmm6\n\t"
+            "pmullw %%xmm6, %%xmm3\n\t"
+            "paddw %%xmm1, %%xmm0\n\t"
+            "paddw %%xmm3, %%xmm2\n\t"
+            "paddw %5, %%xmm0\n\t"
+            "paddw %5, %%xmm2\n\t"
+            "movdqa %%xmm0, %%xmm1\n\t"           // (t + (t >> 8)) >> 8
+            "psrlw $8, %%xmm1\n\t"
+            "paddw %%xmm1, %%xmm0\n\t"
+            "psrlw $8, %%xmm0\n\t"
+            "movdqa %%xmm2, %%xmm3\n\t"
+            "psrlw $8, %%xmm3\n\t"
+            "paddw %%xmm3, %%xmm2\n\t"
+            "psrlw $8, %%xmm2\n\t"
+            "packuswb %%xmm2, %%xmm0\n\t"
+            "movdqu %%xmm0, (%0)\n\t"
+            "addl $16, %0\n\t"
+            "addl $16, %1\n\t"
+            "decl %2\n\t"
+            "jnz 1b"
+            : "+r"(dst), "+r"(src), "+r"(blocks)
+            : "m"(blend_alpha_mask), "m"(blend_c255), "m"(blend_c128)
+            : "memory");
+    }
+
+    blend_span_generic(dst, src, count & 3);
+}
@@ -2,6 +2,10 @@
 #include "kernel/gdt.h"
 #include "kernel/pic.h"
 #include "kernel/io.h"
+#include "kernel/trace.h"
+#include "kernel/bootprof.h"
+#include "kernel/thread.h"
+#include "kernel/printk.h"
 #include <stddef.h>
 #include <stdbool.h>
 
@@ -12,6 +16,18 @@ static struct idt_ptr idtp;
 // 中断处理函数指针数组
 static interrupt_handler_t interrupt_handlers[256];
 
+// 共享 IRQ 线上的处理程序链表
+typedef struct irq_shared {
+    irq_shared_handler_t handler;
+    void *dev;
+    struct irq_shared *next;
+} irq_shared_t;
+
+static irq_shared_t irq_shared_pool[IRQ_SHARED_MAX];
+static uint32_t irq_shared_used = 0;
+static irq_shared_t *irq_shared_chain[IRQ_COUNT];
+static uint32_t irq_unhandled[IRQ_COUNT];   // 没有任何设备认领的中断
+
 // 初始化 IDT
 void idt_init(void) {
     // 1. 设置 IDT 指针
@@ -75,10 +91,21 @@ void idt_init(void) {
     idt_set_gate(46, (uint32_t)irq14, KERNEL_CODE_SEG, IDT_FLAG_32BIT_INT);
     idt_set_gate(47, (uint32_t)irq15, KERNEL_CODE_SEG, IDT_FLAG_32BIT_INT);
     
+    // 本地 APIC 向量（定时器、IPI、伪中断）
+    idt_set_gate(239, (uint32_t)isr239, KERNEL_CODE_SEG, IDT_FLAG_32BIT_INT);
+    idt_set_gate(240, (uint32_t)isr240, KERNEL_CODE_SEG, IDT_FLAG_32BIT_INT);
+    idt_set_gate(255, (uint32_t)isr255, KERNEL_CODE_SEG, IDT_FLAG_32BIT_INT);
+    
     // 5. 初始化PIC（8259A）
+    bootprof_mark("pic_init");
     pic_init();
     
     // 6. 加载 IDT
+    idt_load();
+}
+
+// 在当前 CPU 上加载 IDT（所有 CPU 共享同一张表）
+void idt_load(void) {
     asm volatile("lidt %0" : : "m"(idtp));
 }
 
@@ -107,6 +134,50 @@ void register_irq_handler(uint8_t irq, interrupt_handler_t handler) {
     pic_enable_irq(irq);
 }
 
+// 共享线的分发：电平触发时多个设备可能同时拉着线，所有处理程序都要调用
+static void irq_shared_dispatch(struct registers *regs) {
+    uint8_t irq = regs->int_no - IRQ_BASE;
+    int handled = 0;
+
+    for (irq_shared_t *s = irq_shared_chain[irq]; s; s = s->next) {
+        handled |= s->handler(regs, s->dev);
+    }
+    // 没有设备认领：通常是某个设备没有注册处理程序却打开了中断，线会一直触发
+    if (!handled && irq_unhandled[irq]++ == 0) {
+        pr_warn("irq %u: interrupt not claimed by any device\n", irq);
+    }
+}
+
+int register_irq_shared(uint8_t irq, irq_shared_handler_t handler, void *dev) {
+    uint8_t int_no = IRQ_BASE + irq;
+    if (irq >= IRQ_COUNT) {
+        return -1;
+    }
+
+    uint32_t flags = irq_save();
+    if ((interrupt_handlers[int_no] && interrupt_handlers[int_no] != irq_shared_dispatch) ||
+        irq_shared_used >= IRQ_SHARED_MAX) {
+        irq_restore(flags);
+        return -1;
+    }
+
+    // 追加到链尾：先填好表项再挂上，中断处理程序不会看到半个表项
+    irq_shared_t *s = &irq_shared_pool[irq_shared_used++];
+    s->handler = handler;
+    s->dev = dev;
+    s->next = NULL;
+    irq_shared_t **tail = &irq_shared_chain[irq];
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+    *tail = s;
+    interrupt_handlers[int_no] = irq_shared_dispatch;
+    irq_restore(flags);
+
+    pic_enable_irq(irq);
+    return 0;
+}
+
 // 默认中断处理函数
 static void default_handler(struct registers *regs) {
     // 可以在这里显示错误信息
@@ -126,6 +197,10 @@ static void default_handler(struct registers *regs) {
 void isr_handler(struct registers *regs) {
     uint8_t int_no = regs->int_no;
     
+    if (int_no < IDT_EXCEPTION_COUNT) {
+        trace(TRACE_EXCEPTION, int_no, regs->err_code);
+    }
+    
     if (interrupt_handlers[int_no]) {
         interrupt_handlers[int_no](regs);
     } else {
@@ -138,6 +213,8 @@ void isr_handler(struct registers *regs) {
 void irq_handler(struct registers *regs) {
     uint8_t int_no = regs->int_no;
     
+    trace(TRACE_IRQ_ENTER, int_no - IRQ_BASE, 0);
+    
     // 调用处理程序
     if (interrupt_handlers[int_no]) {
         interrupt_handlers[int_no](regs);
@@ -145,4 +222,9 @@ void irq_handler(struct registers *regs) {
     
     // 发送EOI
     pic_send_eoi(int_no - IRQ_BASE);
+    
+    trace(TRACE_IRQ_EXIT, int_no - IRQ_BASE, 0);
+    
+    // EOI 已发送，可以安全地切换到更高优先级的线程
+    thread_preempt();
 }
\ No newline at end of file
@@ -1,33 +1,210 @@
 #include <kernel/io.h>
+#include <kernel/idt.h>
+#include <kernel/spinlock.h>
 
 /* 串口端口 */
 #define COM1 0x3F8
+#define COM1_IRQ 4
+
+/* 16550 寄存器偏移 */
+#define UART_THR 0    // 发送保持寄存器
+#define UART_IER 1    // 中断使能寄存器
+#define UART_IIR 2    // 中断识别寄存器 (读)
+#define UART_FCR 2    // FIFO 控制寄存器 (写)
+#define UART_LCR 3    // 线路控制寄存器
+#define UART_MCR 4    // Modem 控制寄存器
+#define UART_LSR 5    // 线路状态寄存器
+#define UART_MSR 6    // Modem 状态寄存器
+
+#define UART_LSR_THRE 0x20    // 发送保持寄存器空
+#define UART_LSR_TEMT 0x40    // 发送器完全空闲
+#define UART_IER_THRI 0x02    // 发送保持寄存器空中断
+
+/* 16550A 发送 FIFO 深度 */
+#define UART_FIFO_SIZE 16
+
+/* 发送环形缓冲区（大小必须是2的幂） */
+#define SERIAL_TX_BUF_SIZE 4096
+#define SERIAL_TX_BUF_MASK (SERIAL_TX_BUF_SIZE - 1)
+
+static char tx_buf[SERIAL_TX_BUF_SIZE];
+static volatile uint32_t tx_head = 0;      // 写入位置（只增不减）
+static volatile uint32_t tx_tail = 0;      // 读取位置（只增不减）
+static volatile uint8_t tx_busy = 0;       // 正在等待 THRE 中断
+static uint8_t serial_irq_mode = 0;        // 是否已切换到中断驱动
+static uint8_t tx_burst = 1;               // 每次可写入的字节数
+static uint32_t tx_dropped = 0;            // 缓冲区满时丢弃的字节数
+static spinlock_t tx_lock = SPINLOCK_INIT; // 多个 CPU 同时输出时保护缓冲区与 UART
+
+/* 设置波特率（最高 115200） */
+void serial_set_baud(uint32_t baud) {
+    if (baud == 0 || baud > 115200) {
+        baud = 115200;
+    }
+    uint16_t divisor = 115200 / baud;
+
+    uint8_t lcr = inb(COM1 + UART_LCR);
+    outb(COM1 + UART_LCR, lcr | 0x80);          // 启用 DLAB
+    outb(COM1 + 0, divisor & 0xFF);             // 除数低字节
+    outb(COM1 + 1, (divisor >> 8) & 0xFF);      // 除数高字节
+    outb(COM1 + UART_LCR, lcr & ~0x80);         // 关闭 DLAB
+}
 
 /* 初始化串口 */
 void serial_init() {
-    outb(COM1 + 1, 0x00);    // 禁用所有中断
-    outb(COM1 + 3, 0x80);    // 启用 DLAB (设置波特率除数)
-    outb(COM1 + 0, 0x03);    // 设置除数为 3 (lo byte) 38400 波特
-    outb(COM1 + 1, 0x00);    //                  (hi byte)
-    outb(COM1 + 3, 0x03);    // 8位, 无奇偶校验, 一个停止位
-    outb(COM1 + 2, 0xC7);    // 启用 FIFO, 清除, 14字节阈值
-    outb(COM1 + 4, 0x0B);    // IRQ启用, RTS/DSR设置
+    outb(COM1 + UART_IER, 0x00);    // 禁用所有中断
+    outb(COM1 + UART_LCR, 0x03);    // 8位, 无奇偶校验, 一个停止位
+    serial_set_baud(SERIAL_DEFAULT_BAUD);
+    outb(COM1 + UART_FCR, 0xC7);    // 启用 FIFO, 清除, 14字节阈值
+    outb(COM1 + UART_MCR, 0x0B);    // IRQ启用, RTS/DSR设置
+
+    // IIR 高两位为 11 表示 FIFO 可用（16550A），否则只能逐字节发送
+    tx_burst = ((inb(COM1 + UART_IIR) & 0xC0) == 0xC0) ? UART_FIFO_SIZE : 1;
+
+    tx_head = 0;
+    tx_tail = 0;
+    tx_busy = 0;
+    serial_irq_mode = 0;
+    spin_lock_init(&tx_lock, "serial_tx");
 }
 
 /* 检查串口是否空闲 */
 int serial_is_transmit_empty() {
-    return inb(COM1 + 5) & 0x20;
+    return inb(COM1 + UART_LSR) & UART_LSR_THRE;
+}
+
+/* 同步发送单个字符（轮询） */
+static void serial_putc_sync(char c) {
+    while (serial_is_transmit_empty() == 0);
+    outb(COM1 + UART_THR, c);
+}
+
+/* 从缓冲区取出最多一个 FIFO 的数据写入 UART（调用者需关中断） */
+static void serial_tx_fill(void) {
+    if (tx_head == tx_tail) {
+        tx_busy = 0;
+        return;
+    }
+
+    // FIFO 未空时等待下一次 THRE 中断
+    if (!serial_is_transmit_empty()) {
+        tx_busy = 1;
+        return;
+    }
+
+    for (int i = 0; i < tx_burst && tx_tail != tx_head; i++) {
+        outb(COM1 + UART_THR, tx_buf[tx_tail & SERIAL_TX_BUF_MASK]);
+        tx_tail++;
+    }
+    tx_busy = 1;
+}
+
+/* COM1 中断处理程序（IRQ4） */
+static void serial_irq_handler(struct registers *regs) {
+    uint8_t iir;
+
+    spin_lock(&tx_lock);
+    // IIR 最低位为 0 表示仍有待处理的中断
+    while (((iir = inb(COM1 + UART_IIR)) & 0x01) == 0) {
+        switch ((iir >> 1) & 0x07) {
+            case 1:     // THRE：FIFO 已空，继续发送
+                serial_tx_fill();
+                break;
+            case 2:     // 接收数据
+            case 6:     // 接收超时
+                (void)inb(COM1 + UART_THR);
+                break;
+            case 3:     // 线路状态
+                (void)inb(COM1 + UART_LSR);
+                break;
+            default:    // Modem 状态
+                (void)inb(COM1 + UART_MSR);
+                break;
+        }
+    }
+    spin_unlock(&tx_lock);
+}
+
+/* 切换到中断驱动发送（需在 idt_init 之后调用） */
+void serial_enable_irq(void) {
+    uint32_t flags = irq_save();
+
+    register_irq_handler(COM1_IRQ, serial_irq_handler);
+    spin_lock(&tx_lock);
+    outb(COM1 + UART_IER, UART_IER_THRI);
+    serial_irq_mode = 1;
+
+    // 启动发送中缓冲的数据
+    if (!tx_busy) {
+        serial_tx_fill();
+    }
+
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+/* 写入一个字符（调用者持有 tx_lock） */
+static void serial_put_locked(char c) {
+    if (!serial_irq_mode) {
+        serial_putc_sync(c);
+        return;
+    }
+
+    if (tx_head - tx_tail >= SERIAL_TX_BUF_SIZE) {
+        tx_dropped++;
+    } else {
+        tx_buf[tx_head & SERIAL_TX_BUF_MASK] = c;
+        tx_head++;
+    }
+}
+
+/* 通过串口发送一段数据：整段只加一次锁（不阻塞，缓冲区满时丢弃） */
+void serial_write(const char* data, size_t len) {
+    uint32_t flags = spin_lock_irqsave(&tx_lock);
+
+    for (size_t i = 0; i < len; i++) {
+        serial_put_locked(data[i]);
+    }
+
+    // 发送器空闲时需要手动启动，之后由 THRE 中断接力
+    if (serial_irq_mode && !tx_busy) {
+        serial_tx_fill();
+    }
+
+    spin_unlock_irqrestore(&tx_lock, flags);
 }
 
 /* 通过串口发送字符 */
 void serial_putc(char c) {
-    while (serial_is_transmit_empty() == 0);
-    outb(COM1, c);
+    serial_write(&c, 1);
 }
 
 /* 通过串口发送字符串 */
 void serial_puts(const char* str) {
-    while (*str) {
-        serial_putc(*str++);
+    size_t len = 0;
+    while (str[len]) len++;
+    serial_write(str, len);
+}
+
+/* 同步排空发送缓冲区（用于 panic 等无法等待中断的路径） */
+void serial_flush(void) {
+    uint32_t flags = spin_lock_irqsave(&tx_lock);
+
+    while (tx_tail != tx_head) {
+        while (serial_is_transmit_empty() == 0);
+        for (int i = 0; i < tx_burst && tx_tail != tx_head; i++) {
+            outb(COM1 + UART_THR, tx_buf[tx_tail & SERIAL_TX_BUF_MASK]);
+            tx_tail++;
+        }
     }
-}
\ No newline at end of file
+
+    // 等待移位寄存器发送完毕
+    while ((inb(COM1 + UART_LSR) & UART_LSR_TEMT) == 0);
+    tx_busy = 0;
+
+    spin_unlock_irqrestore(&tx_lock, flags);
+}
+
+/* 获取因缓冲区满而丢弃的字节数 */
+uint32_t serial_get_dropped(void) {
+    return tx_dropped;
+}
@@ -0,0 +1,364 @@
+#include <kernel/lz4.h>
+#include <kernel/string.h>
+#include <stddef.h>
+
+/* 非对齐读取（x86 支持，告诉编译器不要假设对齐与别名） */
+typedef uint32_t __attribute__((may_alias, aligned(1))) u32_unaligned_t;
+typedef uint16_t __attribute__((may_alias, aligned(1))) u16_unaligned_t;
+
+static inline uint32_t read32(const uint8_t *p) {
+    return *(const u32_unaligned_t *)p;
+}
+
+static inline uint16_t read16(const uint8_t *p) {
+    return *(const u16_unaligned_t *)p;
+}
+
+/* ========== xxHash32 ========== */
+
+#define XXH_PRIME1 2654435761u
+#define XXH_PRIME2 2246822519u
+#define XXH_PRIME3 3266489917u
+#define XXH_PRIME4 668265263u
+#define XXH_PRIME5 374761393u
+
+static inline uint32_t rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t xxh_round(uint32_t acc, uint32_t input) {
+    return rotl32(acc + input * XXH_PRIME2, 13) * XXH_PRIME1;
+}
+
+uint32_t xxh32(const void *data, uint32_t len, uint32_t seed) {
+    const uint8_t *p = data;
+    const uint8_t *end = p + len;
+    uint32_t h;
+
+    if (len >= 16) {
+        uint32_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        uint32_t v2 = seed + XXH_PRIME2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - XXH_PRIME1;
+        do {
+            v1 = xxh_round(v1, read32(p));
+            v2 = xxh_round(v2, read32(p + 4));
+            v3 = xxh_round(v3, read32(p + 8));
+            v4 = xxh_round(v4, read32(p + 12));
+            p += 16;
+        } while (p + 16 <= end);
+        h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    } else {
+        h = seed + XXH_PRIME5;
+    }
+
+    h += len;
+    for (; p + 4 <= end; p += 4) {
+        h = rotl32(h + read32(p) * XXH_PRIME3, 17) * XXH_PRIME4;
+    }
+    for (; p < end; p++) {
+        h = rotl32(h + *p * XXH_PRIME5, 11) * XXH_PRIME1;
+    }
+
+    h ^= h >> 15;
+    h *= XXH_PRIME2;
+    h ^= h >> 13;
+    h *= XXH_PRIME3;
+    h ^= h >> 16;
+    return h;
+}
+
+/* ========== 块格式 ========== */
+
+/* 读取 15 之后的扩展长度（每个字节累加，遇到非 255 结束） */
+static inline int read_length(const uint8_t **ip, const uint8_t *iend, uint32_t *len) {
+    uint8_t b;
+    do {
+        if (*ip >= iend || *len > (1u << 30)) {
+            return -1;
+        }
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+    return 0;
+}
+
+int lz4_block_decompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t cap,
+                         const uint8_t *dict) {
+    const uint8_t *ip = src;
+    const uint8_t *iend = src + len;
+    uint8_t *op = dst;
+    uint8_t *oend = dst + cap;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        // 字面量
+        uint32_t lit = token >> 4;
+        if (lit == 15 && read_length(&ip, iend, &lit) < 0) {
+            return -1;
+        }
+        if (lit > (uint32_t)(iend - ip) || lit > (uint32_t)(oend - op)) {
+            return -1;
+        }
+        if (lit <= 16) {
+            for (uint32_t i = 0; i < lit; i++) {
+                op[i] = ip[i];
+            }
+        } else {
+            memcpy(op, ip, lit);
+        }
+        ip += lit;
+        op += lit;
+
+        // 最后一个序列只有字面量
+        if (ip == iend) {
+            break;
+        }
+
+        // 匹配：2 字节偏移 + 长度（最少 4）
+        if (iend - ip < 2) {
+            return -1;
+        }
+        uint32_t offset = read16(ip);
+        ip += 2;
+        if (offset == 0 || offset > (uint32_t)(op - dict)) {
+            return -1;
+        }
+
+        uint32_t mlen = token & 15;
+        if (mlen == 15 && read_length(&ip, iend, &mlen) < 0) {
+            return -1;
+        }
+        mlen += 4;
+        if (mlen > (uint32_t)(oend - op)) {
+            return -1;
+        }
+
+        const uint8_t *match = op - offset;
+        if (offset >= mlen && mlen > 16) {
+            memcpy(op, match, mlen);
+        } else if (offset == 1) {
+            memset(op, *match, mlen);
+        } else {
+            // 短匹配或重叠匹配（offset < mlen 表示重复前面的模式）逐字节复制
+            for (uint32_t i = 0; i < mlen; i++) {
+                op[i] = match[i];
+            }
+        }
+        op += mlen;
+    }
+
+    return op - dst;
+}
+
+/* ========== 帧格式 ========== */
+
+#define LZ4_FLG_VERSION_MASK    0xC0
+#define LZ4_FLG_VERSION         0x40
+#define LZ4_FLG_BLOCK_INDEP     0x20
+#define LZ4_FLG_BLOCK_CHECKSUM  0x10
+#define LZ4_FLG_CONTENT_SIZE    0x08
+#define LZ4_FLG_CONTENT_CHECKSUM 0x04
+#define LZ4_FLG_DICT_ID         0x01
+
+#define LZ4_BLOCK_UNCOMPRESSED  0x80000000u
+
+/* 跳过帧（魔数 0x184D2A50-0x184D2A5F），内容由应用自定义 */
+#define LZ4_SKIPPABLE_MASK      0xFFFFFFF0u
+#define LZ4_SKIPPABLE_MAGIC     0x184D2A50u
+
+typedef struct {
+    uint8_t flg;
+    uint32_t block_max;
+    uint32_t content_size;      // 0 表示帧头未给出
+    uint32_t header_len;
+} lz4_frame_header_t;
+
+/* 解析帧头，成功返回 0 */
+static int parse_header(const uint8_t *p, uint32_t len, lz4_frame_header_t *hdr) {
+    if (len < 7 || read32(p) != LZ4_FRAME_MAGIC) {
+        return -1;
+    }
+
+    uint8_t flg = p[4];
+    uint8_t bd = p[5];
+    uint32_t n = 6;
+    if ((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION || (flg & LZ4_FLG_DICT_ID)) {
+        return -1;      // 不支持外部字典
+    }
+
+    // BD 的 4-6 位：4 = 64KB, 5 = 256KB, 6 = 1MB, 7 = 4MB
+    uint32_t bsid = (bd >> 4) & 7;
+    if (bsid < 4) {
+        return -1;
+    }
+    hdr->block_max = 1u << (8 + 2 * bsid);
+    hdr->flg = flg;
+    hdr->content_size = 0;
+
+    if (flg & LZ4_FLG_CONTENT_SIZE) {
+        if (len < n + 8 + 1) {
+            return -1;
+        }
+        // 超过 4GB 的内容在 32 位内核中无法容纳
+        if (read32(p + n + 4)) {
+            return -1;
+        }
+        hdr->content_size = read32(p + n);
+        n += 8;
+    }
+
+    // 头校验字节：描述符（FLG 起）的 xxh32 第二个字节
+    if (((xxh32(p + 4, n - 4, 0) >> 8) & 0xFF) != p[n]) {
+        return -1;
+    }
+    hdr->header_len = n + 1;
+    return 0;
+}
+
+int lz4_is_frame(const void *src, uint32_t len) {
+    return len >= 4 && read32(src) == LZ4_FRAME_MAGIC;
+}
+
+uint32_t lz4_frame_bound(const void *src, uint32_t len) {
+    const uint8_t *p = src;
+    const uint8_t *end = p + len;
+    uint32_t total = 0;
+
+    while (end - p >= 8) {
+        if ((read32(p) & LZ4_SKIPPABLE_MASK) == LZ4_SKIPPABLE_MAGIC) {
+            uint32_t skip = read32(p + 4);
+            if (skip > (uint32_t)(end - p) - 8) {
+                return 0;
+            }
+            p += 8 + skip;
+            continue;
+        }
+
+        lz4_frame_header_t hdr;
+        if (parse_header(p, end - p, &hdr) < 0) {
+            return 0;
+        }
+        p += hdr.header_len;
+
+        // 只扫描块头，不解码：每个块最多解出 block_max 字节
+        uint32_t bound = 0;
+        for (;;) {
+            if (end - p < 4) {
+                return 0;
+            }
+            uint32_t bsize = read32(p) & ~LZ4_BLOCK_UNCOMPRESSED;
+            p += 4;
+            if (bsize == 0) {
+                break;
+            }
+            uint32_t extra = (hdr.flg & LZ4_FLG_BLOCK_CHECKSUM) ? 4 : 0;
+            if (bsize > hdr.block_max || bsize + extra > (uint32_t)(end - p)) {
+                return 0;
+            }
+            p += bsize + extra;
+            bound += hdr.block_max;
+        }
+        if (hdr.flg & LZ4_FLG_CONTENT_CHECKSUM) {
+            p += 4;
+        }
+        if (p > end) {
+            return 0;
+        }
+
+        total += hdr.content_size ? hdr.content_size : bound;
+    }
+    return total;
+}
+
+int lz4_frame_decompress(const void *src, uint32_t len, void *dst, uint32_t cap) {
+    const uint8_t *p = src;
+    const uint8_t *end = p + len;
+    uint8_t *out = dst;
+    uint8_t *oend = out + cap;
+
+    while (end - p >= 8) {
+        if ((read32(p) & LZ4_SKIPPABLE_MASK) == LZ4_SKIPPABLE_MAGIC) {
+            uint32_t skip = read32(p + 4);
+            if (skip > (uint32_t)(end - p) - 8) {
+                return -1;
+            }
+            p += 8 + skip;
+            continue;
+        }
+
+        lz4_frame_header_t hdr;
+        if (parse_header(p, end - p, &hdr) < 0) {
+            return -1;
+        }
+        p += hdr.header_len;
+
+        // 链接块可以引用本帧之前所有块的输出
+        uint8_t *frame_start = out;
+        for (;;) {
+            if (end - p < 4) {
+                return -1;
+            }
+            uint32_t word = read32(p);
+            uint32_t bsize = word & ~LZ4_BLOCK_UNCOMPRESSED;
+            p += 4;
+            if (bsize == 0) {
+                break;
+            }
+            if (bsize > hdr.block_max || bsize > (uint32_t)(end - p)) {
+                return -1;
+            }
+
+            if (hdr.flg & LZ4_FLG_BLOCK_CHECKSUM) {
+                if ((uint32_t)(end - p) < bsize + 4) {
+                    return -1;
+                }
+#if CONFIG_LZ4_VERIFY
+                if (xxh32(p, bsize, 0) != read32(p + bsize)) {
+                    return -1;
+                }
+#endif
+            }
+
+            uint32_t room = oend - out;
+            if (room > hdr.block_max) {
+                room = hdr.block_max;
+            }
+            int n;
+            if (word & LZ4_BLOCK_UNCOMPRESSED) {
+                if (bsize > room) {
+                    return -1;
+                }
+                memcpy(out, p, bsize);
+                n = bsize;
+            } else {
+                n = lz4_block_decompress(p, bsize, out, room,
+                                         (hdr.flg & LZ4_FLG_BLOCK_INDEP) ? out : frame_start);
+                if (n < 0) {
+                    return -1;
+                }
+            }
+            out += n;
+            p += bsize + ((hdr.flg & LZ4_FLG_BLOCK_CHECKSUM) ? 4 : 0);
+        }
+
+        uint32_t frame_len = out - frame_start;
+        if (hdr.content_size && hdr.content_size != frame_len) {
+            return -1;
+        }
+        if (hdr.flg & LZ4_FLG_CONTENT_CHECKSUM) {
+            if (end - p < 4) {
+                return -1;
+            }
+#if CONFIG_LZ4_VERIFY
+            if (xxh32(frame_start, frame_len, 0) != read32(p)) {
+                return -1;
+            }
+#endif
+            p += 4;
+        }
+    }
+
+    return out - (uint8_t *)dst;
+}
@@ -7,40 +7,48 @@
 #include <kernel/idt.h>
 #include <kernel/pic.h>
 #include <kernel/mouse.h>
-
-/* Multiboot2 信息结构 */
-typedef struct {
-    uint32_t total_size;
-    uint32_t reserved;
-} multiboot2_info_header_t;
-
-/* 标签头 */
-typedef struct {
-    uint32_t type;
-    uint32_t size;
-} multiboot_tag_header_t;
-
-/* 帧缓冲信息标签 */
-typedef struct {
-    multiboot_tag_header_t header;
-    uint64_t framebuffer_addr;
-    uint32_t framebuffer_pitch;
-    uint32_t framebuffer_width;
-    uint32_t framebuffer_height;
-    uint8_t framebuffer_bpp;
-    uint8_t framebuffer_type;
-    uint8_t reserved;
-} multiboot_tag_framebuffer_t;
+#include <kernel/tsc.h>
+#include <kernel/trace.h>
+#include <kernel/bootprof.h>
+#include <kernel/timer.h>
+#include <kernel/thread.h>
+#include <kernel/percpu.h>
+#include <kernel/smp.h>
+#include <kernel/task.h>
+#include <kernel/render.h>
+#include <kernel/event.h>
+#include <kernel/paging.h>
+#include <kernel/syscall.h>
+#include <kernel/process.h>
+#include <kernel/surface.h>
+#include <kernel/fpu.h>
+#include <kernel/cpu_features.h>
+#include <kernel/printk.h>
+#include <kernel/pci.h>
+#include <kernel/ata.h>
+#include <kernel/virtio_blk.h>
+#include <kernel/bcache.h>
+#include <kernel/bga.h>
+#include <kernel/cirrus.h>
+#include <kernel/multiboot.h>
+#include <kernel/bootmem.h>
+#include <kernel/bootmod.h>
+#include <kernel/ramfs.h>
+#include <kernel/vfs.h>
+#include <kernel/blkfs.h>
 
 /* 图形上下文 */
 graphics_context_t gfx_ctx;
 uint8_t graphics_enabled = 0;
 
+/* 桌面绘制列表（较大，不放在栈上） */
+static render_list_t desktop_list;
+
 /* VGA 文本输出 */
-void vga_puts(const char* str) {
+static void vga_write(const char* str, size_t len) {
     volatile unsigned short* video = (volatile unsigned short*)0xB8000;
     static int x = 0, y = 0;
-    while (*str) {
+    for (size_t i = 0; i < len; i++) {
         if (*str == '\n') {
             x = 0;
             y++;
@@ -64,21 +72,87 @@ void vga_puts(const char* str) {
     }
 }
 
+void vga_puts(const char* str) {
+    vga_write(str, strlen(str));
+}
+
+/* printk 输出端：错误与警告同时显示在 VGA 文本屏幕上 */
+static void vga_log_sink(int level, const char* line, size_t len) {
+    (void)level;
+    vga_write(line, len);
+}
+
+/* 解析内核命令行（Multiboot2 标签类型 1） */
+multiboot_tag_header_t* multiboot_find_tag(uint32_t mb_info_addr, uint32_t type) {
+    if (mb_info_addr == 0) {
+        return NULL;
+    }
+    
+    multiboot2_info_header_t* header = (multiboot2_info_header_t*)mb_info_addr;
+    uint32_t offset = 8;
+    
+    while (offset < header->total_size) {
+        multiboot_tag_header_t* tag = (multiboot_tag_header_t*)(mb_info_addr + offset);
+        if (tag->type == 0) {
+            break;
+        }
+        if (tag->type == type) {
+            return tag;
+        }
+        offset += (tag->size + 7) & ~7;
+    }
+    return NULL;
+}
+
+multiboot_tag_header_t* multiboot_next_tag(uint32_t mb_info_addr, multiboot_tag_header_t* tag) {
+    multiboot2_info_header_t* header = (multiboot2_info_header_t*)mb_info_addr;
+    // tag 为 NULL 时返回第一个标签
+    uint32_t offset = tag ? (uint32_t)tag - mb_info_addr + ((tag->size + 7) & ~7) : 8;
+
+    if (mb_info_addr == 0 || offset >= header->total_size) {
+        return NULL;
+    }
+    tag = (multiboot_tag_header_t*)(mb_info_addr + offset);
+    return tag->type == MULTIBOOT_TAG_END ? NULL : tag;
+}
+
+void parse_boot_cmdline(uint32_t mb_info_addr) {
+    multiboot_tag_header_t* tag = multiboot_find_tag(mb_info_addr, 1);
+    if (!tag) {
+        return;
+    }
+    
+    char cmdline[128];
+    char* saveptr;
+    strlcpy(cmdline, ((multiboot_tag_string_t*)tag)->string, sizeof(cmdline));
+    
+    for (char* tok = strtok_r(cmdline, " ", &saveptr); tok; 
+         tok = strtok_r(NULL, " ", &saveptr)) {
+        if (strcmp(tok, "quiet") == 0) {
+            boot_quiet = 1;
+        }
+    }
+}
+
+/* 获取 GRUB 复制的 ACPI RSDP（优先新版标签 15），没有时返回 NULL */
+const void* multiboot_find_rsdp(uint32_t mb_info_addr) {
+    multiboot_tag_header_t* tag = multiboot_find_tag(mb_info_addr, 15);
+    if (!tag) {
+        tag = multiboot_find_tag(mb_info_addr, 14);
+    }
+    return tag ? (const void*)(tag + 1) : NULL;
+}
+
 /* 解析Multiboot2信息，查找framebuffer */
 int parse_multiboot2_info(uint32_t mb_info_addr) {
-    char buf[32];
-    
     // 检查是否为有效的Multiboot2信息结构
     if (mb_info_addr == 0) {
-        serial_puts("Invalid Multiboot2 info address (0)\n");
+        pr_err("Invalid Multiboot2 info address (0)\n");
         return 0;
     }
     
     multiboot2_info_header_t* header = (multiboot2_info_header_t*)mb_info_addr;
-    serial_puts("Multiboot2 info total size: ");
-    utoa(header->total_size, buf, 10);
-    serial_puts(buf);
-    serial_puts(" bytes\n");
+    pr_info("Multiboot2 info total size: %u bytes\n", header->total_size);
     
     // 遍历所有标签
     uint32_t offset = 8; // 跳过总大小和保留字段
@@ -87,13 +161,9 @@ int parse_multiboot2_info(uint32_t mb_info_addr) {
     while (offset < header->total_size) {
         multiboot_tag_header_t* tag = (multiboot_tag_header_t*)(mb_info_addr + offset);
         
-        serial_puts("Found tag type: ");
-        utoa(tag->type, buf, 10);
-        serial_puts(buf);
-        serial_puts(", size: ");
-        utoa(tag->size, buf, 10);
-        serial_puts(buf);
-        serial_puts("\n");
+        if (!boot_quiet) {
+            pr_info("Found tag type: %u, size: %u\n", tag->type, tag->size);
+        }
         
         if (tag->type == 0) {
             // 结束标签
@@ -103,31 +173,14 @@ int parse_multiboot2_info(uint32_t mb_info_addr) {
         if (tag->type == 8) { // Framebuffer信息标签
             multiboot_tag_framebuffer_t* fb_tag = (multiboot_tag_framebuffer_t*)tag;
             
-            serial_puts("FOUND FRAMEBUFFER INFO!\n");
-            serial_puts("  Address: 0x");
-            utoa((uint32_t)fb_tag->framebuffer_addr, buf, 16);
-            serial_puts(buf);
-            serial_puts("\n");
-            
-            serial_puts("  Width: ");
-            utoa(fb_tag->framebuffer_width, buf, 10);
-            serial_puts(buf);
-            serial_puts("\n");
-            
-            serial_puts("  Height: ");
-            utoa(fb_tag->framebuffer_height, buf, 10);
-            serial_puts(buf);
-            serial_puts("\n");
-            
-            serial_puts("  Pitch: ");
-            utoa(fb_tag->framebuffer_pitch, buf, 10);
-            serial_puts(buf);
-            serial_puts("\n");
-            
-            serial_puts("  BPP: ");
-            utoa(fb_tag->framebuffer_bpp, buf, 10);
-            serial_puts(buf);
-            serial_puts("\n");
+            pr_info("FOUND FRAMEBUFFER INFO!\n");
+            if (!boot_quiet) {
+                pr_info("  Address: 0x%x\n", (uint32_t)fb_tag->framebuffer_addr);
+                pr_info("  Width: %u\n", fb_tag->framebuffer_width);
+                pr_info("  Height: %u\n", fb_tag->framebuffer_height);
+                pr_info("  Pitch: %u\n", fb_tag->framebuffer_pitch);
+                pr_info("  BPP: %u\n", fb_tag->framebuffer_bpp);
+            }
             
             // 初始化图形上下文
             if (fb_tag->framebuffer_addr != 0) {
@@ -148,30 +201,39 @@ int parse_multiboot2_info(uint32_t mb_info_addr) {
 }
 
 
-// 定时器中断处理程序
-void timer_handler(struct registers *regs) {
-    static int ticks = 0;
-    ticks++;
-    
-    // 发送EOI
-    outb(0x20, 0x20);
-}
-
 // 键盘中断处理程序（IRQ1）
 void keyboard_handler(struct registers *regs) {
     uint8_t scancode = inb(0x60);
     
+    trace(TRACE_KEY_PRESS, scancode, 0);
+    
+    // 按下 T 键（扫描码 0x14）时导出跟踪缓冲区
+    if (scancode == 0x14) {
+        event_signal(EVENT_TRACE_DUMP);
+    }
+    
+    // 按下 L 键（扫描码 0x26）时输出锁竞争、事件与块缓存统计
+    if (scancode == 0x26) {
+        event_signal(EVENT_LOCK_REPORT);
+    }
+    
+    // 按下 B 键（扫描码 0x30）时运行系统调用往返基准
+    if (scancode == 0x30) {
+        event_signal(EVENT_SYSCALL_BENCH);
+    }
+
+    // 按下 M 键（扫描码 0x32）时切换显示模式
+    if (scancode == 0x32) {
+        event_signal(EVENT_MODE_SWITCH);
+    }
+    
     // 检查是否是按键按下（扫描码最高位为0表示按下）
     if (scancode < 0x80) {
         // 简单的键盘映射表
         const char *keymap = "??1234567890-=??qwertyuiop[]\n?asdfghjkl;'`?\\zxcvbnm,./?*? ?";
         
         if (scancode < sizeof(keymap) && keymap[scancode] != '?') {
-            char c = keymap[scancode];
-            serial_puts("Key pressed: ");
-            char str[2] = {c, '\0'};
-            serial_puts(str);
-            serial_puts("\n");
+            pr_info("Key pressed: %c\n", keymap[scancode]);
         }
     }
 }
@@ -180,110 +242,100 @@ void keyboard_handler(struct registers *regs) {
 void page_fault_handler(struct registers *regs) {
     uint32_t faulting_address;
     
+    // 用户态访问无效地址只终止该进程
+    process_handle_fault(regs, "page fault");
+    
     // 读取CR2寄存器获取错误地址
     asm volatile("mov %%cr2, %0" : "=r"(faulting_address));
     
-    // 在屏幕上显示错误信息
-    serial_puts("\n!!! PAGE FAULT !!!\n");
-    
-    // 显示错误地址（简化版）
-    char addr_str[12];
-    itoa((int)faulting_address, addr_str, 16);
-    serial_puts("Faulting address: ");
-    serial_puts(addr_str);
-    serial_puts("\n");
-    
-    // 显示错误代码
-    char err_str[12];
-    itoa((int)regs->err_code, err_str, 10);
-    serial_puts("Error code: ");
-    serial_puts(err_str);
-    serial_puts("\n");
+    pr_err("\n!!! PAGE FAULT !!!\n");
+    pr_err("Faulting address: 0x%x\n", faulting_address);
+    pr_err("Error code: %u\n", regs->err_code);
     
     // 死循环
-    serial_puts("System halted.\n");
+    pr_err("System halted.\n");
+    serial_flush();
     asm volatile("cli\n""hlt");
 }
 
 // 双重错误处理程序（异常8）
 void double_fault_handler(struct registers *regs) {
-    serial_puts("\n!!! DOUBLE FAULT !!!\n");
-    serial_puts("System halted.\n");
+    pr_err("\n!!! DOUBLE FAULT !!!\n");
+    pr_err("System halted.\n");
+    serial_flush();
     asm volatile("cli\n""hlt");
 }
 
 // 通用保护错误处理程序（异常13）
 void general_protection_fault_handler(struct registers *regs) {
-    serial_puts("\n!!! GENERAL PROTECTION FAULT !!!\n");
-    
-    char err_str[12];
-    itoa((int)regs->err_code, err_str, 10);
-    serial_puts("Error code: ");
-    serial_puts(err_str);
-    serial_puts("\n");
+    process_handle_fault(regs, "general protection fault");
     
-    serial_puts("System halted.\n");
+    pr_err("\n!!! GENERAL PROTECTION FAULT !!!\n");
+    pr_err("Error code: %u\n", regs->err_code);
+    pr_err("System halted.\n");
+    serial_flush();
     asm volatile("cli\n""hlt");
 }
 
 // 除零错误处理程序（异常0）
 void divide_by_zero_handler(struct registers *regs) {
-    serial_puts("\n!!! DIVIDE BY ZERO !!!\n");
-    serial_puts("System halted.\n");
+    process_handle_fault(regs, "divide by zero");
+    
+    pr_err("\n!!! DIVIDE BY ZERO !!!\n");
+    pr_err("System halted.\n");
+    serial_flush();
     asm volatile("cli\n""hlt");
 }
 
+/* 内置用户程序映像（userprog.asm） */
+extern const uint8_t user_hello_start[];
+extern const uint8_t user_hello_end[];
+extern const uint8_t user_bench_start[];
+extern const uint8_t user_bench_end[];
+extern const uint8_t user_surface_start[];
+extern const uint8_t user_surface_end[];
+
 /* 绘制桌面图形 */
 void graphics_desktop() {
     if (!graphics_enabled) return;
-    serial_puts("Starting graphics demo\n");
+    pr_info("Starting graphics demo\n");
+    trace(TRACE_RENDER_BEGIN, gfx_ctx.width, gfx_ctx.height);
+    render_list_t* list = &desktop_list;
+    render_list_clear(list);
     // 1. 清屏为深蓝色
-    graphics_clear_screen(&gfx_ctx, 0x000033);
+    render_fill(list, 0, 0, gfx_ctx.width, gfx_ctx.height, COLOR_DESKTOP);
     // 2. 显示标题
-    graphics_draw_string(&gfx_ctx, gfx_ctx.width/2 - 150, 50, 
-                        "IsThisAnOS Graphical Kernel", COLOR_WHITE);
+    render_text(list, gfx_ctx.width/2 - 150, 50, 
+                "IsThisAnOS Graphical Kernel", COLOR_WHITE);
     // 3. 显示分辨率信息
     char res_str[64];
-    utoa(gfx_ctx.width, res_str, 10);
-    strcat(res_str, " x ");
-    char height_str[16];
-    utoa(gfx_ctx.height, height_str, 10);
-    strcat(res_str, height_str);
-    strcat(res_str, " x ");
-    char bpp_str[16];
-    utoa(gfx_ctx.bpp, bpp_str, 10);
-    strcat(res_str, bpp_str);
-    graphics_draw_string(&gfx_ctx, gfx_ctx.width/2 - 100, 80, 
-                        res_str, COLOR_CYAN);
+    snprintf(res_str, sizeof(res_str), "%u x %u x %u", gfx_ctx.width, gfx_ctx.height, gfx_ctx.bpp);
+    render_text(list, gfx_ctx.width/2 - 100, 80, res_str, COLOR_CYAN);
     
     // 4. 绘制彩色矩形
-    graphics_draw_rect(&gfx_ctx, 100, 150, 200, 100, COLOR_RED);
-    graphics_draw_rect(&gfx_ctx, 350, 150, 200, 100, COLOR_GREEN);
-    graphics_draw_rect(&gfx_ctx, 600, 150, 200, 100, COLOR_BLUE);
+    render_fill(list, 100, 150, 200, 100, COLOR_RED);
+    render_fill(list, 350, 150, 200, 100, COLOR_GREEN);
+    render_fill(list, 600, 150, 200, 100, COLOR_BLUE);
     
     // 5. 绘制边框矩形
-    graphics_draw_rect_outline(&gfx_ctx, 95, 145, 210, 110, COLOR_WHITE);
-    graphics_draw_rect_outline(&gfx_ctx, 345, 145, 210, 110, COLOR_WHITE);
-    graphics_draw_rect_outline(&gfx_ctx, 595, 145, 210, 110, COLOR_WHITE);
+    render_outline(list, 95, 145, 210, 110, COLOR_WHITE);
+    render_outline(list, 345, 145, 210, 110, COLOR_WHITE);
+    render_outline(list, 595, 145, 210, 110, COLOR_WHITE);
     
     // 6. 在矩形上显示文字
-    graphics_draw_string(&gfx_ctx, 180, 190, "RED", COLOR_WHITE);
-    graphics_draw_string(&gfx_ctx, 430, 190, "GREEN", COLOR_WHITE);
-    graphics_draw_string(&gfx_ctx, 680, 190, "BLUE", COLOR_WHITE);
+    render_text(list, 180, 190, "RED", COLOR_WHITE);
+    render_text(list, 430, 190, "GREEN", COLOR_WHITE);
+    render_text(list, 680, 190, "BLUE", COLOR_WHITE);
     
     // 7. 绘制线条
-    graphics_draw_hline(&gfx_ctx, 100, 300, 700, COLOR_YELLOW);
-    graphics_draw_vline(&gfx_ctx, 450, 320, 150, COLOR_MAGENTA);
+    render_hline(list, 100, 300, 700, COLOR_YELLOW);
+    render_vline(list, 450, 320, 150, COLOR_MAGENTA);
     
     // 8. 显示功能列表
-    graphics_draw_string(&gfx_ctx, 100, 350, 
-                        "- Framebuffer graphics", COLOR_LIGHT_GRAY);
-    graphics_draw_string(&gfx_ctx, 100, 370, 
-                        "- Bitmap font rendering", COLOR_LIGHT_GRAY);
-    graphics_draw_string(&gfx_ctx, 100, 390, 
-                        "- Basic shape drawing", COLOR_LIGHT_GRAY);
-    graphics_draw_string(&gfx_ctx, 100, 410, 
-                        "- Color support (32-bit)", COLOR_LIGHT_GRAY);
+    render_text(list, 100, 350, "- Framebuffer graphics", COLOR_LIGHT_GRAY);
+    render_text(list, 100, 370, "- Bitmap font rendering", COLOR_LIGHT_GRAY);
+    render_text(list, 100, 390, "- Basic shape drawing", COLOR_LIGHT_GRAY);
+    render_text(list, 100, 410, "- Color support (32-bit)", COLOR_LIGHT_GRAY);
     
     // 9. 绘制彩虹条
     uint32_t rainbow[] = {
@@ -298,20 +350,27 @@ void graphics_desktop() {
 
     int bar_width = 100;
     for (int i = 0; i < 7; i++) {
-        graphics_draw_rect(&gfx_ctx, 100 + i * bar_width, 450, 
-                          bar_width - 10, 30, rainbow[i]);
+        render_fill(list, 100 + i * bar_width, 450, bar_width - 10, 30, rainbow[i]);
     }
     
-    // 10. 绘制鼠标指针形状
+    // 10. 显示按钮提示
+    render_text(list, 100, 600, 
+                "Click on colored rectangles with mouse!", COLOR_YELLOW);
+    
+    // 11. 显示状态
+    render_text(list, 100, 500, "Status: Graphics running", COLOR_GREEN);
+
+    // 全屏作为一个损坏区域，按瓦片并行光栅化；能翻页时画在隐藏页上再一次性显示
+    graphics_context_t* target = bga_back_buffer();
+    render_damage(target ? target : &gfx_ctx, list, 0, 0, gfx_ctx.width, gfx_ctx.height);
+    if (target) {
+        bga_flip();
+    }
+
+    // 12. 最后绘制鼠标指针（会保存指针下的背景）
     draw_mouse(mouse_get_x(), mouse_get_y());
-    // 11. 显示按钮提示
-    graphics_draw_string(&gfx_ctx, 100, 600, 
-                        "Click on colored rectangles with mouse!", COLOR_YELLOW);
-    
-    // 12. 显示状态
-    graphics_draw_string(&gfx_ctx, 100, 500, 
-                        "Status: Graphics running", COLOR_GREEN);
-    serial_puts("Graphics completed\n");
+    trace(TRACE_RENDER_END, 0, 0);
+    pr_info("Graphics completed\n");
 }
 
 
@@ -324,70 +383,157 @@ void check_mouse_click(void) {
         int mouse_x = mouse_get_x();
         int mouse_y = mouse_get_y();
         
-        char click_str[64];
-        itoa(mouse_x, click_str, 10);
-        strcat(click_str, ",");
-        char y_str[16];
-        itoa(mouse_y, y_str, 10);
-        strcat(click_str, y_str);
+        trace(TRACE_MOUSE_CLICK, mouse_x, mouse_y);
         
         // 检查点击区域
         if (mouse_x >= 100 && mouse_x <= 300 && 
             mouse_y >= 150 && mouse_y <= 250) {
             graphics_draw_string(&gfx_ctx, 150, 270, "Clicked!", COLOR_YELLOW);
-            serial_puts("Clicked on RED rectangle!\n");
+            pr_info("Clicked on RED rectangle!\n");
         } else if (mouse_x >= 350 && mouse_x <= 550 && 
                    mouse_y >= 150 && mouse_y <= 250) {
             graphics_draw_string(&gfx_ctx, 400, 270, "Clicked!", COLOR_YELLOW);
-            serial_puts("Clicked on GREEN rectangle!\n");
+            pr_info("Clicked on GREEN rectangle!\n");
         } else if (mouse_x >= 600 && mouse_x <= 800 && 
                    mouse_y >= 150 && mouse_y <= 250) {
             graphics_draw_string(&gfx_ctx, 650, 270, "Clicked!", COLOR_YELLOW);
-            serial_puts("Clicked on BLUE rectangle!\n");
+            pr_info("Clicked on BLUE rectangle!\n");
         }
     }
 }
 
+/* 鼠标事件：处理队列中的移动与点击 */
+static void on_mouse_event(void) {
+    mouse_update();
+    check_mouse_click();
+}
+
+/* 光标刷新事件：每秒强制重绘一次鼠标指针 */
+static void on_cursor_refresh(void) {
+    mouse_force_redraw();
+}
+
+static void on_lock_report(void) {
+    lock_stats_report();
+    event_report();
+    bcache_report();
+    vfs_report();
+}
+
+/* 用户表面移走后露出的桌面：只重绘这一块 */
+static void redraw_desktop(int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    render_damage(&gfx_ctx, &desktop_list, x, y, width, height);
+}
+
+/* 在 1024x768 与 800x600 之间切换显示模式并重绘桌面（仅 Bochs DISPI） */
+static void on_mode_switch(void) {
+    // 已映射帧缓冲的进程仍按旧的尺寸和行距写显存，这时拒绝切换
+    uint32_t mapped = process_count_fb_mapped();
+    if (mapped) {
+        pr_warn("Mode switch refused: %u process(es) have the framebuffer mapped\n", mapped);
+        return;
+    }
+
+    uint32_t width = (gfx_ctx.width == 1024) ? 800 : 1024;
+    uint32_t height = (width == 1024) ? 768 : 600;
+    if (bga_set_mode(width, height, gfx_ctx.bpp) == 0) {
+        mouse_clamp_to_screen();
+        graphics_desktop();
+    }
+}
+
+/* 启动系统调用往返基准进程，结果由其自行输出到串口 */
+static void on_syscall_bench(void) {
+    if (!process_create("sysbench", user_bench_start, user_bench_end - user_bench_start)) {
+        pr_warn("Failed to start syscall benchmark\n");
+    }
+}
+
+/* 鼠标中断：收到完整数据包后触发鼠标事件 */
+static void mouse_irq_handler(struct registers *regs) {
+    mouse_handler(regs);
+    if (!mouse_queue_empty()) {
+        event_signal(EVENT_MOUSE);
+    }
+}
+
 /* 内核主函数 */
 void kernel_main(uint32_t magic, uint32_t mb_info_addr) {
     // 初始化串口
+    bootprof_mark("serial_init");
     serial_init();
-    serial_puts("\n=== IsThisAnOS Starting ===\n");
+    printk_register_sink("vga", LOG_WARN, vga_log_sink);
+    pr_info("\n=== IsThisAnOS Starting ===\n");
+    
+    // 解析 CPUID，之后的初始化按 cpu_has() 判断硬件能力
+    bootprof_mark("cpu_features_init");
+    cpu_features_init();
+    
+    // 校准TSC（跟踪时间戳换算需要）
+    bootprof_mark("tsc_init");
+    tsc_init();
+    
+    // 开启 x87/SSE，再按 CPU 特性填充 memcpy/填充/混合/校验和的分发表
+    bootprof_mark("fpu_init");
+    fpu_init();
+    bootprof_mark("cpu_dispatch_init");
+    cpu_dispatch_init();
+#if CONFIG_STRING_SELFTEST
+    string_selftest();
+#endif
+    cpu_features_report();
     
     // 检查Multiboot2魔数
-    char buf[32];
-    serial_puts("Multiboot magic: 0x");
-    utoa(magic, buf, 16);
-    serial_puts(buf);
-    serial_puts("\n");
+    pr_info("Multiboot magic: 0x%x\n", magic);
     
     if (magic != 0x36d76289) {
-        vga_puts("ERROR: Invalid Multiboot2 magic!\n");
-        serial_puts("ERROR: Invalid Multiboot2 magic!\n");
+        pr_err("ERROR: Invalid Multiboot2 magic!\n");
         return;
     }
     
     // 尝试获取framebuffer信息
+    bootprof_mark("multiboot_parse");
+    parse_boot_cmdline(mb_info_addr);
+    bootmod_init(mb_info_addr);
+    bootmem_init(mb_info_addr);
     vga_puts("\nInitializing graphics...\n");
-    serial_puts("\nParsing Multiboot2 info for framebuffer...\n");
+    pr_info("\nParsing Multiboot2 info for framebuffer...\n");
     
     if (parse_multiboot2_info(mb_info_addr)) {
         graphics_enabled = 1;
-        serial_puts("Graphics initialized successfully!\n");
+        pr_info("Graphics initialized successfully!\n");
+        // Bochs/QEMU stdvga：把显存分成多页，之后可以无拷贝翻页
+        bga_init(&gfx_ctx);
     
         asm volatile("cli");
+        bootprof_mark("gdt_init");
+        percpu_init(0);
         gdt_init();
+        // GS 已指向每 CPU 数据块：printk 改用每 CPU 行缓冲区，并记录到跟踪缓冲区
+        printk_init();
+        printk_register_sink("trace", LOG_DEBUG, trace_printk_sink);
+        bootprof_mark("idt_init");
         idt_init();
+        bootprof_mark("irq_setup");
         // 注册异常处理程序
         register_interrupt_handler(0, divide_by_zero_handler);      // 除零错误
         register_interrupt_handler(8, double_fault_handler);        // 双重错误
         register_interrupt_handler(13, general_protection_fault_handler); // 通用保护错误
         register_interrupt_handler(14, page_fault_handler);         // 页错误
         
+        // 开启分页（内核恒等映射 + 用户地址窗口），安装系统调用门
+        bootprof_mark("paging_init");
+        paging_init();
+        paging_set_write_combining((uint32_t)gfx_ctx.framebuffer,
+                                   bga_vram_size() ? bga_vram_size() : gfx_ctx.pitch * gfx_ctx.height);
+        syscall_init();
+        
         // 注册IRQ处理程序
-        register_irq_handler(0, timer_handler);      // 定时器
         register_irq_handler(1, keyboard_handler);   // 键盘
-        register_irq_handler(12, mouse_handler);     // 鼠标（PS/2）
+        register_irq_handler(12, mouse_irq_handler); // 鼠标（PS/2）
+
+        // 串口切换为中断驱动发送
+        serial_enable_irq();
         
         // 启用IRQ
         pic_enable_irq(0);   // 定时器
@@ -396,10 +542,7 @@ void kernel_main(uint32_t magic, uint32_t mb_info_addr) {
         pic_enable_irq(12);  // 鼠标
 
         // 初始化定时器
-        int divisor = 1193180 / 100;  // 100Hz
-        outb(0x43, 0x36);
-        outb(0x40, divisor & 0xFF);
-        outb(0x40, (divisor >> 8) & 0xFF);
+        timer_init(TIMER_HZ);
         
         // 初始化键盘
         outb(0x64, 0xAE);  // 启用键盘接口
@@ -407,40 +550,101 @@ void kernel_main(uint32_t magic, uint32_t mb_info_addr) {
         // 初始化鼠标
         mouse_init();
 
+        // 创建内核线程（当前执行流成为主线程）
+        bootprof_mark("thread_init");
+        thread_init();
+        fpu_enable_lazy();
+        event_init();
+
+        // 启动其余处理器
+        bootprof_mark("smp_init");
+        smp_init(multiboot_find_rsdp(mb_info_addr));
+        task_pool_init();
+
+        // 枚举 PCI 设备并识别硬盘（开中断前完成，识别过程全部轮询）
+        bootprof_mark("storage_init");
+        pci_init();
+        ata_init();
+        virtio_blk_init();
+        bcache_init();
+#if CONFIG_BCACHE_SELFTEST
+        bcache_selftest();
+#endif
+
+        // Cirrus 显卡上把填充、拷贝和字形交给 2D 引擎（没有时保持 CPU 绘制）
+        bootprof_mark("gfx_accel");
+        cirrus_init(&gfx_ctx);
+
+        // 把 GRUB 加载的 USTAR 模块索引为只读 ramfs（文件内容原地使用，不拷贝；
+        // LZ4 压缩的模块先整体解压一次）
+        bootprof_mark("initrd");
+        const bootmod_t* initrd = bootmod_find("initrd");
+        uint32_t initrd_size = 0;
+        const void* initrd_data = initrd ? bootmod_data(initrd, &initrd_size) : NULL;
+        vfs_init();
+        if (initrd_data && ramfs_init(initrd_data, initrd_size) >= 0 && ramfs_mount() == 0) {
+            vfs_file_t* motd = vfs_open("/etc/motd");
+            if (motd) {
+                char buf[128];
+                int n;
+                while ((n = vfs_read(motd, buf, sizeof(buf))) > 0) {
+                    serial_write(buf, n);
+                }
+                vfs_close(motd);
+            }
+            // 块设备挂到 /dev 下，读取经过页缓存与块缓存
+            if (blkfs_mount("/dev") == 0) {
+#if CONFIG_BLKFS_SELFTEST
+                blkfs_selftest();
+#endif
+            }
+        }
+
         asm volatile("sti");
-        // 运行图形界面
+        // 运行图形界面（全屏重绘属于批量工作，降低优先级让输入随时抢占）
+        bootprof_mark("graphics_desktop");
+        thread_set_priority(thread_current(), THREAD_PRIO_BULK);
         graphics_desktop();
+        thread_set_priority(thread_current(), THREAD_PRIO_NORMAL);
         
         vga_puts("\nGraphics running.\n");
         vga_puts("Check display for output.\n");
     } else {
-        vga_puts("Graphics initialization failed.\n");
-        serial_puts("Graphics initialization failed.\n");
+        pr_err("Graphics initialization failed.\n");
     }
     
-    // 主循环
-    serial_puts("\nEntering main loop\n");
+    // 输出启动各阶段耗时
+    bootprof_report();
     
-    uint32_t frame_count = 0;
-    uint32_t mouse_update_counter = 0;
+    // 主循环
+    pr_info("\nEntering main loop\n");
     
-    while (1) {
-        asm volatile("hlt");
-        
-        frame_count++;
-
-        mouse_update();
-        
-        check_mouse_click();
-        
-        // 每100帧强制重绘鼠标
-        if (frame_count % 100 == 0) {
-            mouse_force_redraw();
-        }
-        
-        // 防止帧计数溢出
-        if (frame_count >= 1000000) {
-            frame_count = 0;
+    if (!graphics_enabled) {
+        // 没有中断和线程可用，直接停机
+        while (1) {
+            asm volatile("hlt");
         }
     }
-}
\ No newline at end of file
+    
+    // 主线程成为事件循环：没有事件时阻塞，CPU 留给空闲线程 hlt
+    event_register(EVENT_MOUSE, "mouse", on_mouse_event);
+    event_register(EVENT_CURSOR_REFRESH, "cursor_refresh", on_cursor_refresh);
+    event_register(EVENT_TRACE_DUMP, "trace_dump", trace_dump);
+    event_register(EVENT_LOCK_REPORT, "lock_report", on_lock_report);
+    event_register(EVENT_SYSCALL_BENCH, "syscall_bench", on_syscall_bench);
+    event_register(EVENT_MODE_SWITCH, "mode_switch", on_mode_switch);
+    event_register(EVENT_COMPOSITE, "composite", surface_composite);
+    surface_set_background(redraw_desktop);
+    event_set_periodic(EVENT_CURSOR_REFRESH, TIMER_HZ);
+    
+    // 启动内置的 ring 3 示例程序
+    if (!process_create("hello", user_hello_start, user_hello_end - user_hello_start)) {
+        pr_warn("Failed to start user process\n");
+    }
+    if (!process_create("surface", user_surface_start, user_surface_end - user_surface_start)) {
+        pr_warn("Failed to start surface demo\n");
+    }
+    
+    thread_set_priority(thread_current(), THREAD_PRIO_INTERACTIVE);
+    event_loop();
+}
@@ -1,6 +1,9 @@
 #include "kernel/mouse.h"
 #include "kernel/graphics.h"
 #include "kernel/io.h"
+#include "kernel/trace.h"
+#include "kernel/bootprof.h"
+#include "kernel/spinlock.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -55,6 +58,14 @@ static struct {
 /* 缓冲区 */
 static uint32_t back_buffer[16 * 16];
 
+/* 锁：
+ * queue_lock  - 移动队列，中断中写入、输入线程读出
+ * click_lock  - click_state，中断中更新、线程中查询并清除
+ * cursor_lock - 光标位置/按钮/背景缓冲，只在线程上下文访问，绘制时持有写锁 */
+static ticket_lock_t queue_lock = TICKET_LOCK_INIT;
+static ticket_lock_t click_lock = TICKET_LOCK_INIT;
+static rwlock_t cursor_lock = RWLOCK_INIT;
+
 /* 队列系统 */
 #define MOUSE_QUEUE_SIZE 16
 static struct {
@@ -69,6 +80,8 @@ static int queue_count = 0;
 
 /* 添加到队列 */
 void enqueue_mouse_data(int8_t dx, int8_t dy, uint8_t buttons) {
+    uint32_t flags = ticket_lock_irqsave(&queue_lock);
+    
     if (queue_count >= MOUSE_QUEUE_SIZE) {
         // 队列满，丢弃最旧的数据
         queue_head = (queue_head + 1) % MOUSE_QUEUE_SIZE;
@@ -82,11 +95,16 @@ void enqueue_mouse_data(int8_t dx, int8_t dy, uint8_t buttons) {
     mouse_queue[tail].timestamp = 0; // 可以用时间戳
     
     queue_count++;
+    
+    ticket_unlock_irqrestore(&queue_lock, flags);
 }
 
 /* 从队列取出 */
 int dequeue_mouse_data(int8_t *dx, int8_t *dy, uint8_t *buttons) {
+    uint32_t flags = ticket_lock_irqsave(&queue_lock);
+    
     if (queue_count == 0) {
+        ticket_unlock_irqrestore(&queue_lock, flags);
         return 0;
     }
     
@@ -97,6 +115,7 @@ int dequeue_mouse_data(int8_t *dx, int8_t *dy, uint8_t *buttons) {
     queue_head = (queue_head + 1) % MOUSE_QUEUE_SIZE;
     queue_count--;
     
+    ticket_unlock_irqrestore(&queue_lock, flags);
     return 1;
 }
 
@@ -152,7 +171,7 @@ void draw_mouse(int x, int y) {
     }
 }
 
-/* 更新点击检测状态 */
+/* 更新点击检测状态（调用者持有 click_lock） */
 void update_click_detection(uint8_t new_buttons) {
     uint8_t old_buttons = click_state.current_buttons;
     click_state.current_buttons = new_buttons;
@@ -193,7 +212,12 @@ void update_click_detection(uint8_t new_buttons) {
 
 /* 鼠标初始化 */
 void mouse_init(void) {
+    ticket_lock_init(&queue_lock, "mouse_queue");
+    ticket_lock_init(&click_lock, "mouse_click");
+    rwlock_init(&cursor_lock, "mouse_cursor");
+    
     // 启用鼠标
+    bootprof_mark("mouse: enable aux");
     outb(0x64, 0xA8);
     
     // 启用中断
@@ -205,6 +229,7 @@ void mouse_init(void) {
     outb(0x60, config);
     
     // 设置默认设置
+    bootprof_mark("mouse: defaults+report");
     outb(0x64, 0xD4);
     outb(0x60, 0xF6);
     (void)inb(0x60);  // 读取确认
@@ -215,6 +240,7 @@ void mouse_init(void) {
     (void)inb(0x60);  // 读取确认
     
     // 设置采样率（提高响应性）
+    bootprof_mark("mouse: sample rate");
     outb(0x64, 0xD4);
     outb(0x60, 0xF3);  // 设置采样率
     outb(0x60, 0xC8);  // 200采样/秒
@@ -228,6 +254,7 @@ void mouse_init(void) {
     outb(0x60, 0x50);  // 80采样/秒
     
     // 清空缓冲区
+    bootprof_mark("mouse: drain+state");
     while ((inb(0x64) & 0x01) == 1) {
         inb(0x60);
     }
@@ -284,19 +311,19 @@ void mouse_handler(struct registers *regs) {
         int8_t dy = (int8_t)mouse_state.packet[2];
         uint8_t buttons = flags & 0x07;
         
+        trace(TRACE_MOUSE_PACKET, (uint32_t)(int32_t)dx, (uint32_t)(int32_t)dy);
+        
         // 立即更新点击检测
+        uint32_t lock_flags = ticket_lock_irqsave(&click_lock);
         update_click_detection(buttons);
-        
-        // 标记按钮状态变化
-        if (buttons != mouse_state.buttons) {
-            mouse_state.buttons = buttons;
-            mouse_state.dirty = 1;  // 标记需要重绘
-        }
+        int buttons_changed = buttons != click_state.last_buttons;
+        click_state.last_buttons = buttons;
+        ticket_unlock_irqrestore(&click_lock, lock_flags);
         
         // 如果有移动或按钮变化，添加到队列
-        if (dx != 0 || dy != 0 || (buttons != click_state.last_buttons)) {
+        // （光标位置与按钮状态由输入线程在 mouse_update 中统一更新）
+        if (dx != 0 || dy != 0 || buttons_changed) {
             enqueue_mouse_data(dx, dy, buttons);
-            click_state.last_buttons = buttons;
         }
     }
     
@@ -306,7 +333,10 @@ void mouse_handler(struct registers *regs) {
 
 /* 更新鼠标显示和状态 */
 void mouse_update(void) {
+    write_lock(&cursor_lock);
+    
     if (!mouse_state.visible || !graphics_enabled) {
+        write_unlock(&cursor_lock);
         return;
     }
     
@@ -355,39 +385,53 @@ void mouse_update(void) {
     else if (has_movement) {
         draw_mouse(mouse_state.x, mouse_state.y);
     }
+    
+    write_unlock(&cursor_lock);
 }
 
 /* 检查按钮按下事件 */
 int mouse_check_button_press(uint8_t button_mask) {
+    int result = 0;
+    uint32_t flags = ticket_lock_irqsave(&click_lock);
     for (int i = 0; i < 3; i++) {
         if ((button_mask & (1 << i)) && click_state.button_down[i]) {
             click_state.button_down[i] = 0;  // 清除标志
-            return 1;
+            result = 1;
+            break;
         }
     }
-    return 0;
+    ticket_unlock_irqrestore(&click_lock, flags);
+    return result;
 }
 
 /* 检查按钮释放事件 */
 int mouse_check_button_release(uint8_t button_mask) {
+    int result = 0;
+    uint32_t flags = ticket_lock_irqsave(&click_lock);
     for (int i = 0; i < 3; i++) {
         if ((button_mask & (1 << i)) && click_state.button_up[i]) {
             click_state.button_up[i] = 0;  // 清除标志
-            return 1;
+            result = 1;
+            break;
         }
     }
-    return 0;
+    ticket_unlock_irqrestore(&click_lock, flags);
+    return result;
 }
 
 /* 检查按钮点击事件（按下并释放） */
 int mouse_check_button_click(uint8_t button_mask) {
+    int result = 0;
+    uint32_t flags = ticket_lock_irqsave(&click_lock);
     for (int i = 0; i < 3; i++) {
         if ((button_mask & (1 << i)) && click_state.click_count[i] > 0) {
             click_state.click_count[i]--;
-            return 1;
+            result = 1;
+            break;
         }
     }
-    return 0;
+    ticket_unlock_irqrestore(&click_lock, flags);
+    return result;
 }
 
 /* 获取鼠标状态 */
@@ -397,52 +441,80 @@ mouse_state_t* mouse_get_state(void) {
 
 /* 获取鼠标X坐标 */
 int mouse_get_x(void) {
-    return mouse_state.x;
+    read_lock(&cursor_lock);
+    int value = mouse_state.x;
+    read_unlock(&cursor_lock);
+    return value;
 }
 
 /* 获取鼠标Y坐标 */
 int mouse_get_y(void) {
-    return mouse_state.y;
+    read_lock(&cursor_lock);
+    int value = mouse_state.y;
+    read_unlock(&cursor_lock);
+    return value;
 }
 
 /* 获取鼠标按钮状态 */
 uint8_t mouse_get_buttons(void) {
-    return mouse_state.buttons;
+    read_lock(&cursor_lock);
+    uint8_t buttons = mouse_state.buttons;
+    read_unlock(&cursor_lock);
+    return buttons;
 }
 
 /* 检查是否按下左键 */
 int mouse_is_left_pressed(void) {
-    return (mouse_state.buttons & 0x01) != 0;
+    return (mouse_get_buttons() & 0x01) != 0;
 }
 
 /* 检查是否按下右键 */
 int mouse_is_right_pressed(void) {
-    return (mouse_state.buttons & 0x02) != 0;
+    return (mouse_get_buttons() & 0x02) != 0;
 }
 
 /* 检查是否按下中键 */
 int mouse_is_middle_pressed(void) {
-    return (mouse_state.buttons & 0x04) != 0;
+    return (mouse_get_buttons() & 0x04) != 0;
 }
 
 /* 设置鼠标可见性 */
 void mouse_set_visible(uint8_t visible) {
-    if (mouse_state.visible == visible) return;
+    write_lock(&cursor_lock);
     
-    mouse_state.visible = visible;
-    
-    if (!visible) {
-        restore_background(mouse_state.x, mouse_state.y);
-    } else {
-        draw_mouse(mouse_state.x, mouse_state.y);
+    if (mouse_state.visible != visible) {
+        mouse_state.visible = visible;
+        
+        if (!visible) {
+            restore_background(mouse_state.x, mouse_state.y);
+        } else {
+            // 隐藏期间屏幕内容可能已改变，重新保存背景
+            save_background(mouse_state.x, mouse_state.y);
+            draw_mouse(mouse_state.x, mouse_state.y);
+        }
     }
+    
+    write_unlock(&cursor_lock);
+}
+
+void mouse_clamp_to_screen(void) {
+    write_lock(&cursor_lock);
+    if (mouse_state.x > (int)gfx_ctx.width - 16) mouse_state.x = gfx_ctx.width - 16;
+    if (mouse_state.y > (int)gfx_ctx.height - 16) mouse_state.y = gfx_ctx.height - 16;
+    if (mouse_state.x < 0) mouse_state.x = 0;
+    if (mouse_state.y < 0) mouse_state.y = 0;
+    mouse_state.old_x = mouse_state.x;
+    mouse_state.old_y = mouse_state.y;
+    write_unlock(&cursor_lock);
 }
 
 /* 强制重绘鼠标 */
 void mouse_force_redraw(void) {
-    if (!mouse_state.visible || !graphics_enabled) return;
-    
-    draw_mouse(mouse_state.x, mouse_state.y);
+    write_lock(&cursor_lock);
+    if (mouse_state.visible && graphics_enabled) {
+        draw_mouse(mouse_state.x, mouse_state.y);
+    }
+    write_unlock(&cursor_lock);
 }
 
 /* 检查队列是否为空 */
@@ -0,0 +1,275 @@
+#include <kernel/paging.h>
+#include <kernel/spinlock.h>
+#include <kernel/string.h>
+#include <kernel/io.h>
+#include <kernel/cpu_features.h>
+#include <kernel/printk.h>
+#include <stddef.h>
+
+#define PDE_INDEX(addr) ((addr) >> 22)
+#define PTE_INDEX(addr) (((addr) >> 12) & 0x3FF)
+
+#define CR0_PG  0x80000000
+#define CR0_WP  0x00010000
+#define CR4_PSE 0x00000010
+
+#define MSR_PAT        0x277
+
+/* PAT 表项 0-7：WB WC UC- UC WB WT UC- UC（上电默认值的表项 1 为 WT） */
+#define PAT_VALUE      0x0007040600070106ULL
+
+/* 内核页目录：所有进程页目录的内核部分从这里复制 */
+static uint32_t kernel_pd[1024] __attribute__((aligned(PAGE_SIZE)));
+uint32_t paging_kernel_cr3 = 0;
+
+/* 页帧池 */
+static uint8_t frame_pool[FRAME_POOL_PAGES][PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));
+static uint32_t frame_bitmap[FRAME_POOL_PAGES / 32];
+static spinlock_t frame_lock = SPINLOCK_INIT;
+
+static uint8_t pat_supported = 0;
+
+/* 写合并区域两端不足 4MB 的大页拆分用的页表（每个区域最多两个） */
+#define WC_SPLIT_TABLES 2
+static uint32_t wc_tables[WC_SPLIT_TABLES][1024] __attribute__((aligned(PAGE_SIZE)));
+static uint32_t wc_tables_used = 0;
+
+void *frame_alloc(void) {
+    void *frame = NULL;
+    uint32_t flags = spin_lock_irqsave(&frame_lock);
+
+    for (uint32_t i = 0; i < FRAME_POOL_PAGES / 32; i++) {
+        if (frame_bitmap[i] != 0xFFFFFFFF) {
+            uint32_t bit = __builtin_ctz(~frame_bitmap[i]);
+            frame_bitmap[i] |= 1u << bit;
+            frame = frame_pool[i * 32 + bit];
+            break;
+        }
+    }
+
+    spin_unlock_irqrestore(&frame_lock, flags);
+
+    if (frame) {
+        memset(frame, 0, PAGE_SIZE);
+    }
+    return frame;
+}
+
+void frame_free(void *frame) {
+    uint32_t index = ((uint8_t *)frame - &frame_pool[0][0]) / PAGE_SIZE;
+    if (index >= FRAME_POOL_PAGES) {
+        return;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&frame_lock);
+    frame_bitmap[index / 32] &= ~(1u << (index % 32));
+    spin_unlock_irqrestore(&frame_lock, flags);
+}
+
+/* 在当前 CPU 上开启 PSE 与分页 */
+static void paging_enable(void) {
+    uint32_t cr0, cr4;
+
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    asm volatile("mov %0, %%cr4" : : "r"(cr4 | CR4_PSE));
+
+    // 各 CPU 的 PAT 必须一致，在开启分页前设置
+    if (pat_supported) {
+        wrmsr(MSR_PAT, PAT_VALUE);
+    }
+
+    write_cr3(paging_kernel_cr3);
+
+    // WP：内核写只读用户页时同样触发页错误
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    asm volatile("mov %0, %%cr0" : : "r"(cr0 | CR0_PG | CR0_WP) : "memory");
+}
+
+void paging_init(void) {
+    pat_supported = cpu_has(CPU_FEATURE_PAT);
+
+    memset(kernel_pd, 0, sizeof(kernel_pd));
+
+    // 内核与 MMIO 使用 4MB 大页恒等映射，用户空间留空
+    for (uint32_t addr = 0; addr < USER_BASE; addr += LARGE_PAGE_SIZE) {
+        kernel_pd[PDE_INDEX(addr)] = addr | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE;
+    }
+    for (uint32_t addr = USER_TOP; addr != 0; addr += LARGE_PAGE_SIZE) {
+        kernel_pd[PDE_INDEX(addr)] = addr | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE;
+    }
+
+    spin_lock_init(&frame_lock, "frame_pool");
+    paging_kernel_cr3 = (uint32_t)kernel_pd;
+    paging_enable();
+}
+
+void paging_init_ap(void) {
+    paging_enable();
+}
+
+uint32_t *paging_create_directory(void) {
+    uint32_t *pd = (uint32_t *)frame_alloc();
+    if (!pd) {
+        return NULL;
+    }
+    // 内核映射在启动后不再变化，直接复制页目录项即可共享
+    memcpy(pd, kernel_pd, sizeof(kernel_pd));
+    return pd;
+}
+
+void paging_destroy_directory(uint32_t *pd) {
+    for (uint32_t i = PDE_INDEX(USER_BASE); i < PDE_INDEX(USER_TOP); i++) {
+        if (!(pd[i] & PAGE_PRESENT)) {
+            continue;
+        }
+        uint32_t *pt = (uint32_t *)(pd[i] & PAGE_MASK);
+        for (uint32_t j = 0; j < 1024; j++) {
+            if (pt[j] & PAGE_PRESENT) {
+                frame_free((void *)(pt[j] & PAGE_MASK));
+            }
+        }
+        frame_free(pt);
+    }
+    frame_free(pd);
+}
+
+/* 查找用户地址对应的页表项，create 时按需分配页表 */
+static uint32_t *paging_get_pte(uint32_t *pd, uint32_t vaddr, int create) {
+    if (vaddr < USER_BASE || vaddr >= USER_TOP) {
+        return NULL;
+    }
+
+    uint32_t *pde = &pd[PDE_INDEX(vaddr)];
+    if (!(*pde & PAGE_PRESENT)) {
+        if (!create) {
+            return NULL;
+        }
+        uint32_t *pt = (uint32_t *)frame_alloc();
+        if (!pt) {
+            return NULL;
+        }
+        // 权限由页表项决定，页目录项放宽
+        *pde = (uint32_t)pt | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    }
+
+    uint32_t *pt = (uint32_t *)(*pde & PAGE_MASK);
+    return &pt[PTE_INDEX(vaddr)];
+}
+
+void *paging_map_user_page(uint32_t *pd, uint32_t vaddr, uint32_t flags) {
+    uint32_t *pte = paging_get_pte(pd, vaddr, 1);
+    if (!pte) {
+        return NULL;
+    }
+    if (*pte & PAGE_PRESENT) {
+        return (void *)(*pte & PAGE_MASK);
+    }
+
+    void *frame = frame_alloc();
+    if (!frame) {
+        return NULL;
+    }
+    *pte = (uint32_t)frame | PAGE_PRESENT | PAGE_USER | (flags & PAGE_WRITE);
+    return frame;
+}
+
+int paging_map_user_phys(uint32_t *pd, uint32_t vaddr, uint32_t paddr, uint32_t flags) {
+    uint32_t *pte = paging_get_pte(pd, vaddr, 1);
+    if (!pte || (*pte & PAGE_PRESENT)) {
+        return -1;
+    }
+    *pte = (paddr & PAGE_MASK) | PAGE_PRESENT | PAGE_USER |
+           (flags & (PAGE_WRITE | PAGE_PWT | PAGE_PCD));
+    return 0;
+}
+
+uint32_t paging_virt_to_phys(uint32_t vaddr) {
+    // 用户窗口之外是恒等映射；分页开启前所有地址都是物理地址
+    if (!paging_kernel_cr3 || vaddr < USER_BASE || vaddr >= USER_TOP) {
+        return vaddr;
+    }
+
+    uint32_t *pte = paging_get_pte((uint32_t *)read_cr3(), vaddr, 0);
+    if (!pte || !(*pte & PAGE_PRESENT)) {
+        return 0;
+    }
+    return (*pte & PAGE_MASK) | (vaddr & ~PAGE_MASK);
+}
+
+/* 把一个恒等映射的 4MB 大页拆成 4KB 页表，属性不变；页表用完返回 NULL */
+static uint32_t *split_large_page(uint32_t index) {
+    if (wc_tables_used >= WC_SPLIT_TABLES) {
+        return NULL;
+    }
+    uint32_t *pt = wc_tables[wc_tables_used++];
+    uint32_t base = kernel_pd[index] & ~(LARGE_PAGE_SIZE - 1);
+    uint32_t attrs = kernel_pd[index] & (PAGE_PRESENT | PAGE_WRITE | PAGE_PWT | PAGE_PCD);
+    for (uint32_t j = 0; j < 1024; j++) {
+        pt[j] = (base + j * PAGE_SIZE) | attrs;
+    }
+    kernel_pd[index] = (uint32_t)pt | PAGE_PRESENT | PAGE_WRITE;
+    return pt;
+}
+
+void paging_set_write_combining(uint32_t addr, uint32_t size) {
+    if (!paging_kernel_cr3 || size == 0) {
+        return;
+    }
+
+    uint32_t last = addr + size - 1;
+    if (last < addr) {
+        last = 0xFFFFFFFF;
+    }
+
+    for (uint32_t i = PDE_INDEX(addr); i <= PDE_INDEX(last); i++) {
+        // 只处理恒等映射的大页，用户窗口不受影响
+        if ((kernel_pd[i] & (PAGE_PRESENT | PAGE_LARGE)) != (PAGE_PRESENT | PAGE_LARGE)) {
+            continue;
+        }
+
+        uint32_t base = i << 22;
+        if (base >= addr && base + (LARGE_PAGE_SIZE - 1) <= last) {
+            kernel_pd[i] = (kernel_pd[i] & ~PAGE_PCD) | PAGE_WRITE_COMBINE;
+            continue;
+        }
+
+        // 大页只有一部分属于该区域（同一 4MB 内可能有其他 MMIO）：拆成 4KB 页，
+        // 只把完全落在 [addr, addr+size) 内的页设为写合并
+        uint32_t *pt = split_large_page(i);
+        if (!pt) {
+            pr_warn("paging: no page table to split 0x%x, write-combining skipped\n", base);
+            continue;
+        }
+        for (uint32_t j = 0; j < 1024; j++) {
+            uint32_t page = base + j * PAGE_SIZE;
+            if (page >= addr && page + (PAGE_SIZE - 1) <= last) {
+                pt[j] = (pt[j] & ~PAGE_PCD) | PAGE_WRITE_COMBINE;
+            }
+        }
+    }
+
+    // 调用时 AP 尚未启动，只需刷新本 CPU 的 TLB
+    write_cr3(read_cr3());
+}
+
+int paging_user_range_ok(uint32_t *pd, uint32_t addr, uint32_t len, int write) {
+    if (addr < USER_BASE || addr >= USER_TOP || len > USER_TOP - addr) {
+        return 0;
+    }
+
+    uint32_t end = addr + len;
+    for (uint32_t page = addr & PAGE_MASK; page < end; page += PAGE_SIZE) {
+        uint32_t pde = pd[PDE_INDEX(page)];
+        if (!(pde & PAGE_PRESENT)) {
+            return 0;
+        }
+        uint32_t pte = ((uint32_t *)(pde & PAGE_MASK))[PTE_INDEX(page)];
+        if (!(pte & PAGE_PRESENT) || !(pte & PAGE_USER)) {
+            return 0;
+        }
+        if (write && !(pte & PAGE_WRITE)) {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,131 @@
+#include <kernel/pci.h>
+#include <kernel/io.h>
+#include <kernel/printk.h>
+#include <kernel/bootprof.h>
+#include <kernel/spinlock.h>
+#include <stddef.h>
+
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA    0xCFC
+
+static pci_device_t pci_devices[PCI_MAX_DEVICES];
+static uint32_t pci_device_count = 0;
+
+/* 地址与数据端口是两次访问，多 CPU 同时使用时必须串行 */
+static spinlock_t pci_lock = SPINLOCK_INIT;
+
+static inline uint32_t pci_address(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset) {
+    return 0x80000000u | ((uint32_t)bus << 16) | ((uint32_t)dev << 11) |
+           ((uint32_t)func << 8) | (offset & 0xFC);
+}
+
+uint32_t pci_read32(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset) {
+    uint32_t flags = spin_lock_irqsave(&pci_lock);
+    outl(PCI_CONFIG_ADDRESS, pci_address(bus, dev, func, offset));
+    uint32_t value = inl(PCI_CONFIG_DATA);
+    spin_unlock_irqrestore(&pci_lock, flags);
+    return value;
+}
+
+uint16_t pci_read16(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset) {
+    return (uint16_t)(pci_read32(bus, dev, func, offset) >> ((offset & 2) * 8));
+}
+
+uint8_t pci_read8(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset) {
+    return (uint8_t)(pci_read32(bus, dev, func, offset) >> ((offset & 3) * 8));
+}
+
+void pci_write32(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset, uint32_t value) {
+    uint32_t flags = spin_lock_irqsave(&pci_lock);
+    outl(PCI_CONFIG_ADDRESS, pci_address(bus, dev, func, offset));
+    outl(PCI_CONFIG_DATA, value);
+    spin_unlock_irqrestore(&pci_lock, flags);
+}
+
+void pci_write16(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset, uint16_t value) {
+    uint32_t flags = spin_lock_irqsave(&pci_lock);
+    outl(PCI_CONFIG_ADDRESS, pci_address(bus, dev, func, offset));
+    outw(PCI_CONFIG_DATA + (offset & 2), value);
+    spin_unlock_irqrestore(&pci_lock, flags);
+}
+
+static void pci_add_device(uint8_t bus, uint8_t dev, uint8_t func) {
+    if (pci_device_count >= PCI_MAX_DEVICES) {
+        return;
+    }
+
+    pci_device_t *pdev = &pci_devices[pci_device_count++];
+    uint32_t id = pci_read32(bus, dev, func, PCI_VENDOR_ID);
+    uint32_t class_reg = pci_read32(bus, dev, func, 0x08);
+
+    pdev->bus = bus;
+    pdev->dev = dev;
+    pdev->func = func;
+    pdev->vendor = id & 0xFFFF;
+    pdev->device = id >> 16;
+    pdev->class_code = class_reg >> 24;
+    pdev->subclass = (class_reg >> 16) & 0xFF;
+    pdev->prog_if = (class_reg >> 8) & 0xFF;
+    pdev->irq = pci_read8(bus, dev, func, PCI_INTERRUPT_LINE);
+
+    // 只有普通设备（头类型 0）有 6 个 BAR
+    if ((pci_read8(bus, dev, func, PCI_HEADER_TYPE) & 0x7F) == 0) {
+        for (int i = 0; i < 6; i++) {
+            pdev->bar[i] = pci_read32(bus, dev, func, PCI_BAR0 + i * 4);
+        }
+    }
+
+    if (!boot_quiet) {
+        pr_info("PCI %02x:%02x.%u %04x:%04x class %02x.%02x.%02x irq %u\n",
+                bus, dev, func, pdev->vendor, pdev->device,
+                pdev->class_code, pdev->subclass, pdev->prog_if, pdev->irq);
+    }
+}
+
+void pci_init(void) {
+    spin_lock_init(&pci_lock, "pci_config");
+    pci_device_count = 0;
+
+    // 逐一探测：厂商 ID 为 0xFFFF 表示不存在；只有多功能设备才探测功能 1-7
+    for (uint32_t bus = 0; bus < 256; bus++) {
+        for (uint8_t dev = 0; dev < 32; dev++) {
+            if (pci_read16(bus, dev, 0, PCI_VENDOR_ID) == 0xFFFF) {
+                continue;
+            }
+            uint8_t funcs = (pci_read8(bus, dev, 0, PCI_HEADER_TYPE) & 0x80) ? 8 : 1;
+            for (uint8_t func = 0; func < funcs; func++) {
+                if (pci_read16(bus, dev, func, PCI_VENDOR_ID) != 0xFFFF) {
+                    pci_add_device(bus, dev, func);
+                }
+            }
+        }
+    }
+
+    pr_info("PCI: %u devices\n", pci_device_count);
+}
+
+pci_device_t *pci_find_class(uint8_t class_code, uint8_t subclass, uint32_t index) {
+    for (uint32_t i = 0; i < pci_device_count; i++) {
+        if (pci_devices[i].class_code == class_code && pci_devices[i].subclass == subclass &&
+            index-- == 0) {
+            return &pci_devices[i];
+        }
+    }
+    return NULL;
+}
+
+pci_device_t *pci_find_device(uint16_t vendor, uint16_t device, uint32_t index) {
+    for (uint32_t i = 0; i < pci_device_count; i++) {
+        if (pci_devices[i].vendor == vendor && pci_devices[i].device == device &&
+            index-- == 0) {
+            return &pci_devices[i];
+        }
+    }
+    return NULL;
+}
+
+void pci_enable_bus_master(pci_device_t *pdev) {
+    uint16_t cmd = pci_read16(pdev->bus, pdev->dev, pdev->func, PCI_COMMAND);
+    cmd |= PCI_COMMAND_IO | PCI_COMMAND_MEMORY | PCI_COMMAND_BUS_MASTER;
+    pci_write16(pdev->bus, pdev->dev, pdev->func, PCI_COMMAND, cmd);
+}
@@ -0,0 +1,136 @@
+#include <kernel/printk.h>
+#include <kernel/percpu.h>
+#include <kernel/io.h>
+
+typedef struct {
+    const char *name;
+    int max_level;
+    printk_sink_fn write;
+} printk_sink_t;
+
+static void serial_sink(int level, const char *line, size_t len) {
+    (void)level;
+    serial_write(line, len);
+}
+
+/* 串口输出端始终存在，其余在启动过程中注册 */
+static printk_sink_t sinks[PRINTK_MAX_SINKS] = {
+    { "serial", LOG_DEBUG, serial_sink },
+};
+static volatile uint32_t sink_count = 1;
+
+/* GS 可用之前（只有 BSP 在运行）使用的行缓冲区 */
+static printk_line_t early_line;
+static volatile uint8_t printk_percpu = 0;
+
+int printk_register_sink(const char *name, int max_level, printk_sink_fn write) {
+    uint32_t flags = irq_save();
+    if (sink_count >= PRINTK_MAX_SINKS) {
+        irq_restore(flags);
+        return -1;
+    }
+    sinks[sink_count].name = name;
+    sinks[sink_count].max_level = max_level;
+    sinks[sink_count].write = write;
+    // 先填好表项再发布，其他 CPU 不会看到半个表项
+    __atomic_store_n(&sink_count, sink_count + 1, __ATOMIC_RELEASE);
+    irq_restore(flags);
+    return 0;
+}
+
+static printk_line_t *current_line(void) {
+    return printk_percpu ? &this_cpu()->log : &early_line;
+}
+
+static void emit(int level, const char *line, size_t len) {
+    uint32_t n = __atomic_load_n(&sink_count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < n; i++) {
+        if (level <= sinks[i].max_level) {
+            sinks[i].write(level, line, len);
+        }
+    }
+}
+
+void vprintk(int level, const char *format, va_list args) {
+    // 关中断：同一 CPU 上的中断处理程序不会插进半行里
+    uint32_t flags = irq_save();
+    printk_line_t *line = current_line();
+
+    if (line->len == 0) {
+        line->level = level;
+    }
+
+    // 直接格式化进行缓冲区，留一个字节给强制补上的换行；放不下时输出已满的部分，
+    // 再跳过已写出的字符重新格式化剩余部分
+    uint32_t done = 0;
+    for (;;) {
+        uint32_t room = PRINTK_LINE_MAX - 1 - line->len;
+        va_list ap;
+        va_copy(ap, args);
+        uint32_t n = vsnprintf_skip(line->buf + line->len, room, done, format, ap);
+        va_end(ap);
+        line->len += n;
+        done += n;
+
+        // 逐行交给输出端；通常换行在末尾，不需要移动剩余内容
+        uint32_t start = 0;
+        for (uint32_t i = 0; i < line->len; i++) {
+            if (line->buf[i] == '\n') {
+                emit(line->level, line->buf + start, i + 1 - start);
+                start = i + 1;
+            }
+        }
+        if (start) {
+            line->len -= start;
+            memmove(line->buf, line->buf + start, line->len);
+        }
+
+        // 缓冲区已满：补上换行后强制输出
+        if (line->len >= PRINTK_LINE_MAX - 2) {
+            line->buf[line->len++] = '\n';
+            emit(line->level, line->buf, line->len);
+            line->len = 0;
+        }
+
+        // vsnprintf 最多写 room - 1 个字符，没写满说明输出已经结束
+        if (n < room - 1) {
+            break;
+        }
+    }
+
+    irq_restore(flags);
+}
+
+void printk(int level, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintk(level, format, args);
+    va_end(args);
+}
+
+void printk_flush(void) {
+    uint32_t flags = irq_save();
+    printk_line_t *line = current_line();
+
+    if (line->len) {
+        line->buf[line->len++] = '\n';
+        emit(line->level, line->buf, line->len);
+        line->len = 0;
+    }
+
+    irq_restore(flags);
+}
+
+void printk_init(void) {
+    uint32_t flags = irq_save();
+
+    // 未写完的一行转移到 BSP 的缓冲区
+    printk_line_t *line = &this_cpu()->log;
+    memcpy(line->buf, early_line.buf, early_line.len);
+    line->len = early_line.len;
+    line->level = early_line.level;
+    early_line.len = 0;
+    printk_percpu = 1;
+
+    irq_restore(flags);
+}
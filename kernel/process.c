@@ -0,0 +1,176 @@
+#include <kernel/process.h>
+#include <kernel/paging.h>
+#include <kernel/syscall.h>
+#include <kernel/surface.h>
+#include <kernel/spinlock.h>
+#include <kernel/string.h>
+#include <kernel/io.h>
+#include <stddef.h>
+
+/* 进入用户态（switch.asm） */
+extern void enter_user_mode(uint32_t eip, uint32_t esp) __attribute__((noreturn));
+
+static process_t processes[PROCESS_MAX];
+static spinlock_t process_lock = SPINLOCK_INIT;
+static uint32_t next_pid = 1;
+
+process_t *process_current(void) {
+    thread_t *t = thread_current();
+    return t ? t->process : NULL;
+}
+
+uint32_t process_count_fb_mapped(void) {
+    uint32_t count = 0;
+    uint32_t flags = spin_lock_irqsave(&process_lock);
+    for (int i = 0; i < PROCESS_MAX; i++) {
+        if (processes[i].used && processes[i].fb_mapped) {
+            count++;
+        }
+    }
+    spin_unlock_irqrestore(&process_lock, flags);
+    return count;
+}
+
+static void process_free(process_t *proc) {
+    surface_release(proc);
+    if (proc->page_dir) {
+        paging_destroy_directory(proc->page_dir);
+        proc->page_dir = NULL;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&process_lock);
+    proc->used = 0;
+    spin_unlock_irqrestore(&process_lock, flags);
+}
+
+/* 进程线程入口：切换到进程地址空间后进入 ring 3 */
+static void process_start(void *arg) {
+    process_t *proc = (process_t *)arg;
+    thread_t *t = thread_current();
+
+    // 关中断设置，保证调度器看到的 cr3 与硬件一致
+    uint32_t flags = irq_save();
+    t->process = proc;
+    t->cr3 = (uint32_t)proc->page_dir;
+    write_cr3(t->cr3);
+    sysenter_set_stack(t->kstack_top);
+    irq_restore(flags);
+
+    enter_user_mode(proc->entry, USER_STACK_TOP);
+}
+
+process_t *process_create(const char *name, const void *image, uint32_t size) {
+    process_t *proc = NULL;
+
+    if (!paging_kernel_cr3) {
+        return NULL;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&process_lock);
+    for (int i = 0; i < PROCESS_MAX; i++) {
+        if (!processes[i].used) {
+            proc = &processes[i];
+            memset(proc, 0, sizeof(process_t));
+            proc->used = 1;
+            proc->pid = next_pid++;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&process_lock, flags);
+
+    if (!proc) {
+        return NULL;
+    }
+
+    strlcpy(proc->name, name, THREAD_NAME_LEN);
+    proc->entry = USER_BASE;
+    proc->page_dir = paging_create_directory();
+    if (!proc->page_dir) {
+        process_free(proc);
+        return NULL;
+    }
+
+    // 装载程序映像（页帧恒等映射，内核可直接写入）
+    for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+        uint8_t *page = paging_map_user_page(proc->page_dir, USER_BASE + off, PAGE_WRITE);
+        if (!page) {
+            process_free(proc);
+            return NULL;
+        }
+        uint32_t chunk = size - off < PAGE_SIZE ? size - off : PAGE_SIZE;
+        memcpy(page, (const uint8_t *)image + off, chunk);
+    }
+
+    // 用户栈
+    for (uint32_t i = 1; i <= USER_STACK_PAGES; i++) {
+        if (!paging_map_user_page(proc->page_dir, USER_STACK_TOP - i * PAGE_SIZE, PAGE_WRITE)) {
+            process_free(proc);
+            return NULL;
+        }
+    }
+
+    // vsyscall 页（用户只读）
+    uint32_t vsize;
+    const void *vimage = syscall_vsyscall_image(&vsize);
+    uint8_t *vpage = paging_map_user_page(proc->page_dir, VSYSCALL_BASE, 0);
+    if (!vpage) {
+        process_free(proc);
+        return NULL;
+    }
+    memcpy(vpage, vimage, vsize);
+
+    proc->thread = thread_create(proc->name, process_start, proc, THREAD_PRIO_NORMAL);
+    if (!proc->thread) {
+        process_free(proc);
+        return NULL;
+    }
+    return proc;
+}
+
+void process_exit(int code) {
+    process_t *proc = process_current();
+    thread_t *t = thread_current();
+    char buf[16];
+
+    if (proc) {
+        serial_puts("Process ");
+        serial_puts(proc->name);
+        serial_puts(" (pid ");
+        utoa(proc->pid, buf, 10);
+        serial_puts(buf);
+        serial_puts(") exited with code ");
+        itoa(code, buf, 10);
+        serial_puts(buf);
+        serial_puts("\n");
+
+        // 先切回内核页目录，再释放进程地址空间
+        uint32_t flags = irq_save();
+        t->cr3 = 0;
+        t->process = NULL;
+        write_cr3(paging_kernel_cr3);
+        irq_restore(flags);
+
+        process_free(proc);
+    }
+
+    thread_exit();
+}
+
+void process_handle_fault(struct registers *regs, const char *what) {
+    // CS 的 RPL 为 3 表示异常发生在用户态
+    if ((regs->cs & 3) != 3) {
+        return;
+    }
+
+    char buf[16];
+    serial_puts("User ");
+    serial_puts(what);
+    serial_puts(" at eip 0x");
+    utoa(regs->eip, buf, 16);
+    serial_puts(buf);
+    serial_puts(", killing process\n");
+
+    // 异常门已关中断，退出路径会重新调度
+    asm volatile("sti");
+    process_exit(-1);
+}
@@ -0,0 +1,319 @@
+#include <kernel/ramfs.h>
+#include <kernel/printk.h>
+#include <kernel/string.h>
+#include <kernel/vfs.h>
+#include <stddef.h>
+
+/* USTAR 头（512 字节块） */
+typedef struct {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char chksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];              // "ustar\0"（GNU 格式为 "ustar "）
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char pad[12];
+} __attribute__((packed)) tar_header_t;
+
+#define TAR_BLOCK 512
+
+static ramfs_node_t nodes[RAMFS_MAX_NODES];
+static uint32_t node_count = 0;
+static ramfs_node_t *hash_table[RAMFS_HASH_SIZE];
+static char name_pool[RAMFS_NAME_POOL];
+static uint32_t name_pool_used = 0;
+
+/* FNV-1a */
+static uint32_t path_hash(const char *s, uint32_t len) {
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < len; i++) {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h;
+}
+
+/* 规范化路径：去掉前导 "./" 与 '/'、合并重复的 '/'、去掉末尾 '/'，返回长度；太长返回 -1 */
+static int normalize(const char *in, uint32_t in_len, char *out) {
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+    while (i < in_len && in[i]) {
+        // 跳过分隔符和 "." 分量
+        if (in[i] == '/') {
+            i++;
+            continue;
+        }
+        if (in[i] == '.' && (i + 1 >= in_len || in[i + 1] == '/' || in[i + 1] == '\0')) {
+            i++;
+            continue;
+        }
+        if (n) {
+            if (n + 1 >= RAMFS_PATH_MAX) {
+                return -1;
+            }
+            out[n++] = '/';
+        }
+        while (i < in_len && in[i] && in[i] != '/') {
+            if (n + 1 >= RAMFS_PATH_MAX) {
+                return -1;
+            }
+            out[n++] = in[i++];
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+static ramfs_node_t *find(const char *path, uint32_t len, uint32_t hash) {
+    for (ramfs_node_t *n = hash_table[hash & (RAMFS_HASH_SIZE - 1)]; n; n = n->hash_next) {
+        if (n->hash == hash && strlen(n->path) == len && memcmp(n->path, path, len) == 0) {
+            return n;
+        }
+    }
+    return NULL;
+}
+
+/* 创建节点并挂到父目录下（父目录不存在时递归创建） */
+static ramfs_node_t *create(const char *path, uint32_t len, uint8_t type) {
+    uint32_t hash = path_hash(path, len);
+    ramfs_node_t *node = find(path, len, hash);
+    if (node) {
+        return node->type == type ? node : NULL;
+    }
+    if (node_count >= RAMFS_MAX_NODES || name_pool_used + len + 1 > RAMFS_NAME_POOL) {
+        return NULL;
+    }
+
+    // 找父目录："a/b/c" 的父目录是 "a/b"，顶层节点的父目录是根
+    ramfs_node_t *parent = NULL;
+    uint32_t slash = len;
+    while (slash > 0 && path[slash - 1] != '/') {
+        slash--;
+    }
+    if (len > 0) {
+        parent = create(path, slash ? slash - 1 : 0, RAMFS_DIR);
+        if (!parent) {
+            return NULL;
+        }
+    }
+
+    // 递归创建父目录可能已用掉节点，重新检查
+    if (node_count >= RAMFS_MAX_NODES || name_pool_used + len + 1 > RAMFS_NAME_POOL) {
+        return NULL;
+    }
+    node = &nodes[node_count++];
+    memset(node, 0, sizeof(*node));
+
+    char *copy = &name_pool[name_pool_used];
+    memcpy(copy, path, len);
+    copy[len] = '\0';
+    name_pool_used += len + 1;
+
+    node->path = copy;
+    node->name = copy + slash;
+    node->type = type;
+    node->mode = (type == RAMFS_DIR) ? 0555 : 0444;
+    node->hash = hash;
+    node->hash_next = hash_table[hash & (RAMFS_HASH_SIZE - 1)];
+    hash_table[hash & (RAMFS_HASH_SIZE - 1)] = node;
+
+    if (parent) {
+        node->parent = parent;
+        node->next_sibling = parent->first_child;
+        parent->first_child = node;
+    }
+    return node;
+}
+
+/* 解析八进制数字段（可以以空格或 NUL 结尾） */
+static uint32_t parse_octal(const char *s, uint32_t len) {
+    uint32_t v = 0;
+    uint32_t i = 0;
+    while (i < len && s[i] == ' ') {
+        i++;
+    }
+    for (; i < len && s[i] >= '0' && s[i] <= '7'; i++) {
+        v = (v << 3) | (s[i] - '0');
+    }
+    return v;
+}
+
+/* 校验和按字节无符号累加，校验和字段本身按 8 个空格计算 */
+static int header_valid(const tar_header_t *h) {
+    const uint8_t *p = (const uint8_t *)h;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < TAR_BLOCK; i++) {
+        sum += (i >= 148 && i < 156) ? ' ' : p[i];
+    }
+    return memcmp(h->magic, "ustar", 5) == 0 &&
+           sum == parse_octal(h->chksum, sizeof(h->chksum));
+}
+
+static int block_is_zero(const uint8_t *p) {
+    for (uint32_t i = 0; i < TAR_BLOCK; i++) {
+        if (p[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int ramfs_init(const void *image, uint32_t size) {
+    const uint8_t *base = image;
+    uint32_t offset = 0;
+    uint32_t files = 0;
+    uint32_t bytes = 0;
+    char raw[sizeof(((tar_header_t *)0)->prefix) + 1 + sizeof(((tar_header_t *)0)->name) + 1];
+    char path[RAMFS_PATH_MAX];
+
+    memset(hash_table, 0, sizeof(hash_table));
+    node_count = 0;
+    name_pool_used = 0;
+    create("", 0, RAMFS_DIR);
+
+    while (offset + TAR_BLOCK <= size) {
+        const tar_header_t *h = (const tar_header_t *)(base + offset);
+
+        // 归档以全零块结束
+        if (block_is_zero((const uint8_t *)h)) {
+            break;
+        }
+        if (!header_valid(h)) {
+            pr_err("ramfs: bad tar header at offset %u\n", offset);
+            return -1;
+        }
+
+        uint32_t fsize = parse_octal(h->size, sizeof(h->size));
+        uint32_t data_off = offset + TAR_BLOCK;
+        if (fsize > size - data_off) {
+            pr_err("ramfs: truncated archive\n");
+            return -1;
+        }
+
+        // 完整路径 = prefix + '/' + name（两个字段都不一定以 NUL 结尾）
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < sizeof(h->prefix) && h->prefix[i]; i++) {
+            raw[n++] = h->prefix[i];
+        }
+        if (n) {
+            raw[n++] = '/';
+        }
+        for (uint32_t i = 0; i < sizeof(h->name) && h->name[i]; i++) {
+            raw[n++] = h->name[i];
+        }
+
+        offset = data_off + ((fsize + TAR_BLOCK - 1) & ~(TAR_BLOCK - 1));
+
+        // 链接、设备文件等在只读 ramfs 中没有意义
+        if (h->typeflag != '0' && h->typeflag != '\0' && h->typeflag != '5') {
+            continue;
+        }
+
+        int len = normalize(raw, n, path);
+        if (len < 0) {
+            pr_warn("ramfs: path too long, skipped\n");
+            continue;
+        }
+
+        ramfs_node_t *node = create(path, len, h->typeflag == '5' ? RAMFS_DIR : RAMFS_FILE);
+        if (!node) {
+            pr_warn("ramfs: cannot add \"%s\"\n", path);
+            continue;
+        }
+        if (node->type == RAMFS_FILE) {
+            // 同名文件在归档中出现多次时以最后一次为准
+            node->data = base + data_off;
+            node->size = fsize;
+            files++;
+            bytes += fsize;
+        }
+        if (len > 0) {
+            node->mode = parse_octal(h->mode, sizeof(h->mode));
+            node->mtime = parse_octal(h->mtime, sizeof(h->mtime));
+        }
+    }
+
+    pr_info("ramfs: %u files, %u nodes, %u bytes (zero-copy)\n", files, node_count, bytes);
+    return files;
+}
+
+const ramfs_node_t *ramfs_root(void) {
+    return node_count ? &nodes[0] : NULL;
+}
+
+const ramfs_node_t *ramfs_lookup(const char *path) {
+    char norm[RAMFS_PATH_MAX];
+    int len = normalize(path, strlen(path), norm);
+    if (len < 0 || !node_count) {
+        return NULL;
+    }
+    return find(norm, len, path_hash(norm, len));
+}
+
+const void *ramfs_map(const ramfs_node_t *node, uint32_t offset, uint32_t *len) {
+    if (!node || node->type != RAMFS_FILE || offset > node->size) {
+        *len = 0;
+        return NULL;
+    }
+    *len = node->size - offset;
+    return node->data + offset;
+}
+
+uint32_t ramfs_read(const ramfs_node_t *node, uint32_t offset, void *dst, uint32_t len) {
+    uint32_t avail;
+    const void *src = ramfs_map(node, offset, &avail);
+    if (!src) {
+        return 0;
+    }
+    if (len > avail) {
+        len = avail;
+    }
+    memcpy(dst, src, len);
+    return len;
+}
+
+/* ========== VFS 接口 ========== */
+
+/* 只在 dentry 缓存未命中时调用：扫描目录的子节点 */
+static int ramfs_vfs_lookup(vfs_inode_t *dir, const char *name, uint32_t len,
+                            vfs_inode_t *child) {
+    const ramfs_node_t *d = dir->priv;
+    for (const ramfs_node_t *c = d->first_child; c; c = c->next_sibling) {
+        if (strlen(c->name) == len && memcmp(c->name, name, len) == 0) {
+            child->priv = (void *)c;
+            child->type = (c->type == RAMFS_DIR) ? VFS_DIR : VFS_FILE;
+            child->size = c->size;
+            child->mode = c->mode;
+            child->mtime = c->mtime;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* 文件内容就在模块内存中，读取时不经过页缓存 */
+static const void *ramfs_vfs_map(vfs_inode_t *inode, uint32_t offset, uint32_t *avail) {
+    return ramfs_map(inode->priv, offset, avail);
+}
+
+static const vfs_inode_ops_t ramfs_vfs_ops = {
+    .lookup = ramfs_vfs_lookup,
+    .map = ramfs_vfs_map,
+};
+
+int ramfs_mount(void) {
+    if (!node_count) {
+        return -1;
+    }
+    return vfs_mount_root(&ramfs_vfs_ops, &nodes[0]);
+}
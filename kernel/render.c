@@ -0,0 +1,230 @@
+#include <kernel/render.h>
+#include <kernel/font.h>
+#include <kernel/task.h>
+#include <kernel/string.h>
+#include <kernel/cpu_features.h>
+
+/* 矩形区域 [x0, x1) x [y0, y1) */
+typedef struct {
+    int32_t x0, y0, x1, y1;
+} render_rect_t;
+
+/* 一次 render_damage 的参数，供各瓦片任务共享 */
+typedef struct {
+    graphics_context_t* ctx;
+    const render_list_t* list;
+    render_rect_t damage;
+    uint32_t tiles_x;           // 每行瓦片数
+    int32_t origin_x, origin_y; // 第一块瓦片左上角（按瓦片网格对齐）
+} render_job_t;
+
+static render_op_t* render_add(render_list_t* list, render_op_type_t type,
+                               int32_t x, int32_t y, uint32_t width,
+                               uint32_t height, uint32_t color) {
+    if (list->count >= RENDER_MAX_OPS) {
+        return NULL;
+    }
+    render_op_t* op = &list->ops[list->count++];
+    op->type = type;
+    op->x = x;
+    op->y = y;
+    op->width = width;
+    op->height = height;
+    op->color = color;
+    op->text[0] = '\0';
+    return op;
+}
+
+void render_list_clear(render_list_t* list) {
+    list->count = 0;
+}
+
+void render_fill(render_list_t* list, int32_t x, int32_t y,
+                 uint32_t width, uint32_t height, uint32_t color) {
+    render_add(list, RENDER_OP_FILL, x, y, width, height, color);
+}
+
+void render_outline(render_list_t* list, int32_t x, int32_t y,
+                    uint32_t width, uint32_t height, uint32_t color) {
+    render_add(list, RENDER_OP_OUTLINE, x, y, width, height, color);
+}
+
+void render_hline(render_list_t* list, int32_t x, int32_t y,
+                  uint32_t length, uint32_t color) {
+    render_add(list, RENDER_OP_FILL, x, y, length, 1, color);
+}
+
+void render_vline(render_list_t* list, int32_t x, int32_t y,
+                  uint32_t length, uint32_t color) {
+    render_add(list, RENDER_OP_FILL, x, y, 1, length, color);
+}
+
+void render_text(render_list_t* list, int32_t x, int32_t y,
+                 const char* str, uint32_t color) {
+    // 包围盒与 draw_string 的排版一致：字宽 8 + 间距 1，行高 16 + 间距 2
+    uint32_t cols = 0, max_cols = 0, lines = 1;
+    for (const char* p = str; *p; p++) {
+        if (*p == '\n') {
+            lines++;
+            cols = 0;
+        } else if (++cols > max_cols) {
+            max_cols = cols;
+        }
+    }
+
+    render_op_t* op = render_add(list, RENDER_OP_TEXT, x, y,
+                                 max_cols * (FONT_WIDTH + 1),
+                                 lines * (FONT_HEIGHT + 2), color);
+    if (op) {
+        strlcpy(op->text, str, RENDER_TEXT_LEN);
+    }
+}
+
+/* 求交集，结果为空时返回 0 */
+static int rect_intersect(render_rect_t* out, const render_rect_t* a,
+                          const render_rect_t* b) {
+    out->x0 = a->x0 > b->x0 ? a->x0 : b->x0;
+    out->y0 = a->y0 > b->y0 ? a->y0 : b->y0;
+    out->x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    out->y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    return out->x0 < out->x1 && out->y0 < out->y1;
+}
+
+/* 在裁剪区内填充矩形 */
+static void fill_clipped(graphics_context_t* ctx, const graphics_ops_t* accel,
+                         const render_rect_t* clip, int32_t x, int32_t y,
+                         uint32_t w, uint32_t h, uint32_t color) {
+    render_rect_t r = { x, y, x + (int32_t)w, y + (int32_t)h };
+    render_rect_t c;
+    if (!rect_intersect(&c, &r, clip)) {
+        return;
+    }
+    if (accel && accel->fill_rect(ctx, c.x0, c.y0, c.x1 - c.x0, c.y1 - c.y0, color) == 0) {
+        return;
+    }
+
+    uint32_t stride = ctx->pitch / 4;
+    uint32_t* row = ctx->framebuffer + c.y0 * stride + c.x0;
+    uint32_t count = c.x1 - c.x0;
+    for (int32_t py = c.y0; py < c.y1; py++) {
+        cpu_dispatch.fill_span(row, color, count);
+        row += stride;
+    }
+}
+
+/* 在裁剪区内绘制单个字符 */
+static void glyph_clipped(graphics_context_t* ctx, const graphics_ops_t* accel,
+                          const render_rect_t* clip, int32_t x, int32_t y,
+                          char c, uint32_t color) {
+    render_rect_t r = { x, y, x + FONT_WIDTH, y + FONT_HEIGHT };
+    render_rect_t g;
+    if (!rect_intersect(&g, &r, clip)) {
+        return;
+    }
+
+    // 颜色扩展只能画完整的字形，被裁剪的字符仍由 CPU 绘制
+    const uint8_t* bits = font_data[(uint8_t)c & 0x7F];
+    if (accel && g.x0 == x && g.y0 == y && g.x1 == r.x1 && g.y1 == r.y1 &&
+        accel->expand_mono(ctx, x, y, FONT_WIDTH, FONT_HEIGHT, bits, color) == 0) {
+        return;
+    }
+
+    uint32_t stride = ctx->pitch / 4;
+    for (int32_t py = g.y0; py < g.y1; py++) {
+        uint8_t line = bits[py - y];
+        uint32_t* row = ctx->framebuffer + py * stride;
+        for (int32_t px = g.x0; px < g.x1; px++) {
+            if (line & (0x80 >> (px - x))) {
+                row[px] = color;
+            }
+        }
+    }
+}
+
+static void draw_op(graphics_context_t* ctx, const graphics_ops_t* accel,
+                    const render_rect_t* clip, const render_op_t* op) {
+    switch (op->type) {
+        case RENDER_OP_FILL:
+            fill_clipped(ctx, accel, clip, op->x, op->y, op->width, op->height, op->color);
+            break;
+        case RENDER_OP_OUTLINE:
+            fill_clipped(ctx, accel, clip, op->x, op->y, op->width, 1, op->color);
+            fill_clipped(ctx, accel, clip, op->x, op->y + op->height - 1, op->width, 1, op->color);
+            fill_clipped(ctx, accel, clip, op->x, op->y, 1, op->height, op->color);
+            fill_clipped(ctx, accel, clip, op->x + op->width - 1, op->y, 1, op->height, op->color);
+            break;
+        case RENDER_OP_TEXT: {
+            int32_t cx = op->x, cy = op->y;
+            for (const char* p = op->text; *p; p++) {
+                if (*p == '\n') {
+                    cy += FONT_HEIGHT + 2;
+                    cx = op->x;
+                } else {
+                    glyph_clipped(ctx, accel, clip, cx, cy, *p, op->color);
+                    cx += FONT_WIDTH + 1;
+                }
+            }
+            break;
+        }
+    }
+}
+
+/* 瓦片任务：在一块瓦片内按顺序绘制所有相交的操作 */
+static void render_tiles(void* arg, uint32_t begin, uint32_t end) {
+    render_job_t* job = (render_job_t*)arg;
+
+    for (uint32_t i = begin; i < end; i++) {
+        int32_t tx = job->origin_x + (int32_t)(i % job->tiles_x) * RENDER_TILE_SIZE;
+        int32_t ty = job->origin_y + (int32_t)(i / job->tiles_x) * RENDER_TILE_SIZE;
+        render_rect_t tile = { tx, ty, tx + RENDER_TILE_SIZE, ty + RENDER_TILE_SIZE };
+        render_rect_t clip;
+        if (!rect_intersect(&clip, &tile, &job->damage)) {
+            continue;
+        }
+
+        for (uint32_t n = 0; n < job->list->count; n++) {
+            const render_op_t* op = &job->list->ops[n];
+            render_rect_t bounds = { op->x, op->y,
+                                     op->x + (int32_t)op->width,
+                                     op->y + (int32_t)op->height };
+            render_rect_t hit;
+            if (rect_intersect(&hit, &bounds, &clip)) {
+                draw_op(job->ctx, NULL, &clip, op);
+            }
+        }
+    }
+}
+
+void render_damage(graphics_context_t* ctx, const render_list_t* list,
+                   int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    if (!ctx || ctx->bpp != 32) {
+        return;
+    }
+
+    render_rect_t screen = { 0, 0, (int32_t)ctx->width, (int32_t)ctx->height };
+    render_rect_t damage = { x, y, x + (int32_t)width, y + (int32_t)height };
+
+    render_job_t job;
+    job.ctx = ctx;
+    job.list = list;
+    if (!rect_intersect(&job.damage, &damage, &screen)) {
+        return;
+    }
+
+    // 有 2D 引擎时不拆分瓦片：每个操作对整个损坏区域顺序下发一次，CPU 不再搬运像素
+    const graphics_ops_t* accel = graphics_accel(ctx);
+    if (accel) {
+        for (uint32_t n = 0; n < list->count; n++) {
+            draw_op(ctx, accel, &job.damage, &list->ops[n]);
+        }
+        return;
+    }
+
+    // 瓦片按屏幕网格对齐，相邻的损坏区域不会在同一行缓存上重复写
+    job.origin_x = job.damage.x0 & ~(RENDER_TILE_SIZE - 1);
+    job.origin_y = job.damage.y0 & ~(RENDER_TILE_SIZE - 1);
+    job.tiles_x = (job.damage.x1 - job.origin_x + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+    uint32_t tiles_y = (job.damage.y1 - job.origin_y + RENDER_TILE_SIZE - 1) / RENDER_TILE_SIZE;
+
+    parallel_for(0, job.tiles_x * tiles_y, 1, render_tiles, &job);
+}
@@ -0,0 +1,207 @@
+#include <kernel/smp.h>
+#include <kernel/percpu.h>
+#include <kernel/acpi.h>
+#include <kernel/apic.h>
+#include <kernel/gdt.h>
+#include <kernel/idt.h>
+#include <kernel/io.h>
+#include <kernel/tsc.h>
+#include <kernel/timer.h>
+#include <kernel/thread.h>
+#include <kernel/string.h>
+#include <kernel/bootprof.h>
+#include <kernel/paging.h>
+#include <kernel/syscall.h>
+#include <kernel/fpu.h>
+
+/* 蹦床代码（trampoline.asm） */
+extern uint8_t ap_trampoline_start[];
+extern uint8_t ap_trampoline_end[];
+extern uint8_t ap_stack[];
+extern uint8_t ap_entry[];
+
+/* AP 等待上线的超时时间（微秒） */
+#define AP_BOOT_TIMEOUT_US 100000
+
+cpu_t cpus[MAX_CPUS];
+volatile uint32_t cpu_count = 1;
+
+/* AP 启动栈（BSP 使用 boot.asm 中的启动栈） */
+static uint8_t ap_stacks[MAX_CPUS][CPU_STACK_SIZE] __attribute__((aligned(16)));
+
+/* 正在启动的 AP 的逻辑编号，一次只启动一个 */
+static volatile uint32_t ap_boot_id = 0;
+
+/* 启动握手：AP 进入 ap_main 时抢占 RUNNING，BSP 超时后抢占 ABANDONED，
+ * 只有一方能成功，迟到的 AP 不会再使用已被改写的 ap_boot_id 和栈 */
+#define AP_BOOT_WAITING   0
+#define AP_BOOT_RUNNING   1
+#define AP_BOOT_ABANDONED 2
+static volatile uint32_t ap_boot_state = AP_BOOT_WAITING;
+
+void percpu_init(uint32_t id) {
+    cpu_t *cpu = &cpus[id];
+
+    // 启动失败的槽位会被下一个 AP 复用，运行队列锁只初始化一次
+    if (cpu->self == cpu) {
+        return;
+    }
+
+    cpu->self = cpu;
+    cpu->id = id;
+    spin_lock_init(&cpu->rq.lock, "runqueue");
+
+    // BSP 在调用时即已运行
+    if (id == 0) {
+        cpu->online = 1;
+    }
+}
+
+uint32_t smp_cpu_count(void) {
+    return cpu_count;
+}
+
+/* 本地 APIC 定时器：AP 的调度时钟（BSP 仍由 PIT 驱动） */
+static void lapic_timer_handler(struct registers *regs) {
+    lapic_eoi();
+    thread_tick(timer_get_ticks());
+    thread_preempt();
+}
+
+/* 重新调度 IPI：发送方已设置 need_resched */
+static void resched_ipi_handler(struct registers *regs) {
+    lapic_eoi();
+    thread_preempt();
+}
+
+/* 伪中断不需要 EOI */
+static void spurious_handler(struct registers *regs) {
+}
+
+/* AP 的 C 入口，运行在 ap_stacks 上 */
+static void ap_main(void) {
+    uint32_t expected = AP_BOOT_WAITING;
+    if (!__atomic_compare_exchange_n(&ap_boot_state, &expected, AP_BOOT_RUNNING,
+                                     0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // BSP 已放弃本次启动，停在这里等待 INIT
+        for (;;) {
+            __asm__ volatile("cli; hlt");
+        }
+    }
+
+    uint32_t id = ap_boot_id;
+    cpu_t *cpu = &cpus[id];
+
+    // 加载本 CPU 的 GDT/TSS 后 this_cpu() 才可用
+    gdt_init_cpu(id);
+    idt_load();
+    paging_init_ap();
+    syscall_init_ap();
+
+    lapic_init();
+    thread_init_ap();
+    fpu_init_ap();
+    lapic_timer_init(TIMER_HZ);
+
+    __atomic_store_n(&cpu->online, 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&cpu_count, 1, __ATOMIC_RELAXED);
+
+    thread_run_idle();
+}
+
+/* 启动单个 AP：INIT-SIPI-SIPI，成功返回 1 */
+static int smp_boot_ap(uint32_t id, uint32_t apic_id) {
+    cpu_t *cpu = &cpus[id];
+
+    percpu_init(id);
+    cpu->apic_id = apic_id;
+    cpu->stack_top = (uint32_t)(ap_stacks[id] + CPU_STACK_SIZE);
+
+    // 填写蹦床中的栈和入口（写入复制后的副本）
+    uint8_t *tramp = (uint8_t *)TRAMPOLINE_BASE;
+    *(uint32_t *)(tramp + (ap_stack - ap_trampoline_start)) = cpu->stack_top;
+    *(uint32_t *)(tramp + (ap_entry - ap_trampoline_start)) = (uint32_t)ap_main;
+    ap_boot_id = id;
+    __atomic_store_n(&ap_boot_state, AP_BOOT_WAITING, __ATOMIC_RELEASE);
+
+    lapic_send_init(apic_id);
+    tsc_delay_us(10000);
+
+    for (int i = 0; i < 2 && !cpu->online; i++) {
+        lapic_send_sipi(apic_id, TRAMPOLINE_BASE >> 12);
+        tsc_delay_us(200);
+    }
+
+    for (uint32_t waited = 0; waited < AP_BOOT_TIMEOUT_US; waited += 100) {
+        if (__atomic_load_n(&cpu->online, __ATOMIC_ACQUIRE)) {
+            return 1;
+        }
+        tsc_delay_us(100);
+    }
+
+    // 超时：若 AP 已进入 ap_main 则等它完成上线，否则放弃并用 INIT 停住它，
+    // 之后才能改写蹦床并把这个编号交给下一个 AP
+    uint32_t expected = AP_BOOT_WAITING;
+    if (!__atomic_compare_exchange_n(&ap_boot_state, &expected, AP_BOOT_ABANDONED,
+                                     0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        while (!__atomic_load_n(&cpu->online, __ATOMIC_ACQUIRE)) {
+            __asm__ volatile("pause");
+        }
+        return 1;
+    }
+    lapic_send_init(apic_id);
+    tsc_delay_us(10000);
+    return 0;
+}
+
+void smp_init(const void *rsdp) {
+    acpi_madt_info_t madt;
+    char buf[16];
+
+    if (!acpi_init((const acpi_rsdp_t *)rsdp) || !acpi_parse_madt(&madt)) {
+        serial_puts("SMP: no MADT, running on the boot CPU only\n");
+        return;
+    }
+
+    lapic_set_base(madt.lapic_address);
+    lapic_init();
+    cpus[0].apic_id = lapic_id();
+
+    register_interrupt_handler(LAPIC_TIMER_VECTOR, lapic_timer_handler);
+    register_interrupt_handler(IPI_RESCHED_VECTOR, resched_ipi_handler);
+    register_interrupt_handler(LAPIC_SPURIOUS_VECTOR, spurious_handler);
+
+    memcpy((void *)TRAMPOLINE_BASE, ap_trampoline_start,
+           ap_trampoline_end - ap_trampoline_start);
+
+    uint32_t next_id = 1;
+    for (uint32_t i = 0; i < madt.cpu_count && next_id < MAX_CPUS; i++) {
+        uint32_t apic_id = madt.apic_ids[i];
+        if (apic_id == cpus[0].apic_id) {
+            continue;
+        }
+
+        if (smp_boot_ap(next_id, apic_id)) {
+            if (!boot_quiet) {
+                serial_puts("CPU ");
+                utoa(next_id, buf, 10);
+                serial_puts(buf);
+                serial_puts(" online (APIC ID ");
+                utoa(apic_id, buf, 10);
+                serial_puts(buf);
+                serial_puts(")\n");
+            }
+            next_id++;
+        } else {
+            serial_puts("SMP: APIC ID ");
+            utoa(apic_id, buf, 10);
+            serial_puts(buf);
+            serial_puts(" did not start\n");
+        }
+    }
+
+    serial_puts("SMP: ");
+    utoa(cpu_count, buf, 10);
+    serial_puts(buf);
+    serial_puts(" CPU(s) online\n");
+}
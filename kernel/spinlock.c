@@ -0,0 +1,92 @@
+#include <kernel/spinlock.h>
+#include <kernel/io.h>
+#include <kernel/string.h>
+
+/* 已登记的锁统计链表（登记只发生在初始化阶段，不会与遍历并发） */
+static lock_stats_t *stats_head = 0;
+static lock_stats_t *stats_tail = 0;
+static volatile uint32_t registry_lock = 0;
+
+void lock_stats_register(lock_stats_t *stats, const char *name) {
+    uint32_t flags = irq_save();
+    while (__atomic_exchange_n(&registry_lock, 1, __ATOMIC_ACQUIRE)) {
+        asm volatile ("pause");
+    }
+
+    // 重复初始化同一把锁时只更新名字，再次链入会在链表中形成环
+    for (lock_stats_t *s = stats_head; s; s = s->next) {
+        if (s == stats) {
+            stats->name = name;
+            __atomic_store_n(&registry_lock, 0, __ATOMIC_RELEASE);
+            irq_restore(flags);
+            return;
+        }
+    }
+
+    stats->name = name;
+    stats->acquired = 0;
+    stats->contended = 0;
+    stats->spin_cycles = 0;
+    stats->next = 0;
+
+    // 按登记顺序输出
+    if (stats_tail) {
+        stats_tail->next = stats;
+    } else {
+        stats_head = stats;
+    }
+    stats_tail = stats;
+
+    __atomic_store_n(&registry_lock, 0, __ATOMIC_RELEASE);
+    irq_restore(flags);
+}
+
+/* 左对齐输出到固定宽度 */
+static void put_padded(const char *s, uint32_t width) {
+    uint32_t len = strlen(s);
+    serial_puts(s);
+    while (len++ < width) {
+        serial_putc(' ');
+    }
+}
+
+void lock_stats_report(void) {
+    char buf[16];
+
+#if CONFIG_LOCK_STATS
+    serial_puts("\n=== Lock statistics ===\n");
+    put_padded("lock", 20);
+    put_padded("acquired", 12);
+    put_padded("contended", 12);
+    serial_puts("avg wait (cycles)\n");
+
+    for (lock_stats_t *s = stats_head; s; s = s->next) {
+        // 统计值可能正在被其他 CPU 更新，这里只取近似快照
+        uint32_t acquired = s->acquired;
+        uint32_t contended = s->contended;
+        uint64_t cycles = s->spin_cycles;
+
+        put_padded(s->name, 20);
+        utoa(acquired, buf, 10);
+        put_padded(buf, 12);
+        utoa(contended, buf, 10);
+        put_padded(buf, 12);
+
+        // 没有 64 位除法，按周期数右移到 32 位范围再除
+        uint32_t avg = 0;
+        if (contended) {
+            uint32_t shift = 0;
+            while ((cycles >> shift) > 0xFFFFFFFFull) {
+                shift++;
+            }
+            avg = ((uint32_t)(cycles >> shift) / contended) << shift;
+        }
+        utoa(avg, buf, 10);
+        serial_puts(buf);
+        serial_puts("\n");
+    }
+    serial_puts("=======================\n");
+#else
+    serial_puts("Lock statistics disabled (CONFIG_LOCK_STATS=0)\n");
+#endif
+}
@@ -1,4 +1,8 @@
 #include <kernel/string.h>
+#include <kernel/io.h>
+#include <kernel/bootprof.h>
+#include <kernel/fpu.h>
+#include <kernel/cpu_features.h>
 
 size_t strlen(const char* str) {
     size_t len = 0;
@@ -6,39 +10,284 @@ size_t strlen(const char* str) {
     return len;
 }
 
+/* 小于该长度时不值得做对齐处理 */
+#define STRING_SMALL    16
+
+/* 非临时拷贝的最小长度与每次关中断处理的块大小 */
+#define STRING_NT_MIN   256
+#define STRING_NT_CHUNK 4096
+
+static inline void rep_movsb(void* dest, const void* src, size_t n) {
+    asm volatile("rep movsb" : "+D"(dest), "+S"(src), "+c"(n) : : "memory");
+}
+
+static inline void rep_stosb(void* dest, uint8_t value, size_t n) {
+    asm volatile("rep stosb" : "+D"(dest), "+c"(n) : "a"(value) : "memory");
+}
+
 void* memset(void* ptr, uint8_t value, size_t num) {
-    uint8_t* p = (uint8_t*)ptr;
-    for (size_t i = 0; i < num; i++) {
-        p[i] = value;
+    if (cpu_has(CPU_FEATURE_ERMS) || num < STRING_SMALL) {
+        rep_stosb(ptr, value, num);
+        return ptr;
     }
+
+    // 先按字节对齐目标地址，再整字填充，最后处理尾部
+    uint8_t* p = (uint8_t*)ptr;
+    size_t head = (-(uintptr_t)p) & 3;
+    rep_stosb(p, value, head);
+    p += head;
+    num -= head;
+
+    size_t words = num >> 2;
+    uint32_t pattern = value * 0x01010101u;
+    asm volatile("rep stosl" : "+D"(p), "+c"(words) : "a"(pattern) : "memory");
+
+    rep_stosb(p, value, num & 3);
     return ptr;
 }
 
-void* memcpy(void* dest, const void* src, size_t num) {
-    uint8_t* d = (uint8_t*)dest;
-    const uint8_t* s = (const uint8_t*)src;
-    for (size_t i = 0; i < num; i++) {
-        d[i] = s[i];
+/* 按字复制：对齐目标后 rep movsd，再处理尾部 */
+static inline void copy_forward_words(uint8_t* d, const uint8_t* s, size_t num) {
+    if (num < STRING_SMALL) {
+        rep_movsb(d, s, num);
+        return;
     }
+
+    size_t head = (-(uintptr_t)d) & 3;
+    rep_movsb(d, s, head);
+    d += head;
+    s += head;
+    num -= head;
+
+    size_t words = num >> 2;
+    asm volatile("rep movsl" : "+D"(d), "+S"(s), "+c"(words) : : "memory");
+
+    rep_movsb(d, s, num & 3);
+}
+
+/* 向前复制，memmove 与 memcpy_nt 的非 SIMD 部分共用 */
+static inline void copy_forward(uint8_t* d, const uint8_t* s, size_t num) {
+    if (cpu_has(CPU_FEATURE_ERMS)) {
+        rep_movsb(d, s, num);
+    } else {
+        copy_forward_words(d, s, num);
+    }
+}
+
+void* memcpy_rep_movsd(void* dest, const void* src, size_t num) {
+    copy_forward_words((uint8_t*)dest, (const uint8_t*)src, num);
+    return dest;
+}
+
+void* memcpy_rep_movsb(void* dest, const void* src, size_t num) {
+    rep_movsb(dest, src, num);
     return dest;
 }
 
+/* 实现由 cpu_dispatch_init 选择 */
+void* memcpy(void* dest, const void* src, size_t num) {
+    return cpu_dispatch.memcpy(dest, src, num);
+}
+
 void* memmove(void* dest, const void* src, size_t num) {
     uint8_t* d = (uint8_t*)dest;
     const uint8_t* s = (const uint8_t*)src;
     
-    if (d < s) {
-        for (size_t i = 0; i < num; i++) {
-            d[i] = s[i];
-        }
+    // 目标在源之前或不重叠时向前复制是安全的
+    if (d <= s || d >= s + num) {
+        copy_forward(d, s, num);
+        return dest;
+    }
+
+    // 从末尾向后复制：先复制不足一个字的尾部，再整字复制。
+    // 中断入口会执行 cld，所以这里置位 DF 不会影响中断处理程序
+    size_t tail = num & 3;
+    size_t words = num >> 2;
+    const uint8_t* sp = s + num - 1;
+    uint8_t* dp = d + num - 1;
+    asm volatile(
+        "std\n\t"
+        "rep movsb\n\t"
+        "subl $3, %%esi\n\t"
+        "subl $3, %%edi\n\t"
+        "movl %3, %%ecx\n\t"
+        "rep movsl\n\t"
+        "cld"
+        : "+S"(sp), "+D"(dp), "+c"(tail)
+        : "r"(words)
+        : "memory");
+    return dest;
+}
+
+/* SSE2 非临时拷贝：绕过缓存直接写入，用于帧缓冲等只写不读的目标。
+ * 可能在中断上下文中调用，所以用 kernel_fpu_begin/end 包住每一块，而不是依赖 #NM 惰性切换 */
+static void memcpy_nt_sse2(uint8_t* d, const uint8_t* s, size_t num) {
+    // 目标按 16 字节对齐
+    size_t head = (-(uintptr_t)d) & 15;
+    copy_forward(d, s, head);
+    d += head;
+    s += head;
+    num -= head;
+
+    while (num >= 64) {
+        size_t chunk = num < STRING_NT_CHUNK ? num & ~(size_t)63 : STRING_NT_CHUNK;
+        size_t blocks = chunk >> 6;
+
+        uint32_t flags = kernel_fpu_begin();
+        asm volatile(
+            "1:\n\t"
+            "movdqu   (%1), %%xmm0\n\t"
+            "movdqu 16(%1), %%xmm1\n\t"
+            "movdqu 32(%1), %%xmm2\n\t"
+            "movdqu 48(%1), %%xmm3\n\t"
+            "movntdq %%xmm0,   (%0)\n\t"
+            "movntdq %%xmm1, 16(%0)\n\t"
+            "movntdq %%xmm2, 32(%0)\n\t"
+            "movntdq %%xmm3, 48(%0)\n\t"
+            "addl $64, %0\n\t"
+            "addl $64, %1\n\t"
+            "decl %2\n\t"
+            "jnz 1b\n\t"
+            "sfence"
+            : "+r"(d), "+r"(s), "+r"(blocks)
+            :
+            : "memory");  // 编译选项未启用 SSE，编译器不会使用 XMM 寄存器，无需声明破坏
+        kernel_fpu_end(flags);
+
+        num -= chunk;
+    }
+
+    copy_forward(d, s, num);
+}
+
+void* memcpy_nt(void* dest, const void* src, size_t num) {
+    // 需要 fpu_init 已开启 CR4.OSFXSR
+    if (num >= STRING_NT_MIN && cpu_has(CPU_FEATURE_SSE2) && fpu_sse_enabled()) {
+        memcpy_nt_sse2((uint8_t*)dest, (const uint8_t*)src, num);
     } else {
-        for (size_t i = num; i > 0; i--) {
-            d[i-1] = s[i-1];
-        }
+        copy_forward((uint8_t*)dest, (const uint8_t*)src, num);
     }
     return dest;
 }
 
+#if CONFIG_STRING_SELFTEST
+/* 自检缓冲区：源、目标与参照结果 */
+#define SELFTEST_BUF 1024
+static uint8_t test_src[SELFTEST_BUF];
+static uint8_t test_dst[SELFTEST_BUF];
+static uint8_t test_ref[SELFTEST_BUF];
+
+/* 自检覆盖的长度：逐一覆盖小长度，再加上块边界附近的长度 */
+static const uint16_t selftest_lengths[] = {
+    0, 1, 2, 3, 4, 5, 7, 8, 15, 16, 17, 63, 64, 65, 255, 256, 257, 331
+};
+
+static void fill_pattern(uint8_t* buf, size_t n, uint32_t seed) {
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+static int buffers_equal(const uint8_t* a, const uint8_t* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void selftest_fail(const char* what, uint32_t dst_off, uint32_t src_off, uint32_t len) {
+    char buf[12];
+    serial_puts("string: self-test FAILED: ");
+    serial_puts(what);
+    serial_puts(" dst+");
+    utoa(dst_off, buf, 10);
+    serial_puts(buf);
+    serial_puts(" src+");
+    utoa(src_off, buf, 10);
+    serial_puts(buf);
+    serial_puts(" len ");
+    utoa(len, buf, 10);
+    serial_puts(buf);
+    serial_puts("\n");
+}
+
+/* 与逐字节参照实现比较：所有对齐组合、重叠方向，并检查目标区域外没有被写坏 */
+int string_selftest(void) {
+    uint32_t cases = 0;
+    uint32_t n = sizeof(selftest_lengths) / sizeof(selftest_lengths[0]);
+
+    for (uint32_t li = 0; li < n; li++) {
+        uint32_t len = selftest_lengths[li];
+        // 所有写入都落在 [0, len + 176) 内，多比较一段用来发现越界写
+        uint32_t w = len + 192;
+        for (uint32_t doff = 0; doff < 16; doff++) {
+            for (uint32_t soff = 0; soff < 16; soff++) {
+                // memcpy / memcpy_nt：不重叠
+                fill_pattern(test_src, w, len + soff);
+                fill_pattern(test_dst, w, doff);
+                for (uint32_t i = 0; i < w; i++) test_ref[i] = test_dst[i];
+                for (uint32_t i = 0; i < len; i++) test_ref[doff + i] = test_src[soff + i];
+
+                memcpy(test_dst + doff, test_src + soff, len);
+                if (!buffers_equal(test_dst, test_ref, w)) {
+                    selftest_fail("memcpy", doff, soff, len);
+                    return -1;
+                }
+
+                fill_pattern(test_dst, w, doff);
+                memcpy_nt(test_dst + doff, test_src + soff, len);
+                if (!buffers_equal(test_dst, test_ref, w)) {
+                    selftest_fail("memcpy_nt", doff, soff, len);
+                    return -1;
+                }
+
+                // memmove：同一缓冲区内两个方向的重叠
+                uint32_t base = 160;
+                for (int dir = 0; dir < 2; dir++) {
+                    uint32_t d = dir ? base + doff : base - doff;
+                    uint32_t s = dir ? base - soff : base + soff;
+                    fill_pattern(test_dst, w, len ^ doff);
+                    for (uint32_t i = 0; i < w; i++) test_ref[i] = test_dst[i];
+                    for (uint32_t i = 0; i < len; i++) test_src[i] = test_ref[s + i];
+                    for (uint32_t i = 0; i < len; i++) test_ref[d + i] = test_src[i];
+
+                    memmove(test_dst + d, test_dst + s, len);
+                    if (!buffers_equal(test_dst, test_ref, w)) {
+                        selftest_fail("memmove", d, s, len);
+                        return -1;
+                    }
+                }
+
+                cases += 4;
+            }
+
+            // memset 只与目标对齐有关
+            fill_pattern(test_dst, w, len);
+            for (uint32_t i = 0; i < w; i++) test_ref[i] = test_dst[i];
+            for (uint32_t i = 0; i < len; i++) test_ref[doff + i] = (uint8_t)(0xA5 + len);
+            memset(test_dst + doff, (uint8_t)(0xA5 + len), len);
+            if (!buffers_equal(test_dst, test_ref, w)) {
+                selftest_fail("memset", doff, 0, len);
+                return -1;
+            }
+            cases++;
+        }
+    }
+
+    if (!boot_quiet) {
+        char buf[12];
+        utoa(cases, buf, 10);
+        serial_puts("string: self-test passed (");
+        serial_puts(buf);
+        serial_puts(" cases)\n");
+    }
+    return 0;
+}
+#endif
+
 int memcmp(const void* ptr1, const void* ptr2, size_t num) {
     const uint8_t* p1 = (const uint8_t*)ptr1;
     const uint8_t* p2 = (const uint8_t*)ptr2;
@@ -66,7 +315,8 @@ char* strcpy(char* dest, const char* src) {
 
 char* strncpy(char* dest, const char* src, size_t n) {
     char* save = dest;
-    while (n && (*dest++ = *src++)) n--;
+    // 源串较短时剩余部分补 0，总共恰好写 n 个字节
+    for (; n && *src; n--) *dest++ = *src++;
     while (n--) *dest++ = '\0';
     return save;
 }
@@ -78,7 +328,7 @@ size_t strlcpy(char* dest, const char* src, size_t n) {
     
     if (n == 0) return len;
     
-    while (--n && (*d++ = *s++));
+    while (--n && *s) *d++ = *s++;
     *d = '\0';
     
     return len;
@@ -94,12 +344,13 @@ char* strcat(char* dest, const char* src) {
 char* strncat(char* dest, const char* src, size_t n) {
     char* save = dest;
     while (*dest) dest++;
-    while (n-- && (*dest++ = *src++));
+    // 最多追加 n 个字符再加结尾的 '\0'
+    for (; n && *src; n--) *dest++ = *src++;
     *dest = '\0';
     return save;
 }
 
-/* 查找字符 */
+/* 查找字符（与 C 标准一致，c 为 '\0' 时返回结尾） */
 char* strchr(const char* str, int c) {
     while (*str) {
         if (*str == (char)c) {
@@ -107,7 +358,7 @@ char* strchr(const char* str, int c) {
         }
         str++;
     }
-    return NULL;
+    return (char)c == '\0' ? (char*)str : NULL;
 }
 
 char* strrchr(const char* str, int c) {
@@ -118,7 +369,7 @@ char* strrchr(const char* str, int c) {
         }
         str++;
     }
-    return (char*)last;
+    return (char)c == '\0' ? (char*)str : (char*)last;
 }
 
 /* 字符串分割 */
@@ -163,28 +414,13 @@ void itoa(int value, char* str, int base) {
         return;
     }
     
-    char* ptr = str, *ptr1 = str, tmp_char;
-    int tmp_value;
-    
-    /* 处理负数 */
+    /* 十进制负数输出负号；按无符号取绝对值，INT_MIN 也不会溢出。
+     * 其他进制按 32 位补码输出 */
     if (value < 0 && base == 10) {
-        *ptr++ = '-';
-        value = -value;
-    }
-    
-    do {
-        tmp_value = value % base;
-        value /= base;
-        *ptr++ = "0123456789abcdefghijklmnopqrstuvwxyz"[tmp_value];
-    } while (value);
-    
-    *ptr-- = '\0';
-    
-    /* 反转字符串 */
-    while (ptr1 < ptr) {
-        tmp_char = *ptr;
-        *ptr-- = *ptr1;
-        *ptr1++ = tmp_char;
+        *str++ = '-';
+        utoa(-(uint32_t)value, str, base);
+    } else {
+        utoa((uint32_t)value, str, base);
     }
 }
 
@@ -247,79 +483,146 @@ void string_append(char* dest, const char* src) {
     while ((*dest++ = *src++));
 }
 
-/* 格式化字符串（简化版） */
-int vsnprintf(char* str, size_t size, const char* format, va_list args) {
-    // 简化实现，只处理 %s, %d, %u, %x
-    char buffer[32];
+/* 整数格式化不用除法：十六进制按半字节移位，十进制用乘以 0xCCCCCCCD 再右移 35 位代替除以 10
+ * （32x32->64 位乘法是单条 mul 指令，不依赖 libgcc）。从 end 向前写，返回第一个字符 */
+static char* fmt_hex(char* end, uint32_t value, int upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    do {
+        *--end = digits[value & 0xF];
+        value >>= 4;
+    } while (value);
+    return end;
+}
+
+static char* fmt_dec(char* end, uint32_t value) {
+    do {
+        uint32_t q = (uint32_t)(((uint64_t)value * 0xCCCCCCCDu) >> 35);
+        *--end = (char)('0' + (value - q * 10));
+        value = q;
+    } while (value);
+    return end;
+}
+
+/* 支持 %s %c %d %i %u %x %X %p %%，以及 '-'、'0' 标志和宽度；'l' 修饰符被忽略（long 为 32 位）。
+ * 丢弃输出的前 skip 个字符，输出被截断时返回实际写入的长度 */
+#define FMT_PUT(c) do { if (skip) skip--; else *p++ = (c); } while (0)
+
+int vsnprintf_skip(char* str, size_t size, size_t skip, const char* format, va_list args) {
+    char buffer[12];
     char* p = str;
-    size_t remaining = size;
-    
-    while (*format && remaining > 1) {
-        if (*format == '%') {
+    char* end = size ? str + size - 1 : str;
+
+    while (*format && p < end) {
+        if (*format != '%') {
+            FMT_PUT(*format); format++;
+            continue;
+        }
+        format++;
+
+        int left = 0;
+        char pad = ' ';
+        for (;; format++) {
+            if (*format == '-') {
+                left = 1;
+            } else if (*format == '0') {
+                pad = '0';
+            } else {
+                break;
+            }
+        }
+        uint32_t width = 0;
+        while (*format >= '0' && *format <= '9') {
+            width = width * 10 + (*format++ - '0');
+        }
+        while (*format == 'l') {
             format++;
-            switch (*format) {
-                case 's': {
-                    const char* s = va_arg(args, const char*);
-                    size_t len = strlen(s);
-                    if (len >= remaining) len = remaining - 1;
-                    memcpy(p, s, len);
-                    p += len;
-                    remaining -= len;
-                    break;
-                }
-                case 'd': {
-                    int n = va_arg(args, int);
-                    itoa(n, buffer, 10);
-                    size_t len = strlen(buffer);
-                    if (len >= remaining) len = remaining - 1;
-                    memcpy(p, buffer, len);
-                    p += len;
-                    remaining -= len;
-                    break;
-                }
-                case 'u': {
-                    uint32_t n = va_arg(args, uint32_t);
-                    utoa(n, buffer, 10);
-                    size_t len = strlen(buffer);
-                    if (len >= remaining) len = remaining - 1;
-                    memcpy(p, buffer, len);
-                    p += len;
-                    remaining -= len;
-                    break;
-                }
-                case 'x': {
-                    uint32_t n = va_arg(args, uint32_t);
-                    utoa(n, buffer, 16);
-                    size_t len = strlen(buffer);
-                    if (len >= remaining) len = remaining - 1;
-                    memcpy(p, buffer, len);
-                    p += len;
-                    remaining -= len;
-                    break;
-                }
-                case '%': {
-                    *p++ = '%';
-                    remaining--;
-                    break;
+        }
+
+        const char* s = buffer + sizeof(buffer);
+        const char* e = s;
+        const char* prefix = "";
+        switch (*format) {
+            case 's':
+                s = va_arg(args, const char*);
+                if (!s) s = "(null)";
+                e = s + strlen(s);
+                break;
+            case 'c':
+                buffer[0] = (char)va_arg(args, int);
+                s = buffer;
+                e = buffer + 1;
+                break;
+            case 'd':
+            case 'i': {
+                int n = va_arg(args, int);
+                if (n < 0) {
+                    prefix = "-";
+                    s = fmt_dec(buffer + sizeof(buffer), -(uint32_t)n);
+                } else {
+                    s = fmt_dec(buffer + sizeof(buffer), n);
                 }
-                default:
-                    /* 未知格式，跳过 */
-                    break;
+                break;
             }
-            format++;
-        } else {
-            *p++ = *format++;
-            remaining--;
+            case 'u':
+                s = fmt_dec(buffer + sizeof(buffer), va_arg(args, uint32_t));
+                break;
+            case 'x':
+            case 'X':
+                s = fmt_hex(buffer + sizeof(buffer), va_arg(args, uint32_t), *format == 'X');
+                break;
+            case 'p':
+                // 固定 "0x" 加 8 位，便于对齐
+                prefix = "0x";
+                pad = '0';
+                width = 10;
+                s = fmt_hex(buffer + sizeof(buffer), (uint32_t)va_arg(args, void*), 0);
+                break;
+            case '%':
+                buffer[0] = '%';
+                s = buffer;
+                e = buffer + 1;
+                break;
+            case '\0':
+                continue;
+            default:
+                /* 未知格式，跳过 */
+                format++;
+                continue;
+        }
+        format++;
+
+        uint32_t len = (e - s) + strlen(prefix);
+        uint32_t fill = width > len ? width - len : 0;
+
+        // 前缀（负号或 "0x"）在补零之前、补空格之后
+        if (pad == ' ' && !left) {
+            while (fill && p < end) { FMT_PUT(' '); fill--; }
+        }
+        while (*prefix && p < end) {
+            FMT_PUT(*prefix); prefix++;
+        }
+        if (!left) {
+            while (fill && p < end) { FMT_PUT(pad); fill--; }
+        }
+        while (s < e && p < end) {
+            FMT_PUT(*s); s++;
         }
+        while (fill && p < end) { FMT_PUT(' '); fill--; }
     }
-    
+
     if (size > 0) {
         *p = '\0';
     }
-    
+
     return p - str;
 }
 
+#undef FMT_PUT
+
+int vsnprintf(char* str, size_t size, const char* format, va_list args) {
+    return vsnprintf_skip(str, size, 0, format, args);
+}
+
 int snprintf(char* str, size_t size, const char* format, ...) {
     va_list args;
     va_start(args, format);
@@ -0,0 +1,388 @@
+#include <kernel/surface.h>
+#include <kernel/paging.h>
+#include <kernel/graphics.h>
+#include <kernel/cpu_features.h>
+#include <kernel/mouse.h>
+#include <kernel/event.h>
+#include <kernel/spinlock.h>
+#include <kernel/string.h>
+#include <kernel/trace.h>
+#include <stddef.h>
+
+extern graphics_context_t gfx_ctx;
+extern uint8_t graphics_enabled;
+
+/* 表面内存：静态、物理连续，内核合成时可按行直接读取 */
+static uint8_t surface_pool[SURFACE_MAX][SURFACE_SLOT_SIZE] __attribute__((aligned(PAGE_SIZE)));
+static surface_t surfaces[SURFACE_MAX];
+static spinlock_t surface_lock = SPINLOCK_INIT;
+
+/* 鼠标指针尺寸（与 mouse.c 一致） */
+#define CURSOR_SIZE 16
+
+/* 屏幕坐标中的矩形，[x0, x1) x [y0, y1) */
+typedef struct {
+    int32_t x0, y0, x1, y1;
+} screen_rect_t;
+
+/* 表面在 (x, y) 时落在屏幕内的部分，返回是否非空 */
+static int visible_rect(const surface_t *surf, int32_t x, int32_t y, screen_rect_t *r) {
+    r->x0 = x < 0 ? 0 : x;
+    r->y0 = y < 0 ? 0 : y;
+    r->x1 = x + (int32_t)surf->width;
+    r->y1 = y + (int32_t)surf->height;
+    if (r->x1 > (int32_t)gfx_ctx.width) r->x1 = gfx_ctx.width;
+    if (r->y1 > (int32_t)gfx_ctx.height) r->y1 = gfx_ctx.height;
+    return r->x0 < r->x1 && r->y0 < r->y1;
+}
+
+/* 重绘表面下方的桌面，未设置时填桌面底色 */
+static surface_background_fn background = NULL;
+
+void surface_set_background(surface_background_fn redraw) {
+    background = redraw;
+}
+
+/* 屏幕矩形 r 上不再有 skip 覆盖：重绘桌面，并让与之重叠的其他表面重新合成这一块 */
+static void uncover(const surface_t *skip, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    if (background) {
+        background(x0, y0, x1 - x0, y1 - y0);
+    } else {
+        graphics_draw_rect(&gfx_ctx, x0, y0, x1 - x0, y1 - y0, COLOR_DESKTOP);
+    }
+
+    int signal = 0;
+    uint32_t flags = spin_lock_irqsave(&surface_lock);
+    for (uint32_t i = 0; i < SURFACE_MAX; i++) {
+        surface_t *surf = &surfaces[i];
+        if (!surf->used || surf == skip || !surf->shown) {
+            continue;
+        }
+        // 转换为该表面的坐标并裁剪
+        int32_t dx0 = x0 - surf->shown_x, dy0 = y0 - surf->shown_y;
+        int32_t dx1 = x1 - surf->shown_x, dy1 = y1 - surf->shown_y;
+        if (dx0 < 0) dx0 = 0;
+        if (dy0 < 0) dy0 = 0;
+        if (dx1 > (int32_t)surf->width) dx1 = surf->width;
+        if (dy1 > (int32_t)surf->height) dy1 = surf->height;
+        if (dx0 >= dx1 || dy0 >= dy1) {
+            continue;
+        }
+        if (surf->damaged) {
+            if (dx0 < surf->dx0) surf->dx0 = dx0;
+            if (dy0 < surf->dy0) surf->dy0 = dy0;
+            if (dx1 > surf->dx1) surf->dx1 = dx1;
+            if (dy1 > surf->dy1) surf->dy1 = dy1;
+        } else {
+            surf->dx0 = dx0;
+            surf->dy0 = dy0;
+            surf->dx1 = dx1;
+            surf->dy1 = dy1;
+            surf->damaged = 1;
+        }
+        signal = 1;
+    }
+    spin_unlock_irqrestore(&surface_lock, flags);
+
+    if (signal) {
+        event_signal(EVENT_COMPOSITE);
+    }
+}
+
+uint32_t surface_map_framebuffer(process_t *proc, fb_info_t *info) {
+    if (!graphics_enabled || !proc) {
+        return 0;
+    }
+
+    uint32_t size = gfx_ctx.pitch * gfx_ctx.height;
+    uint32_t base = (uint32_t)gfx_ctx.framebuffer;
+
+    // 用户直接写显存：写合并让连续写入合并成整行突发传输
+    if (!proc->fb_mapped) {
+        for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+            if (paging_map_user_phys(proc->page_dir, USER_FB_BASE + off, base + off,
+                                     PAGE_WRITE | PAGE_WRITE_COMBINE) != 0) {
+                return 0;
+            }
+        }
+        proc->fb_mapped = 1;
+    }
+
+    if (info) {
+        info->width = gfx_ctx.width;
+        info->height = gfx_ctx.height;
+        info->pitch = gfx_ctx.pitch;
+        info->bpp = gfx_ctx.bpp;
+    }
+    return USER_FB_BASE;
+}
+
+uint32_t surface_create(process_t *proc, uint32_t width, uint32_t height, int32_t x, int32_t y,
+                        uint32_t surface_flags) {
+    surface_t *surf = NULL;
+    uint32_t index = 0;
+
+    if (!proc || proc->surface || width == 0 || height == 0 || (surface_flags & ~SURFACE_ALPHA) ||
+        width > SURFACE_SLOT_SIZE / 4 || height > SURFACE_SLOT_SIZE / 4 / width) {
+        return 0;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&surface_lock);
+    for (uint32_t i = 0; i < SURFACE_MAX; i++) {
+        if (!surfaces[i].used) {
+            surf = &surfaces[i];
+            index = i;
+            surf->used = 1;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&surface_lock, flags);
+
+    if (!surf) {
+        return 0;
+    }
+
+    surf->pixels = (uint32_t *)surface_pool[index];
+    surf->width = width;
+    surf->height = height;
+    surf->pitch = width * 4;
+    surf->x = x;
+    surf->y = y;
+    surf->owner = proc;
+    surf->damaged = 0;
+    surf->shown = 0;
+    surf->flags = surface_flags;
+
+    uint32_t size = surf->pitch * height;
+    memset(surf->pixels, 0, size);
+
+    // 映射失败时表面仍归该进程所有，退出时随页目录一起回收，避免残留映射指向被复用的表面
+    proc->surface = surf;
+
+    // 用户与内核共享同一物理页，present 时不需要复制像素
+    for (uint32_t off = 0; off < size; off += PAGE_SIZE) {
+        if (paging_map_user_phys(proc->page_dir, USER_SURFACE_BASE + off,
+                                 (uint32_t)surf->pixels + off, PAGE_WRITE) != 0) {
+            return 0;
+        }
+    }
+    return USER_SURFACE_BASE;
+}
+
+int surface_present(process_t *proc, int32_t x, int32_t y, uint32_t width, uint32_t height) {
+    surface_t *surf = proc ? proc->surface : NULL;
+    if (!surf) {
+        return -1;
+    }
+
+    // 裁剪到表面范围
+    int32_t x0 = x < 0 ? 0 : x;
+    int32_t y0 = y < 0 ? 0 : y;
+    int32_t x1 = x + (int32_t)width;
+    int32_t y1 = y + (int32_t)height;
+    if (x1 > (int32_t)surf->width) x1 = surf->width;
+    if (y1 > (int32_t)surf->height) y1 = surf->height;
+    if (x0 >= x1 || y0 >= y1) {
+        return 0;
+    }
+
+    // 与尚未合成的区域合并，多次 present 只合成一次
+    uint32_t flags = spin_lock_irqsave(&surface_lock);
+    if (surf->damaged) {
+        if (x0 < surf->dx0) surf->dx0 = x0;
+        if (y0 < surf->dy0) surf->dy0 = y0;
+        if (x1 > surf->dx1) surf->dx1 = x1;
+        if (y1 > surf->dy1) surf->dy1 = y1;
+    } else {
+        surf->dx0 = x0;
+        surf->dy0 = y0;
+        surf->dx1 = x1;
+        surf->dy1 = y1;
+        surf->damaged = 1;
+    }
+    spin_unlock_irqrestore(&surface_lock, flags);
+
+    event_signal(EVENT_COMPOSITE);
+    return 0;
+}
+
+int surface_move(process_t *proc, int32_t x, int32_t y) {
+    surface_t *surf = proc ? proc->surface : NULL;
+    if (!surf) {
+        return -1;
+    }
+
+    // 只记录新位置，搬移像素由事件线程在合成时完成
+    uint32_t flags = spin_lock_irqsave(&surface_lock);
+    surf->x = x;
+    surf->y = y;
+    spin_unlock_irqrestore(&surface_lock, flags);
+
+    event_signal(EVENT_COMPOSITE);
+    return 0;
+}
+
+/* 把快照中的表面 surf 从上次合成的位置移到 (x, y)：两处都可见的部分在屏幕内直接搬移，
+ * 露出的部分重绘桌面；返回后需要重新合成的区域记录在快照的损坏区域中 */
+static void surface_relocate(surface_t *snap, const surface_t *surf) {
+    int32_t ox = snap->shown_x, oy = snap->shown_y;
+    int32_t x = snap->x, y = snap->y;
+    screen_rect_t old, cur;
+    int old_visible = visible_rect(snap, ox, oy, &old);
+    int cur_visible = visible_rect(snap, x, y, &cur);
+
+    // 半透明表面在屏幕上的像素混入了背景，不能搬移，只能在新位置重新混合
+    int32_t cx0 = 0, cy0 = 0, cx1 = 0, cy1 = 0;
+    if (old_visible && cur_visible && !(snap->flags & SURFACE_ALPHA)) {
+        cx0 = old.x0 - ox > cur.x0 - x ? old.x0 - ox : cur.x0 - x;
+        cy0 = old.y0 - oy > cur.y0 - y ? old.y0 - oy : cur.y0 - y;
+        cx1 = old.x1 - ox < cur.x1 - x ? old.x1 - ox : cur.x1 - x;
+        cy1 = old.y1 - oy < cur.y1 - y ? old.y1 - oy : cur.y1 - y;
+    }
+    int copied = cx0 < cx1 && cy0 < cy1;
+
+    // 指针在旧或新位置上时先隐藏，避免把指针像素一起搬走或被重绘的桌面盖住
+    screen_rect_t u = old_visible ? old : cur;
+    if (old_visible && cur_visible) {
+        if (cur.x0 < u.x0) u.x0 = cur.x0;
+        if (cur.y0 < u.y0) u.y0 = cur.y0;
+        if (cur.x1 > u.x1) u.x1 = cur.x1;
+        if (cur.y1 > u.y1) u.y1 = cur.y1;
+    }
+    int32_t mx = mouse_get_x(), my = mouse_get_y();
+    uint8_t hide = (old_visible || cur_visible) && mouse_get_state()->visible &&
+                   mx < u.x1 && mx + CURSOR_SIZE > u.x0 && my < u.y1 && my + CURSOR_SIZE > u.y0;
+    if (hide) {
+        mouse_set_visible(0);
+    }
+
+    if (copied) {
+        graphics_copy_rect(&gfx_ctx, x + cx0, y + cy0, ox + cx0, oy + cy0, cx1 - cx0, cy1 - cy0);
+    }
+
+    // 旧位置上露出的部分：与新位置重叠且搬移过时是旧矩形减去新矩形
+    // （上下两条加中间的左右两块），否则是整个旧矩形
+    if (old_visible) {
+        if (!copied || cur.x1 <= old.x0 || cur.x0 >= old.x1 ||
+            cur.y1 <= old.y0 || cur.y0 >= old.y1) {
+            uncover(surf, old.x0, old.y0, old.x1, old.y1);
+        } else {
+            int32_t my0 = cur.y0 > old.y0 ? cur.y0 : old.y0;
+            int32_t my1 = cur.y1 < old.y1 ? cur.y1 : old.y1;
+            uncover(surf, old.x0, old.y0, old.x1, my0);
+            uncover(surf, old.x0, my1, old.x1, old.y1);
+            uncover(surf, old.x0, my0, cur.x0 < old.x1 ? cur.x0 : old.x1, my1);
+            uncover(surf, cur.x1 > old.x0 ? cur.x1 : old.x0, my0, old.x1, my1);
+        }
+    }
+
+    if (hide) {
+        mouse_set_visible(1);
+    }
+
+    // 新位置上没有可搬的像素的部分（此前在屏幕外，或没有搬移）整个表面重新合成
+    if (cur_visible && (!copied || cx0 != cur.x0 - x || cy0 != cur.y0 - y ||
+                        cx1 != cur.x1 - x || cy1 != cur.y1 - y)) {
+        snap->dx0 = 0;
+        snap->dy0 = 0;
+        snap->dx1 = snap->width;
+        snap->dy1 = snap->height;
+        snap->damaged = 1;
+    }
+}
+
+/* 把表面快照的损坏区域复制到帧缓冲（不持有 surface_lock：读像素与写显存可能很慢） */
+static void surface_blit(const surface_t *surf) {
+    // 转换为屏幕坐标并裁剪
+    int32_t sx0 = surf->x + surf->dx0, sy0 = surf->y + surf->dy0;
+    int32_t sx1 = surf->x + surf->dx1, sy1 = surf->y + surf->dy1;
+    if (sx0 < 0) sx0 = 0;
+    if (sy0 < 0) sy0 = 0;
+    if (sx1 > (int32_t)gfx_ctx.width) sx1 = gfx_ctx.width;
+    if (sy1 > (int32_t)gfx_ctx.height) sy1 = gfx_ctx.height;
+    if (sx0 >= sx1 || sy0 >= sy1) {
+        return;
+    }
+
+    // 与鼠标指针重叠时先隐藏，合成后重新保存背景并绘制
+    int32_t mx = mouse_get_x(), my = mouse_get_y();
+    uint8_t hide = mouse_get_state()->visible &&
+                   mx < sx1 && mx + CURSOR_SIZE > sx0 &&
+                   my < sy1 && my + CURSOR_SIZE > sy0;
+    if (hide) {
+        mouse_set_visible(0);
+    }
+
+    trace(TRACE_RENDER_BEGIN, sx1 - sx0, sy1 - sy0);
+    uint32_t bytes = (sx1 - sx0) * 4;
+    for (int32_t y = sy0; y < sy1; y++) {
+        const uint8_t *src = (const uint8_t *)surf->pixels +
+                             (y - surf->y) * surf->pitch + (sx0 - surf->x) * 4;
+        uint8_t *dst = (uint8_t *)gfx_ctx.framebuffer + y * gfx_ctx.pitch + sx0 * 4;
+        // 半透明表面需要读回屏幕像素，不能用非临时写入
+        if (surf->flags & SURFACE_ALPHA) {
+            cpu_dispatch.blend((uint32_t *)dst, (const uint32_t *)src, sx1 - sx0);
+        } else {
+            memcpy_nt(dst, src, bytes);
+        }
+    }
+    trace(TRACE_RENDER_END, 0, 0);
+
+    if (hide) {
+        mouse_set_visible(1);
+    }
+}
+
+/* 只在事件线程中运行，合成与搬移之间天然串行；持锁只取位置与损坏区域的快照 */
+void surface_composite(void) {
+    // 只支持 32 位帧缓冲，与 render_damage 相同
+    if (!graphics_enabled || gfx_ctx.bpp != 32) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < SURFACE_MAX; i++) {
+        surface_t *surf = &surfaces[i];
+        surface_t snap;
+        uint32_t flags = spin_lock_irqsave(&surface_lock);
+        uint8_t moved = surf->used && surf->shown &&
+                        (surf->x != surf->shown_x || surf->y != surf->shown_y);
+        uint8_t work = moved || (surf->used && surf->damaged);
+        if (work) {
+            snap = *surf;
+            surf->damaged = 0;
+            surf->shown = 1;
+            surf->shown_x = surf->x;
+            surf->shown_y = surf->y;
+        }
+        spin_unlock_irqrestore(&surface_lock, flags);
+
+        if (!work) {
+            continue;
+        }
+        if (moved) {
+            surface_relocate(&snap, surf);
+        }
+        if (snap.damaged) {
+            surface_blit(&snap);
+        }
+    }
+}
+
+void surface_release(process_t *proc) {
+    surface_t *surf = proc->surface;
+    if (!surf) {
+        return;
+    }
+
+    // 用户映射随页目录一起销毁；已合成到屏幕上的内容保留
+    uint32_t flags = spin_lock_irqsave(&surface_lock);
+    surf->used = 0;
+    surf->damaged = 0;
+    surf->owner = NULL;
+    spin_unlock_irqrestore(&surface_lock, flags);
+
+    proc->surface = NULL;
+}
@@ -0,0 +1,183 @@
+#include <kernel/syscall.h>
+#include <kernel/process.h>
+#include <kernel/paging.h>
+#include <kernel/surface.h>
+#include <kernel/thread.h>
+#include <kernel/gdt.h>
+#include <kernel/io.h>
+#include <kernel/cpu_features.h>
+#include <kernel/trace.h>
+#include <kernel/bootprof.h>
+
+/* SYSENTER 相关 MSR */
+#define MSR_SYSENTER_CS  0x174
+#define MSR_SYSENTER_ESP 0x175
+#define MSR_SYSENTER_EIP 0x176
+
+/* vsyscall.asm */
+extern void sysenter_entry(void);
+extern const uint8_t vsyscall_sysenter_start[], vsyscall_sysenter_end[];
+extern const uint8_t vsyscall_int80_start[], vsyscall_int80_end[];
+
+/* SYSEXIT 从 SYSENTER_CS 推算用户段：CS+16 为用户代码段，CS+24 为用户数据段 */
+_Static_assert(USER_CODE_SEG == KERNEL_CODE_SEG + 16 && USER_DATA_SEG == KERNEL_CODE_SEG + 24,
+               "GDT layout incompatible with SYSEXIT");
+
+static uint8_t sysenter_enabled = 0;
+
+/* 一次 write 最多输出的字节数 */
+#define SYS_WRITE_MAX 1024
+
+static uint32_t syscall_counts[SYSCALL_COUNT];
+
+static void sys_exit(struct registers *regs) {
+    process_exit((int)regs->ebx);
+}
+
+static void sys_write(struct registers *regs) {
+    process_t *proc = process_current();
+    uint32_t buf = regs->ebx;
+    uint32_t len = regs->ecx;
+
+    if (len > SYS_WRITE_MAX) {
+        len = SYS_WRITE_MAX;
+    }
+    if (!proc || !paging_user_range_ok(proc->page_dir, buf, len, 0)) {
+        regs->eax = SYSCALL_EFAULT;
+        return;
+    }
+
+    // 用户页在当前地址空间中已映射，直接读取
+    const char *p = (const char *)buf;
+    for (uint32_t i = 0; i < len; i++) {
+        serial_putc(p[i]);
+    }
+    regs->eax = len;
+}
+
+static void sys_yield(struct registers *regs) {
+    thread_yield();
+    regs->eax = 0;
+}
+
+static void sys_getpid(struct registers *regs) {
+    process_t *proc = process_current();
+    regs->eax = proc ? proc->pid : 0;
+}
+
+static void sys_sleep(struct registers *regs) {
+    thread_sleep(regs->ebx);
+    regs->eax = 0;
+}
+
+static void sys_fb_map(struct registers *regs) {
+    process_t *proc = process_current();
+    uint32_t info = regs->ebx;
+
+    if (info && !paging_user_range_ok(proc->page_dir, info, sizeof(fb_info_t), 1)) {
+        regs->eax = SYSCALL_EFAULT;
+        return;
+    }
+
+    uint32_t addr = surface_map_framebuffer(proc, (fb_info_t *)info);
+    regs->eax = addr ? addr : SYSCALL_ENOMEM;
+}
+
+static void sys_surface_create(struct registers *regs) {
+    uint32_t addr = surface_create(process_current(), regs->ebx, regs->ecx,
+                                   (int32_t)regs->edx, (int32_t)regs->esi, regs->edi);
+    regs->eax = addr ? addr : SYSCALL_EINVAL;
+}
+
+/* 只记录损坏区域，像素留在共享内存中由事件循环合成 */
+static void sys_surface_present(struct registers *regs) {
+    int ret = surface_present(process_current(), (int32_t)regs->ebx, (int32_t)regs->ecx,
+                              regs->edx, regs->esi);
+    regs->eax = ret == 0 ? 0 : SYSCALL_EINVAL;
+}
+
+/* 已合成的像素在屏幕内搬移，不需要进程重新 present */
+static void sys_surface_move(struct registers *regs) {
+    int ret = surface_move(process_current(), (int32_t)regs->ebx, (int32_t)regs->ecx);
+    regs->eax = ret == 0 ? 0 : SYSCALL_EINVAL;
+}
+
+static const syscall_handler_t syscall_table[SYSCALL_COUNT] = {
+    [SYS_EXIT]   = sys_exit,
+    [SYS_WRITE]  = sys_write,
+    [SYS_YIELD]  = sys_yield,
+    [SYS_GETPID] = sys_getpid,
+    [SYS_SLEEP]  = sys_sleep,
+    [SYS_FB_MAP] = sys_fb_map,
+    [SYS_SURFACE_CREATE]  = sys_surface_create,
+    [SYS_SURFACE_PRESENT] = sys_surface_present,
+    [SYS_SURFACE_MOVE]    = sys_surface_move,
+};
+
+/* 配置当前 CPU 的 SYSENTER MSR；ESP 在切换到用户进程线程时更新 */
+static void sysenter_init_cpu(void) {
+    wrmsr(MSR_SYSENTER_CS, KERNEL_CODE_SEG);
+    wrmsr(MSR_SYSENTER_ESP, 0);
+    wrmsr(MSR_SYSENTER_EIP, (uint32_t)sysenter_entry);
+}
+
+void syscall_init(void) {
+    // 陷阱门：进入时不关中断；DPL=3 允许用户态 int 0x80
+    idt_set_gate(SYSCALL_VECTOR, (uint32_t)syscall_entry, KERNEL_CODE_SEG,
+                 IDT_FLAG_32BIT_TRAP | IDT_FLAG_DPL_3);
+
+    sysenter_enabled = cpu_has(CPU_FEATURE_SEP);
+    if (sysenter_enabled) {
+        sysenter_init_cpu();
+    }
+
+    if (!boot_quiet) {
+        serial_puts(sysenter_enabled ? "Syscalls: SYSENTER fast path enabled\n"
+                                     : "Syscalls: SYSENTER unavailable, using int 0x80\n");
+    }
+}
+
+void syscall_init_ap(void) {
+    if (sysenter_enabled) {
+        sysenter_init_cpu();
+    }
+}
+
+void sysenter_set_stack(uint32_t esp0) {
+    if (sysenter_enabled) {
+        wrmsr(MSR_SYSENTER_ESP, esp0);
+    }
+}
+
+int syscall_sysenter_enabled(void) {
+    return sysenter_enabled;
+}
+
+const void *syscall_vsyscall_image(uint32_t *size) {
+    if (sysenter_enabled) {
+        *size = vsyscall_sysenter_end - vsyscall_sysenter_start;
+        return vsyscall_sysenter_start;
+    }
+    *size = vsyscall_int80_end - vsyscall_int80_start;
+    return vsyscall_int80_start;
+}
+
+void syscall_dispatch(struct registers *regs) {
+    uint32_t nr = regs->eax;
+
+    trace(TRACE_SYSCALL, nr, regs->ebx);
+
+    if (nr >= SYSCALL_COUNT || !syscall_table[nr]) {
+        regs->eax = SYSCALL_ENOSYS;
+        return;
+    }
+
+    __atomic_fetch_add(&syscall_counts[nr], 1, __ATOMIC_RELAXED);
+    syscall_table[nr](regs);
+
+    trace(TRACE_SYSCALL_EXIT, nr, regs->eax);
+}
+
+uint32_t syscall_get_count(uint32_t nr) {
+    return nr < SYSCALL_COUNT ? syscall_counts[nr] : 0;
+}
@@ -0,0 +1,195 @@
+#include <kernel/task.h>
+#include <kernel/percpu.h>
+#include <kernel/thread.h>
+#include <kernel/io.h>
+#include <stddef.h>
+
+/* 工作线程在阻塞前空转尝试窃取的次数 */
+#define TASK_SPIN_TRIES 64
+
+/* 每个 CPU 一个双端队列 */
+static task_deque_t deques[MAX_CPUS];
+
+/* 每个 AP 上的工作线程（BSP 由调用者自己参与执行） */
+static thread_t *workers[MAX_CPUS];
+static uint32_t worker_count = 0;
+
+/* 所有者压入任务，队列满时返回 0 */
+static int deque_push(task_deque_t *dq, const task_t *task) {
+    int32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED);
+    int32_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+
+    if (b - t >= TASK_DEQUE_SIZE) {
+        return 0;
+    }
+    dq->buf[b & TASK_DEQUE_MASK] = *task;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+/* 所有者从 bottom 端弹出任务，队列空时返回 0 */
+static int deque_pop(task_deque_t *dq, task_t *task) {
+    int32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&dq->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int32_t t = __atomic_load_n(&dq->top, __ATOMIC_RELAXED);
+
+    if (t > b) {
+        // 队列为空
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    *task = dq->buf[b & TASK_DEQUE_MASK];
+    if (t == b) {
+        // 最后一个任务：与窃取者竞争 top
+        int won = __atomic_compare_exchange_n(&dq->top, &t, t + 1, 0,
+                                              __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+        __atomic_store_n(&dq->bottom, b + 1, __ATOMIC_RELAXED);
+        return won;
+    }
+    return 1;
+}
+
+/* 其他 CPU 从 top 端窃取任务，失败返回 0 */
+static int deque_steal(task_deque_t *dq, task_t *task) {
+    int32_t t = __atomic_load_n(&dq->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int32_t b = __atomic_load_n(&dq->bottom, __ATOMIC_ACQUIRE);
+
+    if (t >= b) {
+        return 0;
+    }
+
+    // 先复制再提交：槽位在 top 前移之前不会被所有者覆盖
+    *task = dq->buf[t & TASK_DEQUE_MASK];
+    return __atomic_compare_exchange_n(&dq->top, &t, t + 1, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/* 对本 CPU 队列的操作需关中断，防止同一 CPU 上的另一个线程抢占后并发访问 */
+static int local_push(const task_t *task) {
+    uint32_t flags = irq_save();
+    int ok = deque_push(&deques[this_cpu()->id], task);
+    irq_restore(flags);
+    return ok;
+}
+
+static int local_pop(task_t *task) {
+    uint32_t flags = irq_save();
+    int ok = deque_pop(&deques[this_cpu()->id], task);
+    irq_restore(flags);
+    return ok;
+}
+
+/* 依次尝试从其他 CPU 窃取 */
+static int steal_any(task_t *task) {
+    uint32_t self = this_cpu()->id;
+    uint32_t n = cpu_count;
+
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t victim = self + i;
+        if (victim >= n) {
+            victim -= n;
+        }
+        if (deque_steal(&deques[victim], task)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 执行任务：大区间对半拆分，后一半放回队列供其他 CPU 窃取 */
+static void task_run(task_t *task) {
+    task_group_t *group = task->group;
+    uint32_t begin = task->begin;
+    uint32_t end = task->end;
+
+    while (end - begin > group->grain) {
+        uint32_t mid = begin + (end - begin) / 2;
+        task_t half = { group, mid, end };
+        if (!local_push(&half)) {
+            break;      // 队列满，剩余部分就地执行
+        }
+        end = mid;
+    }
+
+    group->fn(group->arg, begin, end);
+    __atomic_fetch_sub(&group->pending, end - begin, __ATOMIC_RELEASE);
+}
+
+/* 取一个可执行的任务：先本地，再窃取 */
+static int task_find(task_t *task) {
+    return local_pop(task) || steal_any(task);
+}
+
+static void wake_workers(void) {
+    for (uint32_t i = 0; i < worker_count; i++) {
+        thread_wake(workers[i]);
+    }
+}
+
+/* 工作线程：没有任务时短暂空转，然后阻塞等待下一次 parallel_for */
+static void worker_thread_func(void *arg) {
+    task_t task;
+
+    while (1) {
+        int found = 0;
+        for (int i = 0; i < TASK_SPIN_TRIES && !found; i++) {
+            found = task_find(&task);
+            if (!found) {
+                asm volatile("pause");
+            }
+        }
+
+        if (found) {
+            task_run(&task);
+        } else {
+            thread_block();
+        }
+    }
+}
+
+void task_pool_init(void) {
+    for (uint32_t cpu = 1; cpu < cpu_count && cpu < MAX_CPUS; cpu++) {
+        thread_t *t = thread_create_on(cpu, "worker", worker_thread_func, NULL,
+                                       THREAD_PRIO_NORMAL);
+        if (t) {
+            workers[worker_count++] = t;
+        }
+    }
+}
+
+void parallel_for(uint32_t begin, uint32_t end, uint32_t grain,
+                  task_range_func_t fn, void *arg) {
+    if (end <= begin) {
+        return;
+    }
+
+    task_group_t group;
+    group.fn = fn;
+    group.arg = arg;
+    group.grain = grain ? grain : 1;
+    group.pending = end - begin;
+
+    // 没有工作线程时直接串行执行
+    if (worker_count == 0) {
+        fn(arg, begin, end);
+        return;
+    }
+
+    task_t root = { &group, begin, end };
+    wake_workers();
+    task_run(&root);
+
+    // 帮忙执行剩余任务（可能属于其他 parallel_for），直到本组全部完成
+    task_t task;
+    while (__atomic_load_n(&group.pending, __ATOMIC_ACQUIRE) != 0) {
+        if (task_find(&task)) {
+            task_run(&task);
+        } else {
+            asm volatile("pause");
+        }
+    }
+}
@@ -0,0 +1,509 @@
+#include <kernel/thread.h>
+#include <kernel/percpu.h>
+#include <kernel/apic.h>
+#include <kernel/timer.h>
+#include <kernel/gdt.h>
+#include <kernel/paging.h>
+#include <kernel/syscall.h>
+#include <kernel/fpu.h>
+#include <kernel/io.h>
+#include <kernel/string.h>
+
+/* 汇编实现的上下文切换（switch.asm） */
+extern void switch_context(uint32_t *old_esp, uint32_t new_esp);
+extern void thread_trampoline(void);
+
+/* 启动栈栈顶（boot.asm），主线程的内核栈 */
+extern uint8_t stack_top[];
+
+/* 线程表与栈 */
+static thread_t threads[THREAD_MAX];
+static uint8_t thread_stacks[THREAD_MAX][THREAD_STACK_SIZE] __attribute__((aligned(16)));
+static spinlock_t thread_table_lock = SPINLOCK_INIT;
+static uint32_t next_thread_id = 0;
+
+/* 加入就绪队列尾部（调用者持有 cpu->rq.lock） */
+static void rq_push(cpu_t *cpu, thread_t *t) {
+    runqueue_t *rq = &cpu->rq;
+    int prio = t->priority;
+
+    t->state = THREAD_READY;
+    t->next = NULL;
+    if (rq->tail[prio]) {
+        rq->tail[prio]->next = t;
+    } else {
+        rq->head[prio] = t;
+    }
+    rq->tail[prio] = t;
+    rq->bitmap |= 1u << prio;
+
+    // 比该 CPU 当前线程优先级高，尽快抢占
+    if (cpu->current && prio < cpu->current->priority) {
+        cpu->need_resched = 1;
+    }
+}
+
+/* 加入就绪队列头部：被抢占的线程保留剩余时间片 */
+static void rq_push_front(cpu_t *cpu, thread_t *t) {
+    runqueue_t *rq = &cpu->rq;
+    int prio = t->priority;
+
+    t->state = THREAD_READY;
+    t->next = rq->head[prio];
+    rq->head[prio] = t;
+    if (!rq->tail[prio]) {
+        rq->tail[prio] = t;
+    }
+    rq->bitmap |= 1u << prio;
+}
+
+/* O(1) 取出最高优先级的就绪线程 */
+static thread_t *rq_pop(runqueue_t *rq) {
+    if (rq->bitmap == 0) {
+        return NULL;
+    }
+
+    int prio = __builtin_ctz(rq->bitmap);
+    thread_t *t = rq->head[prio];
+
+    rq->head[prio] = t->next;
+    if (!rq->head[prio]) {
+        rq->tail[prio] = NULL;
+        rq->bitmap &= ~(1u << prio);
+    }
+    t->next = NULL;
+    return t;
+}
+
+/* 从就绪队列中摘下指定线程 */
+static void rq_remove(runqueue_t *rq, thread_t *t) {
+    int prio = t->priority;
+    thread_t **link = &rq->head[prio];
+    thread_t *prev = NULL;
+
+    while (*link && *link != t) {
+        prev = *link;
+        link = &(*link)->next;
+    }
+    if (!*link) {
+        return;
+    }
+
+    *link = t->next;
+    if (rq->tail[prio] == t) {
+        rq->tail[prio] = prev;
+    }
+    if (!rq->head[prio]) {
+        rq->bitmap &= ~(1u << prio);
+    }
+    t->next = NULL;
+}
+
+/* 其他 CPU 需要重新调度时发送 IPI */
+static void kick_cpu(cpu_t *cpu) {
+    if (cpu != this_cpu() && cpu->need_resched) {
+        lapic_send_ipi(cpu->apic_id, IPI_RESCHED_VECTOR);
+    }
+}
+
+/* 选择下一个线程并切换
+ * 调用者已关中断并持有本 CPU 的就绪队列锁，返回时锁已释放。
+ * 线程不会跨 CPU 迁移，所以切换前释放锁是安全的：只有本 CPU 会取出这些线程。 */
+static void schedule(cpu_t *cpu) {
+    thread_t *prev = cpu->current;
+    thread_t *next = rq_pop(&cpu->rq);
+
+    cpu->need_resched = 0;
+
+    // 没有就绪线程时运行空闲线程
+    if (!next) {
+        next = cpu->idle;
+    }
+
+    if (next->slice == 0) {
+        next->slice = THREAD_TIMESLICE;
+    }
+
+    if (next == prev) {
+        prev->state = THREAD_RUNNING;
+        spin_unlock(&cpu->rq.lock);
+        return;
+    }
+
+    if (prev == cpu->idle) {
+        prev->state = THREAD_READY;
+    } else if (prev->state == THREAD_DEAD) {
+        // 栈还在使用，切换完成后再回收
+        cpu->zombie = prev;
+    }
+
+    next->state = THREAD_RUNNING;
+    cpu->current = next;
+
+    // 下一次从用户态陷入时使用新线程的内核栈
+    tss_set_kernel_stack(next->kstack_top);
+    if (next->process) {
+        sysenter_set_stack(next->kstack_top);
+    }
+
+    // 切换地址空间（内核线程共用内核页目录）
+    uint32_t cr3 = next->cr3 ? next->cr3 : paging_kernel_cr3;
+    if (cr3 && cr3 != read_cr3()) {
+        write_cr3(cr3);
+    }
+
+    // FPU 状态惰性切换：只设置 CR0.TS，真正的保存/恢复推迟到 #NM
+    fpu_switch(next);
+
+    spin_unlock(&cpu->rq.lock);
+
+    switch_context(&prev->esp, next->esp);
+
+    thread_finish_switch();
+}
+
+void thread_finish_switch(void) {
+    cpu_t *cpu = this_cpu();
+
+    if (cpu->zombie) {
+        spin_lock(&thread_table_lock);
+        cpu->zombie->state = THREAD_UNUSED;
+        spin_unlock(&thread_table_lock);
+        cpu->zombie = NULL;
+    }
+}
+
+/* 空闲循环：没有其他工作时停在 hlt */
+static void __attribute__((noreturn)) thread_idle_loop(void) {
+    while (1) {
+        asm volatile("sti\n" "hlt");
+        thread_yield();
+    }
+}
+
+static void idle_thread_func(void *arg) {
+    (void)arg;
+    thread_idle_loop();
+}
+
+/* 分配线程槽位（状态置为 BLOCKED 以防被重复分配） */
+static thread_t *thread_alloc(const char *name, int priority, uint32_t cpu) {
+    thread_t *found = NULL;
+
+    if (priority < 0) {
+        priority = 0;
+    } else if (priority >= THREAD_PRIO_LEVELS) {
+        priority = THREAD_PRIO_LEVELS - 1;
+    }
+
+    spin_lock(&thread_table_lock);
+    for (int i = 0; i < THREAD_MAX; i++) {
+        thread_t *t = &threads[i];
+        if (t->state == THREAD_UNUSED) {
+            memset(t, 0, sizeof(thread_t));
+            t->id = next_thread_id++;
+            t->state = THREAD_BLOCKED;
+            t->priority = priority;
+            t->cpu = cpu;
+            t->stack = thread_stacks[i];
+            t->kstack_top = (uint32_t)(thread_stacks[i] + THREAD_STACK_SIZE);
+            strlcpy(t->name, name, THREAD_NAME_LEN);
+            found = t;
+            break;
+        }
+    }
+    spin_unlock(&thread_table_lock);
+
+    return found;
+}
+
+/* 构造新线程的初始栈帧 */
+static void thread_setup_stack(thread_t *t, thread_func_t fn, void *arg) {
+    // 初始栈帧与 switch_context 的弹栈顺序一致：edi, esi, ebx, ebp, 返回地址
+    uint32_t *sp = (uint32_t *)(t->stack + THREAD_STACK_SIZE);
+    *--sp = 0;                              // 蹦床不会返回，占位
+    *--sp = (uint32_t)thread_trampoline;    // 返回地址
+    *--sp = 0;                              // ebp
+    *--sp = (uint32_t)fn;                   // ebx：线程函数
+    *--sp = (uint32_t)arg;                  // esi：参数
+    *--sp = 0;                              // edi
+    t->esp = (uint32_t)sp;
+}
+
+void thread_init(void) {
+    cpu_t *cpu = this_cpu();
+    uint32_t flags = irq_save();
+
+    spin_lock_init(&thread_table_lock, "thread_table");
+
+    // 当前执行流（kernel_main）成为主线程，继续使用启动栈
+    thread_t *main_thread = thread_alloc("main", THREAD_PRIO_NORMAL, cpu->id);
+    main_thread->stack = NULL;
+    main_thread->kstack_top = (uint32_t)stack_top;
+    main_thread->state = THREAD_RUNNING;
+    main_thread->slice = THREAD_TIMESLICE;
+    cpu->current = main_thread;
+    tss_set_kernel_stack(main_thread->kstack_top);
+
+    // 空闲线程不进入就绪队列，只在无事可做时被选中
+    thread_t *idle = thread_alloc("idle", THREAD_PRIO_IDLE, cpu->id);
+    thread_setup_stack(idle, idle_thread_func, NULL);
+    idle->state = THREAD_READY;
+    cpu->idle = idle;
+
+    irq_restore(flags);
+}
+
+void thread_init_ap(void) {
+    cpu_t *cpu = this_cpu();
+    uint32_t flags = irq_save();
+
+    // AP 的启动执行流直接成为空闲线程
+    thread_t *idle = thread_alloc("idle", THREAD_PRIO_IDLE, cpu->id);
+    idle->stack = NULL;
+    idle->kstack_top = cpu->stack_top;
+    idle->state = THREAD_RUNNING;
+    idle->slice = THREAD_TIMESLICE;
+    cpu->idle = idle;
+    cpu->current = idle;
+    tss_set_kernel_stack(idle->kstack_top);
+
+    irq_restore(flags);
+}
+
+void thread_run_idle(void) {
+    thread_idle_loop();
+}
+
+thread_t *thread_create_on(uint32_t cpu_id, const char *name, thread_func_t fn,
+                           void *arg, int priority) {
+    if (cpu_id >= MAX_CPUS || !cpus[cpu_id].online) {
+        return NULL;
+    }
+
+    cpu_t *cpu = &cpus[cpu_id];
+    uint32_t flags = irq_save();
+
+    thread_t *t = thread_alloc(name, priority, cpu_id);
+    if (t) {
+        thread_setup_stack(t, fn, arg);
+        spin_lock(&cpu->rq.lock);
+        rq_push(cpu, t);
+        spin_unlock(&cpu->rq.lock);
+        kick_cpu(cpu);
+    }
+
+    // 新线程优先级更高时立即切换
+    if (this_cpu()->need_resched && (flags & 0x200)) {
+        thread_preempt();
+    }
+
+    irq_restore(flags);
+    return t;
+}
+
+thread_t *thread_create(const char *name, thread_func_t fn, void *arg, int priority) {
+    return thread_create_on(this_cpu()->id, name, fn, arg, priority);
+}
+
+void thread_set_priority(thread_t *t, int priority) {
+    if (priority < 0 || priority >= THREAD_PRIO_LEVELS) {
+        return;
+    }
+
+    cpu_t *cpu = &cpus[t->cpu];
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    if (t->state == THREAD_READY && t != cpu->idle) {
+        // 从旧队列摘下再按新优先级入队
+        rq_remove(&cpu->rq, t);
+        t->priority = priority;
+        rq_push(cpu, t);
+    } else {
+        t->priority = priority;
+        // 当前线程降级后可能有更高优先级的线程在等待
+        if (t == cpu->current && cpu->rq.bitmap &&
+            __builtin_ctz(cpu->rq.bitmap) < priority) {
+            cpu->need_resched = 1;
+        }
+    }
+
+    spin_unlock(&cpu->rq.lock);
+    kick_cpu(cpu);
+
+    if (this_cpu()->need_resched && (flags & 0x200)) {
+        thread_preempt();
+    }
+
+    irq_restore(flags);
+}
+
+void thread_yield(void) {
+    cpu_t *cpu = this_cpu();
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    thread_t *cur = cpu->current;
+    if (cur != cpu->idle) {
+        cur->slice = 0;
+        rq_push(cpu, cur);
+    }
+    schedule(cpu);
+
+    irq_restore(flags);
+}
+
+void thread_sleep(uint32_t ticks) {
+    cpu_t *cpu = this_cpu();
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    cpu->current->wake_tick = timer_get_ticks() + ticks;
+    cpu->current->state = THREAD_SLEEPING;
+    schedule(cpu);
+
+    irq_restore(flags);
+}
+
+void thread_block(void) {
+    cpu_t *cpu = this_cpu();
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    thread_t *cur = cpu->current;
+    if (cur->wake_pending) {
+        cur->wake_pending = 0;
+        spin_unlock(&cpu->rq.lock);
+    } else {
+        cur->state = THREAD_BLOCKED;
+        schedule(cpu);
+    }
+
+    irq_restore(flags);
+}
+
+void thread_block_timeout(uint32_t ticks) {
+    cpu_t *cpu = this_cpu();
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    thread_t *cur = cpu->current;
+    if (cur->wake_pending) {
+        cur->wake_pending = 0;
+        spin_unlock(&cpu->rq.lock);
+    } else {
+        // 以睡眠状态阻塞：thread_wake 或到期扫描都能让它重新就绪
+        cur->wake_tick = timer_get_ticks() + ticks;
+        cur->state = THREAD_SLEEPING;
+        schedule(cpu);
+    }
+
+    irq_restore(flags);
+}
+
+void thread_wake(thread_t *t) {
+    cpu_t *cpu = &cpus[t->cpu];
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    if (t->state == THREAD_BLOCKED || t->state == THREAD_SLEEPING) {
+        rq_push(cpu, t);
+    } else if (t->state == THREAD_RUNNING || t->state == THREAD_READY) {
+        t->wake_pending = 1;
+    }
+
+    spin_unlock(&cpu->rq.lock);
+    kick_cpu(cpu);
+
+    // 在开中断的线程上下文中可立即抢占；中断上下文推迟到 IRQ 返回前
+    if (this_cpu()->need_resched && (flags & 0x200)) {
+        thread_preempt();
+    }
+
+    irq_restore(flags);
+}
+
+void thread_exit(void) {
+    cpu_t *cpu = this_cpu();
+
+    irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    cpu->current->state = THREAD_DEAD;
+    fpu_thread_exit(cpu->current);
+    schedule(cpu);
+
+    // 不会返回
+    while (1) {
+        asm volatile("hlt");
+    }
+}
+
+thread_t *thread_current(void) {
+    return this_cpu()->current;
+}
+
+int thread_can_sleep(void) {
+    uint32_t flags;
+    asm volatile ("pushf\n" "pop %0" : "=r"(flags));
+    if (!(flags & 0x200)) {
+        return 0;
+    }
+    cpu_t *cpu = this_cpu();
+    return cpu->current && cpu->current != cpu->idle;
+}
+
+void thread_tick(uint32_t now) {
+    cpu_t *cpu = this_cpu();
+    thread_t *cur = cpu->current;
+
+    if (!cur) {
+        return;
+    }
+
+    spin_lock(&cpu->rq.lock);
+
+    // 唤醒本 CPU 上到期的睡眠线程
+    for (int i = 0; i < THREAD_MAX; i++) {
+        thread_t *t = &threads[i];
+        if (t->cpu == cpu->id && t->state == THREAD_SLEEPING &&
+            (int32_t)(now - t->wake_tick) >= 0) {
+            rq_push(cpu, t);
+        }
+    }
+
+    // 时间片用完，同优先级轮转
+    if (cur != cpu->idle && cur->slice > 0 && --cur->slice == 0) {
+        cpu->need_resched = 1;
+    }
+    // 空闲线程遇到任何就绪线程都应让出
+    if (cur == cpu->idle && cpu->rq.bitmap) {
+        cpu->need_resched = 1;
+    }
+
+    spin_unlock(&cpu->rq.lock);
+}
+
+void thread_preempt(void) {
+    cpu_t *cpu = this_cpu();
+
+    if (!cpu->need_resched || !cpu->current) {
+        return;
+    }
+
+    uint32_t flags = irq_save();
+    spin_lock(&cpu->rq.lock);
+
+    thread_t *cur = cpu->current;
+    if (cur != cpu->idle && cur->state == THREAD_RUNNING) {
+        if (cur->slice == 0) {
+            rq_push(cpu, cur);
+        } else {
+            rq_push_front(cpu, cur);
+        }
+    }
+    schedule(cpu);
+
+    irq_restore(flags);
+}
@@ -0,0 +1,34 @@
+#include <kernel/timer.h>
+#include <kernel/idt.h>
+#include <kernel/io.h>
+#include <kernel/thread.h>
+#include <kernel/event.h>
+
+#define PIT_CH0_DATA  0x40
+#define PIT_CMD       0x43
+#define PIT_FREQUENCY 1193180
+
+static volatile uint32_t timer_ticks = 0;
+
+// 定时器中断处理程序（EOI 由 irq_handler 统一发送）
+static void timer_handler(struct registers *regs) {
+    timer_ticks++;
+
+    // 唤醒到期的睡眠线程，触发到期的周期事件
+    thread_tick(timer_ticks);
+    event_timer_tick(timer_ticks);
+}
+
+void timer_init(uint32_t hz) {
+    uint32_t divisor = PIT_FREQUENCY / hz;
+
+    outb(PIT_CMD, 0x36);                        // 通道0, 先低后高, 模式3
+    outb(PIT_CH0_DATA, divisor & 0xFF);
+    outb(PIT_CH0_DATA, (divisor >> 8) & 0xFF);
+
+    register_irq_handler(0, timer_handler);
+}
+
+uint32_t timer_get_ticks(void) {
+    return timer_ticks;
+}
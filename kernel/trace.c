@@ -0,0 +1,69 @@
+#include <kernel/trace.h>
+#include <kernel/io.h>
+#include <kernel/string.h>
+#include <kernel/crc32c.h>
+
+trace_record_t trace_buf[TRACE_BUF_RECORDS];
+volatile uint32_t trace_head = 0;
+volatile uint8_t trace_paused = 0;
+
+void trace_printk_sink(int level, const char *line, size_t len) {
+    trace(TRACE_LOG, level, crc32c(0, line, len));
+}
+
+/* 输出一行十六进制数据 */
+static void trace_put_hex_bytes(const uint8_t *data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    char line[sizeof(trace_record_t) * 2 + 2];
+    size_t pos = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        line[pos++] = digits[data[i] >> 4];
+        line[pos++] = digits[data[i] & 0x0F];
+    }
+    line[pos++] = '\n';
+    line[pos] = '\0';
+    serial_puts(line);
+}
+
+/* 导出缓冲区：按时间顺序输出最旧到最新的记录 */
+void trace_dump(void) {
+    char buf[16];
+
+    trace_paused = 1;
+
+    uint32_t head = trace_head;
+    uint32_t count = head < TRACE_BUF_RECORDS ? head : TRACE_BUF_RECORDS;
+    uint32_t first = head - count;
+
+    // 先排空之前的输出，保证头部完整
+    serial_flush();
+    serial_puts("=== TRACE BEGIN v1 tsc_khz=");
+    utoa(tsc_get_khz(), buf, 10);
+    serial_puts(buf);
+    serial_puts(" records=");
+    utoa(count, buf, 10);
+    serial_puts(buf);
+    serial_puts(" size=");
+    utoa(sizeof(trace_record_t), buf, 10);
+    serial_puts(buf);
+    serial_puts(" ===\n");
+
+    // 对按输出顺序排列的记录计算 CRC32C，解码器据此发现串口丢字节
+    uint32_t crc = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const trace_record_t *rec = &trace_buf[(first + i) & TRACE_BUF_MASK];
+        crc = crc32c(crc, rec, sizeof(trace_record_t));
+        trace_put_hex_bytes((const uint8_t *)rec, sizeof(trace_record_t));
+        // 数据量远大于发送缓冲区，逐行同步排空
+        serial_flush();
+    }
+
+    serial_puts("=== TRACE END crc32c=");
+    utoa(crc, buf, 16);
+    serial_puts(buf);
+    serial_puts(" ===\n");
+    serial_flush();
+
+    trace_paused = 0;
+}
@@ -0,0 +1,63 @@
+#include <kernel/tsc.h>
+#include <kernel/io.h>
+
+/* PIT 相关端口 */
+#define PIT_CH2_DATA   0x42
+#define PIT_CMD        0x43
+#define PIT_GATE_PORT  0x61
+#define PIT_FREQUENCY  1193182
+
+/* 校准时长（毫秒） */
+#define TSC_CALIBRATE_MS 10
+
+static uint32_t tsc_khz = 0;
+
+/* 使用 PIT 通道2 单次计数测量 TSC 频率 */
+void tsc_init(void) {
+    uint32_t latch = PIT_FREQUENCY / (1000 / TSC_CALIBRATE_MS);
+    uint32_t flags = irq_save();
+
+    // 打开通道2门控，关闭扬声器输出
+    outb(PIT_GATE_PORT, (inb(PIT_GATE_PORT) & ~0x02) | 0x01);
+
+    // 通道2, 先低后高字节, 模式0（计数结束时 OUT 置高）
+    outb(PIT_CMD, 0xB0);
+    outb(PIT_CH2_DATA, latch & 0xFF);
+    outb(PIT_CH2_DATA, (latch >> 8) & 0xFF);
+
+    uint64_t start = rdtsc();
+    while ((inb(PIT_GATE_PORT) & 0x20) == 0);
+    uint64_t end = rdtsc();
+
+    irq_restore(flags);
+
+    // 10ms 内的周期数不会超过 32 位，避免 64 位除法
+    tsc_khz = (uint32_t)(end - start) / TSC_CALIBRATE_MS;
+}
+
+uint32_t tsc_get_khz(void) {
+    return tsc_khz;
+}
+
+void tsc_delay_us(uint32_t us) {
+    uint64_t end = rdtsc() + (uint64_t)us * (tsc_khz / 1000);
+    while (rdtsc() < end) {
+        asm volatile ("pause");
+    }
+}
+
+uint32_t tsc_cycles_to_us(uint64_t cycles) {
+    // 每微秒的周期数即 MHz，精度足够且不会溢出
+    uint32_t mhz = tsc_khz / 1000;
+    if (mhz == 0) {
+        return 0;
+    }
+
+    // 没有 libgcc，不能做 64 位除法：先右移到 32 位以内再除
+    int shift = 0;
+    while (cycles >> 32) {
+        cycles >>= 1;
+        shift++;
+    }
+    return ((uint32_t)cycles / mhz) << shift;
+}
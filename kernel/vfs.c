@@ -0,0 +1,746 @@
+#include <kernel/vfs.h>
+#include <kernel/printk.h>
+#include <kernel/spinlock.h>
+#include <kernel/string.h>
+#include <kernel/thread.h>
+#include <kernel/waitqueue.h>
+#include <stddef.h>
+
+/* dentry 标志 */
+#define VFS_D_BUSY      0x01    // 文件系统正在查找，inode 尚未确定
+
+/* 缓存页标志 */
+#define VFS_P_VALID     0x01
+#define VFS_P_BUSY      0x02    // 正在读入
+
+#define VFS_RADIX_MASK  (VFS_RADIX_SLOTS - 1)
+
+typedef struct vfs_radix_node {
+    void *slots[VFS_RADIX_SLOTS];   // 中间层指向子节点，最底层指向 vfs_page_t
+    uint32_t count;                 // 非空槽数
+} vfs_radix_node_t;
+
+typedef struct vfs_page {
+    vfs_inode_t *inode;         // NULL 表示空闲
+    uint32_t index;
+    uint8_t flags;
+    struct vfs_page *lru_prev;
+    struct vfs_page *lru_next;
+    uint8_t *data;
+} vfs_page_t;
+
+static vfs_inode_t vfs_inodes[VFS_INODES];
+static vfs_inode_t *inode_free;
+static vfs_dentry_t vfs_dentries[VFS_DENTRIES];
+static vfs_dentry_t *dentry_free;               // 通过 hash_next 链接
+static vfs_dentry_t *dcache_hash[VFS_DCACHE_HASH];
+static vfs_dentry_t dentry_lru;                 // 哨兵：只包含 refcount 为 0 的 dentry
+static vfs_dentry_t *vfs_root = NULL;
+
+static uint8_t vfs_page_data[VFS_PAGES][VFS_PAGE_SIZE] __attribute__((aligned(4096)));
+static vfs_page_t vfs_pages[VFS_PAGES];
+static vfs_page_t page_lru;                     // 哨兵：空闲页在尾部，最先被复用
+static vfs_radix_node_t radix_nodes[VFS_RADIX_NODES];
+static vfs_radix_node_t *radix_free;            // 通过 slots[0] 链接
+
+static vfs_file_t vfs_files[VFS_FILES];
+static vfs_stats_t stats;
+
+static spinlock_t vfs_lock = SPINLOCK_INIT;
+static waitqueue_t vfs_wq;
+static volatile uint32_t vfs_events = 0;        // 每次 BUSY 状态结束加一，等待者据此判断进展
+
+/* 等待任意状态变化（seen 是持锁时读到的 vfs_events） */
+static void vfs_wait(uint32_t seen) {
+    if (thread_can_sleep()) {
+        wait_event(&vfs_wq, vfs_events != seen);
+    } else {
+        asm volatile ("pause");
+    }
+}
+
+/* ========== 基数树（调用者持有 vfs_lock） ========== */
+
+static vfs_radix_node_t *radix_node_alloc(void) {
+    vfs_radix_node_t *n = radix_free;
+    if (n) {
+        radix_free = n->slots[0];
+        memset(n, 0, sizeof(*n));
+    }
+    return n;
+}
+
+static void radix_node_free(vfs_radix_node_t *n) {
+    n->slots[0] = radix_free;
+    radix_free = n;
+}
+
+/* height 层的树能容纳的最大页号 + 1（0 表示整个 32 位范围） */
+static inline uint32_t radix_capacity(uint32_t height) {
+    return height * VFS_RADIX_SHIFT >= 32 ? 0 : 1u << (height * VFS_RADIX_SHIFT);
+}
+
+static inline int radix_fits(uint32_t height, uint32_t index) {
+    uint32_t cap = radix_capacity(height);
+    return height && (cap == 0 || index < cap);
+}
+
+static void *radix_lookup(vfs_radix_tree_t *tree, uint32_t index) {
+    if (!radix_fits(tree->height, index)) {
+        return NULL;
+    }
+    vfs_radix_node_t *node = tree->root;
+    for (uint32_t h = tree->height; node && h > 1; h--) {
+        node = node->slots[(index >> ((h - 1) * VFS_RADIX_SHIFT)) & VFS_RADIX_MASK];
+    }
+    return node ? node->slots[index & VFS_RADIX_MASK] : NULL;
+}
+
+static int radix_insert(vfs_radix_tree_t *tree, uint32_t index, void *item) {
+    // 树长高：旧根成为新根的 0 号子树
+    while (!radix_fits(tree->height, index)) {
+        if (!tree->root) {
+            tree->height++;
+            continue;
+        }
+        vfs_radix_node_t *n = radix_node_alloc();
+        if (!n) {
+            return -1;
+        }
+        n->slots[0] = tree->root;
+        n->count = 1;
+        tree->root = n;
+        tree->height++;
+    }
+    if (!tree->root && !(tree->root = radix_node_alloc())) {
+        return -1;
+    }
+
+    vfs_radix_node_t *node = tree->root;
+    for (uint32_t h = tree->height; h > 1; h--) {
+        void **slot = &node->slots[(index >> ((h - 1) * VFS_RADIX_SHIFT)) & VFS_RADIX_MASK];
+        if (!*slot) {
+            if (!(*slot = radix_node_alloc())) {
+                return -1;
+            }
+            node->count++;
+        }
+        node = *slot;
+    }
+    if (!node->slots[index & VFS_RADIX_MASK]) {
+        node->count++;
+    }
+    node->slots[index & VFS_RADIX_MASK] = item;
+    return 0;
+}
+
+static void radix_delete(vfs_radix_tree_t *tree, uint32_t index) {
+    vfs_radix_node_t *path[VFS_RADIX_MAX_HEIGHT + 1];
+    uint32_t depth = 0;
+
+    if (!radix_fits(tree->height, index)) {
+        return;
+    }
+    vfs_radix_node_t *node = tree->root;
+    for (uint32_t h = tree->height; node && h > 1; h--) {
+        path[depth++] = node;
+        node = node->slots[(index >> ((h - 1) * VFS_RADIX_SHIFT)) & VFS_RADIX_MASK];
+    }
+    if (!node || !node->slots[index & VFS_RADIX_MASK]) {
+        return;
+    }
+    node->slots[index & VFS_RADIX_MASK] = NULL;
+    node->count--;
+
+    // 自底向上释放变空的节点
+    while (node->count == 0) {
+        radix_node_free(node);
+        if (depth == 0) {
+            tree->root = NULL;
+            tree->height = 0;
+            break;
+        }
+        vfs_radix_node_t *parent = path[--depth];
+        uint32_t shift = (tree->height - 1 - depth) * VFS_RADIX_SHIFT;
+        parent->slots[(index >> shift) & VFS_RADIX_MASK] = NULL;
+        parent->count--;
+        node = parent;
+    }
+}
+
+/* ========== 页缓存 LRU（调用者持有 vfs_lock） ========== */
+
+static void page_lru_remove(vfs_page_t *p) {
+    p->lru_prev->lru_next = p->lru_next;
+    p->lru_next->lru_prev = p->lru_prev;
+}
+
+static void page_lru_push_front(vfs_page_t *p) {
+    p->lru_next = page_lru.lru_next;
+    p->lru_prev = &page_lru;
+    page_lru.lru_next->lru_prev = p;
+    page_lru.lru_next = p;
+}
+
+static void page_lru_push_back(vfs_page_t *p) {
+    p->lru_prev = page_lru.lru_prev;
+    p->lru_next = &page_lru;
+    page_lru.lru_prev->lru_next = p;
+    page_lru.lru_prev = p;
+}
+
+/* 把页从所属 inode 的基数树中摘下并放到最先被复用的位置 */
+static void page_drop(vfs_page_t *p) {
+    radix_delete(&p->inode->pages, p->index);
+    p->inode->nr_pages--;
+    p->inode = NULL;
+    p->flags = 0;
+    page_lru_remove(p);
+    page_lru_push_back(p);
+}
+
+static vfs_page_t *page_find_victim(void) {
+    for (vfs_page_t *p = page_lru.lru_prev; p != &page_lru; p = p->lru_prev) {
+        if (!(p->flags & VFS_P_BUSY)) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/* ========== inode 与 dentry（调用者持有 vfs_lock） ========== */
+
+static vfs_inode_t *inode_alloc(void) {
+    vfs_inode_t *inode = inode_free;
+    if (inode) {
+        inode_free = inode->free_next;
+        memset(inode, 0, sizeof(*inode));
+    }
+    return inode;
+}
+
+static void inode_free_one(vfs_inode_t *inode) {
+    inode->free_next = inode_free;
+    inode_free = inode;
+}
+
+/* 最后一个 dentry 离开时丢弃 inode 的页（此时没有打开的文件，也就没有 BUSY 页） */
+static void iput(vfs_inode_t *inode) {
+    if (--inode->refcount) {
+        return;
+    }
+    for (uint32_t i = 0; inode->nr_pages && i < VFS_PAGES; i++) {
+        if (vfs_pages[i].inode == inode) {
+            page_drop(&vfs_pages[i]);
+        }
+    }
+    inode_free_one(inode);
+}
+
+static inline uint32_t dcache_hashfn(vfs_dentry_t *parent, uint32_t hash) {
+    return (((uint32_t)parent >> 4) ^ (hash * 2654435761u)) & (VFS_DCACHE_HASH - 1);
+}
+
+static vfs_dentry_t *d_find(vfs_dentry_t *parent, const char *name, uint32_t len,
+                            uint32_t hash) {
+    vfs_dentry_t *d = dcache_hash[dcache_hashfn(parent, hash)];
+    while (d && (d->parent != parent || d->hash != hash || d->len != len ||
+                 memcmp(d->name, name, len) != 0)) {
+        d = d->hash_next;
+    }
+    return d;
+}
+
+static void d_hash_remove(vfs_dentry_t *d) {
+    vfs_dentry_t **pp = &dcache_hash[dcache_hashfn(d->parent, d->hash)];
+    while (*pp && *pp != d) {
+        pp = &(*pp)->hash_next;
+    }
+    if (*pp) {
+        *pp = d->hash_next;
+    }
+}
+
+static void d_lru_remove(vfs_dentry_t *d) {
+    d->lru_prev->lru_next = d->lru_next;
+    d->lru_next->lru_prev = d->lru_prev;
+}
+
+static void d_lru_push_front(vfs_dentry_t *d) {
+    d->lru_next = dentry_lru.lru_next;
+    d->lru_prev = &dentry_lru;
+    dentry_lru.lru_next->lru_prev = d;
+    dentry_lru.lru_next = d;
+}
+
+/* 引用计数从 0 变为 1 时离开 LRU */
+static void dget(vfs_dentry_t *d) {
+    if (d->refcount++ == 0) {
+        d_lru_remove(d);
+    }
+}
+
+static void dput_locked(vfs_dentry_t *d) {
+    if (--d->refcount == 0) {
+        d_lru_push_front(d);
+    }
+}
+
+/* 淘汰一个未被引用的 dentry：释放 inode 引用与对父目录的引用 */
+static void d_evict(vfs_dentry_t *d) {
+    d_lru_remove(d);
+    d_hash_remove(d);
+    if (d->inode) {
+        iput(d->inode);
+    }
+    if (d->parent) {
+        dput_locked(d->parent);
+    }
+    d->hash_next = dentry_free;
+    dentry_free = d;
+    stats.d_evictions++;
+}
+
+static vfs_dentry_t *d_alloc(void) {
+    if (!dentry_free && dentry_lru.lru_prev != &dentry_lru) {
+        d_evict(dentry_lru.lru_prev);
+    }
+    vfs_dentry_t *d = dentry_free;
+    if (d) {
+        dentry_free = d->hash_next;
+        memset(d, 0, sizeof(*d));
+    }
+    return d;
+}
+
+/* ========== 路径解析 ========== */
+
+/* 在 dir 下取得名为 name 的 dentry（可能是负项）并持有它；缓存未命中时询问文件系统 */
+static vfs_dentry_t *d_lookup_child(vfs_dentry_t *dir, const char *name, uint32_t len,
+                                    uint32_t hash, uint32_t *flags) {
+    for (;;) {
+        vfs_dentry_t *d = d_find(dir, name, len, hash);
+        if (!d) {
+            break;
+        }
+        // 别的线程正在查找同一个名字：等它完成
+        if (d->flags & VFS_D_BUSY) {
+            uint32_t seen = vfs_events;
+            spin_unlock_irqrestore(&vfs_lock, *flags);
+            vfs_wait(seen);
+            *flags = spin_lock_irqsave(&vfs_lock);
+            continue;
+        }
+        dget(d);
+        stats.d_hits++;
+        if (!d->inode) {
+            stats.d_negative++;
+        }
+        return d;
+    }
+
+    stats.d_misses++;
+    vfs_dentry_t *d = d_alloc();
+    // inode 都被缓存的 dentry 占用时，淘汰 LRU 尾部的 dentry 直到有 inode 释放
+    while (d && !inode_free && dentry_lru.lru_prev != &dentry_lru) {
+        d_evict(dentry_lru.lru_prev);
+    }
+    vfs_inode_t *inode = d ? inode_alloc() : NULL;
+    if (!inode) {
+        if (d) {
+            d->hash_next = dentry_free;
+            dentry_free = d;
+        }
+        return NULL;
+    }
+
+    // 先以 BUSY 状态插入哈希表，查找期间同名的解析会等待而不是重复查找
+    memcpy(d->name, name, len);
+    d->len = len;
+    d->hash = hash;
+    d->flags = VFS_D_BUSY;
+    d->parent = dir;
+    d->refcount = 1;
+    dget(dir);
+    vfs_dentry_t **bucket = &dcache_hash[dcache_hashfn(dir, hash)];
+    d->hash_next = *bucket;
+    *bucket = d;
+
+    vfs_inode_t *dir_inode = dir->inode;
+    spin_unlock_irqrestore(&vfs_lock, *flags);
+    int ret = dir_inode->ops->lookup(dir_inode, d->name, len, inode);
+    *flags = spin_lock_irqsave(&vfs_lock);
+
+    if (ret == 0) {
+        inode->ops = dir_inode->ops;
+        inode->refcount = 1;
+        d->inode = inode;
+    } else {
+        inode_free_one(inode);
+    }
+    d->flags = 0;
+    vfs_events++;
+
+    // 唤醒等待同名查找的线程（不能持锁唤醒；d 与 dir 都被持有，放锁是安全的）
+    spin_unlock_irqrestore(&vfs_lock, *flags);
+    wait_queue_wake_all(&vfs_wq);
+    *flags = spin_lock_irqsave(&vfs_lock);
+    return d;
+}
+
+/* 逐个分量解析：每个分量只扫描一次（同时求长度与哈希），命中时不访问文件系统 */
+static vfs_dentry_t *path_walk(const char *path, uint32_t *flags) {
+    vfs_dentry_t *d = vfs_root;
+    if (!d) {
+        return NULL;
+    }
+    dget(d);
+
+    const char *p = path;
+    for (;;) {
+        while (*p == '/') {
+            p++;
+        }
+        if (!*p) {
+            return d;
+        }
+
+        // 分量名的 FNV-1a 与长度在同一遍扫描中得到
+        const char *name = p;
+        uint32_t hash = 2166136261u;
+        while (*p && *p != '/') {
+            hash = (hash ^ (uint8_t)*p++) * 16777619u;
+        }
+        uint32_t len = p - name;
+
+        if (!d->inode || d->inode->type != VFS_DIR || len > VFS_NAME_MAX) {
+            break;
+        }
+        if (len == 1 && name[0] == '.') {
+            continue;
+        }
+        if (len == 2 && name[0] == '.' && name[1] == '.') {
+            if (d->parent) {
+                vfs_dentry_t *parent = d->parent;
+                dget(parent);
+                dput_locked(d);
+                d = parent;
+            }
+            continue;
+        }
+
+        vfs_dentry_t *child = d_lookup_child(d, name, len, hash, flags);
+        dput_locked(d);
+        if (!child) {
+            return NULL;
+        }
+        d = child;
+    }
+
+    dput_locked(d);
+    return NULL;
+}
+
+/* ========== 接口 ========== */
+
+void vfs_init(void) {
+    spin_lock_init(&vfs_lock, "vfs");
+    wait_queue_init(&vfs_wq, "vfs_wq");
+    memset(&stats, 0, sizeof(stats));
+    memset(dcache_hash, 0, sizeof(dcache_hash));
+    memset(vfs_files, 0, sizeof(vfs_files));
+    vfs_root = NULL;
+
+    inode_free = NULL;
+    for (int i = VFS_INODES - 1; i >= 0; i--) {
+        inode_free_one(&vfs_inodes[i]);
+    }
+    dentry_free = NULL;
+    for (int i = VFS_DENTRIES - 1; i >= 0; i--) {
+        vfs_dentries[i].hash_next = dentry_free;
+        dentry_free = &vfs_dentries[i];
+    }
+    dentry_lru.lru_next = dentry_lru.lru_prev = &dentry_lru;
+
+    radix_free = NULL;
+    for (int i = VFS_RADIX_NODES - 1; i >= 0; i--) {
+        radix_node_free(&radix_nodes[i]);
+    }
+    page_lru.lru_next = page_lru.lru_prev = &page_lru;
+    for (uint32_t i = 0; i < VFS_PAGES; i++) {
+        vfs_pages[i].inode = NULL;
+        vfs_pages[i].flags = 0;
+        vfs_pages[i].data = vfs_page_data[i];
+        page_lru_push_back(&vfs_pages[i]);
+    }
+}
+
+int vfs_mount_root(const vfs_inode_ops_t *ops, void *root_priv) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    if (vfs_root) {
+        spin_unlock_irqrestore(&vfs_lock, flags);
+        return -1;
+    }
+
+    vfs_dentry_t *d = d_alloc();
+    vfs_inode_t *inode = d ? inode_alloc() : NULL;
+    if (!inode) {
+        spin_unlock_irqrestore(&vfs_lock, flags);
+        return -1;
+    }
+    inode->ops = ops;
+    inode->priv = root_priv;
+    inode->type = VFS_DIR;
+    inode->mode = 0555;
+    inode->refcount = 1;
+    d->inode = inode;
+    d->refcount = 1;            // 根 dentry 永不淘汰
+    vfs_root = d;
+
+    spin_unlock_irqrestore(&vfs_lock, flags);
+    return 0;
+}
+
+/* 挂载前清掉目录下缓存的子项（它们会遮住新文件系统）；有子项仍被引用时返回 -1 */
+static int d_drop_children(vfs_dentry_t *dir) {
+    for (uint32_t i = 0; i < VFS_DCACHE_HASH; i++) {
+        for (vfs_dentry_t *c = dcache_hash[i]; c; c = c->hash_next) {
+            if (c->parent == dir && c->refcount) {
+                return -1;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < VFS_DCACHE_HASH; i++) {
+        vfs_dentry_t *c = dcache_hash[i];
+        while (c) {
+            vfs_dentry_t *next = c->hash_next;
+            if (c->parent == dir) {
+                d_evict(c);
+            }
+            c = next;
+        }
+    }
+    return 0;
+}
+
+int vfs_mount(const char *path, const vfs_inode_ops_t *ops, void *root_priv) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    vfs_dentry_t *d = path_walk(path, &flags);
+    if (!d) {
+        spin_unlock_irqrestore(&vfs_lock, flags);
+        return -1;
+    }
+
+    vfs_inode_t *inode = NULL;
+    if (d != vfs_root && (!d->inode || d->inode->type == VFS_DIR) &&
+        d_drop_children(d) == 0) {
+        inode = inode_alloc();
+    }
+    if (!inode) {
+        dput_locked(d);
+        spin_unlock_irqrestore(&vfs_lock, flags);
+        return -1;
+    }
+    inode->ops = ops;
+    inode->priv = root_priv;
+    inode->type = VFS_DIR;
+    inode->mode = 0555;
+    inode->refcount = 1;
+    if (d->inode) {
+        iput(d->inode);
+    }
+    d->inode = inode;
+
+    // 保留 path_walk 得到的引用：挂载点（可以是原来不存在的负项）永不淘汰
+    spin_unlock_irqrestore(&vfs_lock, flags);
+    return 0;
+}
+
+vfs_dentry_t *vfs_lookup(const char *path) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    vfs_dentry_t *d = path_walk(path, &flags);
+    if (d && !d->inode) {
+        dput_locked(d);
+        d = NULL;
+    }
+    spin_unlock_irqrestore(&vfs_lock, flags);
+    return d;
+}
+
+void vfs_dput(vfs_dentry_t *dentry) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    dput_locked(dentry);
+    spin_unlock_irqrestore(&vfs_lock, flags);
+}
+
+vfs_file_t *vfs_open(const char *path) {
+    vfs_dentry_t *d = vfs_lookup(path);
+    if (!d) {
+        return NULL;
+    }
+    if (d->inode->type != VFS_FILE) {
+        vfs_dput(d);
+        return NULL;
+    }
+
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    for (uint32_t i = 0; i < VFS_FILES; i++) {
+        if (!vfs_files[i].dentry) {
+            vfs_files[i].dentry = d;
+            vfs_files[i].pos = 0;
+            spin_unlock_irqrestore(&vfs_lock, flags);
+            return &vfs_files[i];
+        }
+    }
+    dput_locked(d);
+    spin_unlock_irqrestore(&vfs_lock, flags);
+    return NULL;
+}
+
+void vfs_close(vfs_file_t *file) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    dput_locked(file->dentry);
+    file->dentry = NULL;
+    spin_unlock_irqrestore(&vfs_lock, flags);
+}
+
+/* 从 inode 第 index 页的 offset 处拷贝 len 字节，页不在缓存中时先读入 */
+static int page_copy(vfs_inode_t *inode, uint32_t index, uint32_t offset, void *dst,
+                     uint32_t len) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    vfs_page_t *p;
+
+    for (;;) {
+        p = radix_lookup(&inode->pages, index);
+        if (p) {
+            if (p->flags & VFS_P_BUSY) {
+                uint32_t seen = vfs_events;
+                spin_unlock_irqrestore(&vfs_lock, flags);
+                vfs_wait(seen);
+                flags = spin_lock_irqsave(&vfs_lock);
+                continue;
+            }
+            stats.p_hits++;
+            memcpy(dst, p->data + offset, len);
+            page_lru_remove(p);
+            page_lru_push_front(p);
+            spin_unlock_irqrestore(&vfs_lock, flags);
+            return 0;
+        }
+
+        p = page_find_victim();
+        if (p) {
+            break;
+        }
+        // 所有页都在读入中：等其中一个完成
+        uint32_t seen = vfs_events;
+        spin_unlock_irqrestore(&vfs_lock, flags);
+        vfs_wait(seen);
+        flags = spin_lock_irqsave(&vfs_lock);
+    }
+
+    if (p->inode) {
+        page_drop(p);
+        stats.p_evictions++;
+    }
+    if (radix_insert(&inode->pages, index, p) < 0) {
+        spin_unlock_irqrestore(&vfs_lock, flags);
+        return -1;
+    }
+    stats.p_misses++;
+    p->inode = inode;
+    p->index = index;
+    p->flags = VFS_P_BUSY;
+    inode->nr_pages++;
+    page_lru_remove(p);
+    page_lru_push_front(p);
+    spin_unlock_irqrestore(&vfs_lock, flags);
+
+    int ret = inode->ops->readpage(inode, index, p->data);
+
+    flags = spin_lock_irqsave(&vfs_lock);
+    if (ret < 0) {
+        page_drop(p);
+    } else {
+        p->flags = VFS_P_VALID;
+        memcpy(dst, p->data + offset, len);
+    }
+    vfs_events++;
+    spin_unlock_irqrestore(&vfs_lock, flags);
+    wait_queue_wake_all(&vfs_wq);
+    return ret < 0 ? -1 : 0;
+}
+
+int vfs_read(vfs_file_t *file, void *buf, uint32_t len) {
+    vfs_inode_t *inode = file->dentry->inode;
+    uint32_t pos = file->pos;
+    uint32_t done = 0;
+
+    if (pos >= inode->size) {
+        return 0;
+    }
+    if (len > inode->size - pos) {
+        len = inode->size - pos;
+    }
+
+    // 内容已经在内存中：直接复制，不占用页缓存
+    while (inode->ops->map && done < len) {
+        uint32_t avail;
+        const void *src = inode->ops->map(inode, pos, &avail);
+        if (!src || !avail) {
+            break;
+        }
+        uint32_t n = avail < len - done ? avail : len - done;
+        memcpy((uint8_t *)buf + done, src, n);
+        done += n;
+        pos += n;
+    }
+
+    while (!inode->ops->map && done < len) {
+        uint32_t offset = pos & (VFS_PAGE_SIZE - 1);
+        uint32_t n = VFS_PAGE_SIZE - offset;
+        if (n > len - done) {
+            n = len - done;
+        }
+        if (page_copy(inode, pos >> VFS_PAGE_SHIFT, offset, (uint8_t *)buf + done, n) < 0) {
+            break;
+        }
+        done += n;
+        pos += n;
+    }
+
+    file->pos = pos;
+    return (done || !len) ? (int)done : -1;
+}
+
+int vfs_seek(vfs_file_t *file, uint32_t pos) {
+    if (pos > file->dentry->inode->size) {
+        return -1;
+    }
+    file->pos = pos;
+    return 0;
+}
+
+void vfs_get_stats(vfs_stats_t *out) {
+    uint32_t flags = spin_lock_irqsave(&vfs_lock);
+    *out = stats;
+    spin_unlock_irqrestore(&vfs_lock, flags);
+}
+
+static uint32_t percent(uint32_t part, uint32_t total) {
+    if (!total) {
+        return 0;
+    }
+    return total >= 0x01000000 ? part / (total / 100) : part * 100 / total;
+}
+
+void vfs_report(void) {
+    vfs_stats_t s;
+    vfs_get_stats(&s);
+
+    pr_info("vfs: dcache %u hits (%u negative), %u misses (%u%% hit rate), %u evictions\n",
+            s.d_hits, s.d_negative, s.d_misses, percent(s.d_hits, s.d_hits + s.d_misses),
+            s.d_evictions);
+    pr_info("vfs: page cache %u hits, %u misses (%u%% hit rate), %u evictions\n",
+            s.p_hits, s.p_misses, percent(s.p_hits, s.p_hits + s.p_misses), s.p_evictions);
+}
@@ -0,0 +1,144 @@
+#include <kernel/virtio.h>
+#include <kernel/io.h>
+#include <kernel/paging.h>
+#include <kernel/string.h>
+
+uint32_t virtio_pci_negotiate(uint16_t iobase, uint32_t wanted) {
+    // 写 0 复位设备，然后表明“已发现设备”“有驱动”
+    outb(iobase + VIRTIO_PCI_STATUS, 0);
+    virtio_pci_add_status(iobase, VIRTIO_STATUS_ACKNOWLEDGE);
+    virtio_pci_add_status(iobase, VIRTIO_STATUS_DRIVER);
+
+    uint32_t features = inl(iobase + VIRTIO_PCI_HOST_FEATURES) & wanted;
+    outl(iobase + VIRTIO_PCI_GUEST_FEATURES, features);
+    return features;
+}
+
+void virtio_pci_add_status(uint16_t iobase, uint8_t status) {
+    outb(iobase + VIRTIO_PCI_STATUS, inb(iobase + VIRTIO_PCI_STATUS) | status);
+}
+
+int virtio_pci_setup_queue(virtqueue_t *vq, uint16_t iobase, uint16_t index,
+                           void *mem, uint32_t mem_size, int event_idx) {
+    outw(iobase + VIRTIO_PCI_QUEUE_SEL, index);
+    uint16_t size = inw(iobase + VIRTIO_PCI_QUEUE_SIZE);
+    if (size == 0 || (size & (size - 1)) || VRING_SIZE(size) > mem_size) {
+        return -1;
+    }
+
+    memset(mem, 0, VRING_SIZE(size));
+    vq->iobase = iobase;
+    vq->index = index;
+    vq->size = size;
+    vq->desc = mem;
+    vq->avail = (void *)((uint8_t *)mem + 16 * size);
+    vq->used = (void *)((uint8_t *)mem + VRING_ALIGN(16 * size + 6 + 2 * size));
+    vq->event_idx = event_idx;
+    vq->avail_idx = 0;
+    vq->kicked_idx = 0;
+    vq->last_used = 0;
+
+    // 所有描述符串成空闲链表
+    for (uint16_t i = 0; i < size; i++) {
+        vq->desc[i].next = i + 1;
+    }
+    vq->free_head = 0;
+    vq->num_free = size;
+
+    outl(iobase + VIRTIO_PCI_QUEUE_PFN, paging_virt_to_phys((uint32_t)mem) >> 12);
+    return 0;
+}
+
+int virtqueue_add(virtqueue_t *vq, const virtq_sg_t *sg, uint32_t out, uint32_t in) {
+    uint32_t total = out + in;
+    if (total == 0 || total > vq->num_free) {
+        return -1;
+    }
+
+    // 直接沿空闲链表取描述符：链内的 next 正好就是空闲链表的链接
+    uint16_t head = vq->free_head;
+    uint16_t idx = head;
+    for (uint32_t i = 0; i < total; i++) {
+        volatile struct vring_desc *d = &vq->desc[idx];
+        d->addr = sg[i].addr;
+        d->len = sg[i].len;
+        d->flags = (i < out ? 0 : VRING_DESC_F_WRITE) |
+                   (i + 1 < total ? VRING_DESC_F_NEXT : 0);
+        if (i + 1 < total) {
+            idx = d->next;
+        }
+    }
+    vq->free_head = vq->desc[idx].next;
+    vq->num_free -= total;
+
+    // 先写环项再更新 idx；x86 的存储不会重排，只需阻止编译器重排
+    vq->avail->ring[vq->avail_idx & (vq->size - 1)] = head;
+    asm volatile ("" : : : "memory");
+    vq->avail_idx++;
+    vq->avail->idx = vq->avail_idx;
+    return head;
+}
+
+/* 从 old 推进到 new 的过程中是否越过了 event（virtio 规范中的 vring_need_event） */
+static inline int vring_need_event(uint16_t event, uint16_t new_idx, uint16_t old_idx) {
+    return (uint16_t)(new_idx - event - 1) < (uint16_t)(new_idx - old_idx);
+}
+
+int virtqueue_kick_prepare(virtqueue_t *vq) {
+    uint16_t old_idx = vq->kicked_idx;
+    uint16_t new_idx = vq->avail_idx;
+    vq->kicked_idx = new_idx;
+
+    // 写 avail->idx 与读设备的 avail_event 之间需要 StoreLoad 屏障
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (old_idx == new_idx) {
+        return 0;
+    }
+    if (vq->event_idx) {
+        uint16_t avail_event = *(volatile uint16_t *)&vq->used->ring[vq->size];
+        return vring_need_event(avail_event, new_idx, old_idx);
+    }
+    return !(vq->used->flags & VRING_USED_F_NO_NOTIFY);
+}
+
+void virtqueue_notify(virtqueue_t *vq) {
+    outw(vq->iobase + VIRTIO_PCI_QUEUE_NOTIFY, vq->index);
+}
+
+int virtqueue_get_used(virtqueue_t *vq, uint32_t *len) {
+    if (vq->last_used == vq->used->idx) {
+        return -1;
+    }
+    asm volatile ("" : : : "memory");
+
+    volatile struct vring_used_elem *e = &vq->used->ring[vq->last_used & (vq->size - 1)];
+    uint16_t head = e->id;
+    if (len) {
+        *len = e->len;
+    }
+    vq->last_used++;
+
+    // 把整条链挂回空闲链表头
+    uint16_t tail = head;
+    uint16_t n = 1;
+    while (vq->desc[tail].flags & VRING_DESC_F_NEXT) {
+        tail = vq->desc[tail].next;
+        n++;
+    }
+    vq->desc[tail].next = vq->free_head;
+    vq->free_head = head;
+    vq->num_free += n;
+    return head;
+}
+
+int virtqueue_enable_cb(virtqueue_t *vq) {
+    if (vq->event_idx) {
+        // used_event：已用环越过这个位置时才产生中断
+        *(volatile uint16_t *)&vq->avail->ring[vq->size] = vq->last_used;
+    } else {
+        vq->avail->flags &= ~VRING_AVAIL_F_NO_INTERRUPT;
+    }
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return vq->last_used != vq->used->idx;
+}
@@ -0,0 +1,371 @@
+#include <kernel/virtio_blk.h>
+#include <kernel/virtio.h>
+#include <kernel/blkdev.h>
+#include <kernel/pci.h>
+#include <kernel/io.h>
+#include <kernel/idt.h>
+#include <kernel/paging.h>
+#include <kernel/printk.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/waitqueue.h>
+#include <stddef.h>
+
+/* 块设备特性位 */
+#define VIRTIO_BLK_F_SEG_MAX    (1u << 2)
+#define VIRTIO_BLK_F_RO         (1u << 5)
+#define VIRTIO_BLK_F_FLUSH      (1u << 9)
+
+/* 设备配置空间偏移 */
+#define VIRTIO_BLK_CFG_CAPACITY 0       // 64 位扇区数
+#define VIRTIO_BLK_CFG_SEG_MAX  12
+
+/* 请求类型与状态 */
+#define VIRTIO_BLK_T_IN     0
+#define VIRTIO_BLK_T_OUT    1
+#define VIRTIO_BLK_T_FLUSH  4
+#define VIRTIO_BLK_S_OK     0
+
+/* 每个请求：头 + 最多 (64KB / 4KB + 1) 个数据段 + 状态 */
+#define VBLK_MAX_SEGS   (VIRTIO_BLK_REQ_SECTORS * BLKDEV_SECTOR_SIZE / PAGE_SIZE + 1)
+
+typedef struct {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+} __attribute__((packed)) virtio_blk_req_hdr_t;
+
+/* 一次 blkdev 调用拆出的一组请求，全部完成时唤醒提交者 */
+typedef struct {
+    volatile uint32_t pending;
+    volatile uint32_t error;
+} vblk_batch_t;
+
+typedef struct {
+    virtio_blk_req_hdr_t hdr;
+    volatile uint8_t status;    // 设备写入
+    uint8_t in_use;
+    vblk_batch_t *batch;
+} vblk_req_t;
+
+static struct {
+    uint16_t iobase;
+    uint8_t irq;
+    uint32_t features;
+    uint32_t max_sectors;       // 受 SEG_MAX 限制后的单请求扇区数
+    spinlock_t lock;            // 保护队列与请求槽
+    virtqueue_t vq;
+    waitqueue_t wq;             // 提交者等待槽位或批次完成
+    waitqueue_t bh_wq;          // 下半部线程等待中断
+    volatile uint32_t bh_pending;
+    vblk_req_t reqs[VIRTIO_BLK_MAX_REQS];
+    vblk_req_t *req_by_head[VIRTQ_MAX_SIZE];
+    uint32_t completions;       // 已完成的请求数（等待者据此判断是否有进展）
+    blkdev_t blk;
+} vblk;
+
+/* 传统接口要求队列物理连续、页对齐 */
+static uint8_t vblk_ring[VRING_SIZE(VIRTQ_MAX_SIZE)] __attribute__((aligned(4096)));
+
+/* ========== 完成处理 ========== */
+
+/* 回收所有已完成的请求（调用者持有 vblk.lock），返回是否有请求完成 */
+static int vblk_reap_locked(void) {
+    int reaped = 0;
+    int head;
+
+    do {
+        while ((head = virtqueue_get_used(&vblk.vq, NULL)) >= 0) {
+            vblk_req_t *req = vblk.req_by_head[head];
+            vblk.req_by_head[head] = NULL;
+            if (!req) {
+                continue;
+            }
+            if (req->status != VIRTIO_BLK_S_OK) {
+                req->batch->error = 1;
+            }
+            req->batch->pending--;
+            req->in_use = 0;
+            vblk.completions++;
+            reaped = 1;
+        }
+        // 重新打开中断后再检查一次，避免漏掉期间完成的请求
+    } while (virtqueue_enable_cb(&vblk.vq));
+
+    return reaped;
+}
+
+static void vblk_reap(void) {
+    uint32_t flags = spin_lock_irqsave(&vblk.lock);
+    int reaped = vblk_reap_locked();
+    spin_unlock_irqrestore(&vblk.lock, flags);
+
+    if (reaped) {
+        wait_queue_wake_all(&vblk.wq);
+    }
+}
+
+/* 上半部：读 ISR 应答中断，其余交给下半部线程。
+ * IRQ 线可能与其他 PCI 设备共享，ISR 为 0 说明中断不是本设备发出的 */
+static int vblk_irq_handler(struct registers *regs, void *dev) {
+    (void)regs;
+    (void)dev;
+    uint8_t isr = inb(vblk.iobase + VIRTIO_PCI_ISR);
+    if (isr & VIRTIO_ISR_QUEUE) {
+        vblk.bh_pending = 1;
+        wait_queue_wake_all(&vblk.bh_wq);
+    }
+    return isr != 0;
+}
+
+/* 下半部：在线程上下文中回收完成的请求并唤醒提交者 */
+static void vblk_bh_thread(void *arg) {
+    (void)arg;
+    for (;;) {
+        wait_event(&vblk.bh_wq, vblk.bh_pending);
+        vblk.bh_pending = 0;
+        vblk_reap();
+    }
+}
+
+/* ========== 提交 ========== */
+
+static vblk_req_t *vblk_alloc_req_locked(void) {
+    for (int i = 0; i < VIRTIO_BLK_MAX_REQS; i++) {
+        if (!vblk.reqs[i].in_use) {
+            vblk.reqs[i].in_use = 1;
+            return &vblk.reqs[i];
+        }
+    }
+    return NULL;
+}
+
+/* 把 [vaddr, vaddr+bytes) 按物理页拆成段，返回段数，遇到未映射的页返回 -1 */
+static int vblk_build_sg(virtq_sg_t *sg, uint32_t vaddr, uint32_t bytes) {
+    int n = 0;
+    while (bytes) {
+        uint32_t chunk = PAGE_SIZE - (vaddr & (PAGE_SIZE - 1));
+        if (chunk > bytes) {
+            chunk = bytes;
+        }
+        uint32_t phys = paging_virt_to_phys(vaddr);
+        if (!phys) {
+            return -1;
+        }
+        // 物理连续则与前一段合并
+        if (n > 0 && sg[n - 1].addr + sg[n - 1].len == phys) {
+            sg[n - 1].len += chunk;
+        } else {
+            sg[n].addr = phys;
+            sg[n].len = chunk;
+            n++;
+        }
+        vaddr += chunk;
+        bytes -= chunk;
+    }
+    return n;
+}
+
+/* 入队一个请求（不通知设备）；槽位或描述符不足返回 0，出错返回 -1，成功返回 1 */
+static int vblk_queue_locked(uint32_t type, uint32_t lba, uint32_t count, void *buf,
+                             vblk_batch_t *batch) {
+    virtq_sg_t sg[VBLK_MAX_SEGS + 2];
+    int nseg = 0;
+
+    if (count) {
+        nseg = vblk_build_sg(&sg[1], (uint32_t)buf, count * BLKDEV_SECTOR_SIZE);
+        if (nseg < 0) {
+            return -1;
+        }
+    }
+    if (vblk.vq.num_free < nseg + 2) {
+        return 0;
+    }
+    vblk_req_t *req = vblk_alloc_req_locked();
+    if (!req) {
+        return 0;
+    }
+
+    req->hdr.type = type;
+    req->hdr.reserved = 0;
+    req->hdr.sector = lba;
+    req->status = 0xFF;
+    req->batch = batch;
+
+    // 头只读；读请求的数据段由设备写入；状态字节总是设备写
+    sg[0].addr = paging_virt_to_phys((uint32_t)&req->hdr);
+    sg[0].len = sizeof(req->hdr);
+    sg[nseg + 1].addr = paging_virt_to_phys((uint32_t)&req->status);
+    sg[nseg + 1].len = 1;
+
+    uint32_t out = (type == VIRTIO_BLK_T_OUT) ? 1 + nseg : 1;
+    int head = virtqueue_add(&vblk.vq, sg, out, nseg + 2 - out);
+    vblk.req_by_head[head] = req;
+    batch->pending++;
+    return 1;
+}
+
+/* 需要时通知设备（调用者已释放锁） */
+static void vblk_kick(int need) {
+    if (need) {
+        virtqueue_notify(&vblk.vq);
+    }
+}
+
+/* 等待有请求完成：能睡眠时等下半部唤醒，否则自己轮询已用环。
+ * seen 是持锁时读到的完成计数，之后的任何完成都会让等待结束。 */
+static void vblk_wait(uint32_t seen) {
+    if (thread_can_sleep() && vblk.irq != 0xFF) {
+        wait_event(&vblk.wq, vblk.completions != seen);
+    } else {
+        vblk_reap();
+        asm volatile ("pause");
+    }
+}
+
+/* 把一次读写拆成多个请求连续入队，只在末尾（或队列满时）通知一次设备；
+ * count 为 0 时提交一个不带数据的请求（冲刷） */
+static int vblk_submit(uint32_t type, uint32_t lba, uint32_t count, uint8_t *buf) {
+    vblk_batch_t batch = { 0, 0 };
+
+    for (;;) {
+        uint32_t n = count > vblk.max_sectors ? vblk.max_sectors : count;
+
+        uint32_t flags = spin_lock_irqsave(&vblk.lock);
+        int ret = vblk_queue_locked(type, lba, n, buf, &batch);
+        uint32_t seen = vblk.completions;
+        int need = (ret == 0) ? virtqueue_kick_prepare(&vblk.vq) : 0;
+        spin_unlock_irqrestore(&vblk.lock, flags);
+
+        if (ret < 0) {
+            batch.error = 1;
+            break;
+        }
+        if (ret == 0) {
+            // 队列已满：让设备先处理已入队的请求，等待有空位
+            vblk_kick(need);
+            vblk_wait(seen);
+            continue;
+        }
+
+        lba += n;
+        count -= n;
+        buf += n * BLKDEV_SECTOR_SIZE;
+        if (count == 0) {
+            break;
+        }
+    }
+
+    uint32_t flags = spin_lock_irqsave(&vblk.lock);
+    int need = virtqueue_kick_prepare(&vblk.vq);
+    spin_unlock_irqrestore(&vblk.lock, flags);
+    vblk_kick(need);
+
+    for (;;) {
+        flags = spin_lock_irqsave(&vblk.lock);
+        uint32_t seen = vblk.completions;
+        uint32_t pending = batch.pending;
+        spin_unlock_irqrestore(&vblk.lock, flags);
+        if (pending == 0) {
+            break;
+        }
+        vblk_wait(seen);
+    }
+    return batch.error ? -1 : 0;
+}
+
+/* ========== 块设备接口 ========== */
+
+static int vblk_read(blkdev_t *dev, uint32_t lba, uint32_t count, void *buf) {
+    (void)dev;
+    return vblk_submit(VIRTIO_BLK_T_IN, lba, count, buf);
+}
+
+static int vblk_write(blkdev_t *dev, uint32_t lba, uint32_t count, const void *buf) {
+    (void)dev;
+    if (vblk.features & VIRTIO_BLK_F_RO) {
+        return -1;
+    }
+    return vblk_submit(VIRTIO_BLK_T_OUT, lba, count, (uint8_t *)buf);
+}
+
+static int vblk_flush(blkdev_t *dev) {
+    (void)dev;
+    if (!(vblk.features & VIRTIO_BLK_F_FLUSH)) {
+        return 0;
+    }
+    return vblk_submit(VIRTIO_BLK_T_FLUSH, 0, 0, NULL);
+}
+
+static const blkdev_ops_t vblk_ops = {
+    .read = vblk_read,
+    .write = vblk_write,
+    .flush = vblk_flush,
+};
+
+/* ========== 初始化 ========== */
+
+void virtio_blk_init(void) {
+    pci_device_t *pdev = pci_find_device(VIRTIO_PCI_VENDOR, VIRTIO_PCI_DEVICE_BLK, 0);
+    if (!pdev || !(pdev->bar[0] & PCI_BAR_IO)) {
+        return;
+    }
+
+    vblk.iobase = pdev->bar[0] & ~3;
+    vblk.irq = pdev->irq < IRQ_COUNT ? pdev->irq : 0xFF;
+    spin_lock_init(&vblk.lock, "virtio_blk");
+    wait_queue_init(&vblk.wq, "vblk_wq");
+    wait_queue_init(&vblk.bh_wq, "vblk_bh");
+    pci_enable_bus_master(pdev);
+
+    vblk.features = virtio_pci_negotiate(vblk.iobase, VIRTIO_RING_F_EVENT_IDX |
+                                         VIRTIO_BLK_F_SEG_MAX | VIRTIO_BLK_F_RO |
+                                         VIRTIO_BLK_F_FLUSH);
+
+    if (virtio_pci_setup_queue(&vblk.vq, vblk.iobase, 0, vblk_ring, sizeof(vblk_ring),
+                               (vblk.features & VIRTIO_RING_F_EVENT_IDX) != 0) < 0) {
+        pr_err("virtio-blk: unsupported queue size\n");
+        virtio_pci_add_status(vblk.iobase, VIRTIO_STATUS_FAILED);
+        return;
+    }
+
+    // 设备限制了每个请求的段数时相应缩小单请求大小（一个段至少一页）
+    vblk.max_sectors = VIRTIO_BLK_REQ_SECTORS;
+    if (vblk.features & VIRTIO_BLK_F_SEG_MAX) {
+        uint32_t seg_max = inl(vblk.iobase + VIRTIO_PCI_CONFIG + VIRTIO_BLK_CFG_SEG_MAX);
+        if (seg_max > 1 && seg_max < VBLK_MAX_SEGS) {
+            vblk.max_sectors = (seg_max - 1) * (PAGE_SIZE / BLKDEV_SECTOR_SIZE);
+        }
+    }
+
+    // 容量超过 LBA32 时只使用前 2TB
+    uint32_t cap_lo = inl(vblk.iobase + VIRTIO_PCI_CONFIG + VIRTIO_BLK_CFG_CAPACITY);
+    uint32_t cap_hi = inl(vblk.iobase + VIRTIO_PCI_CONFIG + VIRTIO_BLK_CFG_CAPACITY + 4);
+
+    // 没有可用中断时全部轮询，不需要下半部线程
+    if (vblk.irq != 0xFF) {
+        if (!thread_create("virtio_blk", vblk_bh_thread, NULL, THREAD_PRIO_INTERACTIVE)) {
+            vblk.irq = 0xFF;
+        } else if (register_irq_shared(vblk.irq, vblk_irq_handler, &vblk) < 0) {
+            // 下半部线程空等即可，请求全部轮询完成
+            pr_warn("virtio-blk: irq %u unavailable, polling\n", vblk.irq);
+            vblk.irq = 0xFF;
+        }
+    }
+    virtqueue_enable_cb(&vblk.vq);
+    virtio_pci_add_status(vblk.iobase, VIRTIO_STATUS_DRIVER_OK);
+
+    vblk.blk.name[0] = 'v';
+    vblk.blk.name[1] = 'd';
+    vblk.blk.name[2] = 'a';
+    vblk.blk.name[3] = '\0';
+    vblk.blk.sector_count = cap_hi ? 0xFFFFFFFF : cap_lo;
+    vblk.blk.sector_size = BLKDEV_SECTOR_SIZE;
+    vblk.blk.ops = &vblk_ops;
+    vblk.blk.priv = &vblk;
+
+    pr_info("virtio-blk: queue %u, irq %u, event_idx %s%s\n", vblk.vq.size, vblk.irq,
+            (vblk.features & VIRTIO_RING_F_EVENT_IDX) ? "on" : "off",
+            (vblk.features & VIRTIO_BLK_F_RO) ? ", read-only" : "");
+    blkdev_register(&vblk.blk);
+}
@@ -0,0 +1,62 @@
+#include <kernel/waitqueue.h>
+#include <stddef.h>
+
+void wait_queue_init(waitqueue_t *wq, const char *name) {
+    spin_lock_init(&wq->lock, name);
+    wq->head = NULL;
+}
+
+void wait_queue_prepare(waitqueue_t *wq) {
+    thread_t *cur = thread_current();
+    uint32_t flags = spin_lock_irqsave(&wq->lock);
+
+    // 已在队列中（上一轮被其他原因唤醒）时不重复插入
+    thread_t *t = wq->head;
+    while (t && t != cur) {
+        t = t->wait_next;
+    }
+    if (!t) {
+        cur->wait_next = wq->head;
+        wq->head = cur;
+    }
+
+    spin_unlock_irqrestore(&wq->lock, flags);
+}
+
+void wait_queue_finish(waitqueue_t *wq) {
+    thread_t *cur = thread_current();
+    uint32_t flags = spin_lock_irqsave(&wq->lock);
+
+    thread_t **link = &wq->head;
+    while (*link) {
+        if (*link == cur) {
+            *link = cur->wait_next;
+            break;
+        }
+        link = &(*link)->wait_next;
+    }
+    cur->wait_next = NULL;
+
+    spin_unlock_irqrestore(&wq->lock, flags);
+}
+
+void wait_queue_wake_all(waitqueue_t *wq) {
+    uint32_t flags = spin_lock_irqsave(&wq->lock);
+
+    // 摘下整条链表后逐个唤醒，等待者自己的 finish 会发现已不在队列中
+    thread_t *t = wq->head;
+    wq->head = NULL;
+    while (t) {
+        thread_t *next = t->wait_next;
+        t->wait_next = NULL;
+        thread_wake(t);
+        t = next;
+    }
+
+    spin_unlock_irqrestore(&wq->lock, flags);
+
+    // 线程上下文中立即让出给被唤醒的高优先级线程，中断上下文留给 IRQ 返回前
+    if (flags & 0x200) {
+        thread_preempt();
+    }
+}
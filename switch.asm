@@ -0,0 +1,70 @@
+; 线程上下文切换
+section .text
+
+global switch_context
+global thread_trampoline
+global enter_user_mode
+
+extern thread_exit
+extern thread_finish_switch
+
+; void switch_context(uint32_t *old_esp, uint32_t new_esp)
+; 只保存被调用者保存的寄存器，其余寄存器由调用约定保证
+switch_context:
+    mov eax, [esp + 4]      ; 保存旧栈指针的位置
+    mov edx, [esp + 8]      ; 新线程的栈指针
+
+    push ebp
+    push ebx
+    push esi
+    push edi
+
+    mov [eax], esp          ; 保存当前线程栈指针
+    mov esp, edx            ; 切换到新线程栈
+
+    pop edi
+    pop esi
+    pop ebx
+    pop ebp
+    ret
+
+; 新线程入口：ebx = 线程函数，esi = 参数
+thread_trampoline:
+    call thread_finish_switch   ; 回收刚切换走的已退出线程
+    sti                     ; 新线程从关中断的 schedule 中进入
+    push esi
+    call ebx
+    add esp, 4
+    call thread_exit        ; 线程函数返回即退出
+.hang:
+    hlt
+    jmp .hang
+
+; void enter_user_mode(uint32_t eip, uint32_t esp)
+; 构造 iret 帧进入 ring 3，之后陷入内核时使用 TSS.esp0 指向的内核栈
+enter_user_mode:
+    cli
+    mov ecx, [esp + 4]      ; 用户入口
+    mov edx, [esp + 8]      ; 用户栈
+
+    mov ax, 0x23            ; 用户数据段 | RPL 3
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+
+    push dword 0x23         ; ss
+    push edx                ; esp
+    push dword 0x202        ; eflags：IF=1
+    push dword 0x1B         ; cs：用户代码段 | RPL 3
+    push ecx                ; eip
+
+    ; 不把内核寄存器值带入用户态
+    xor eax, eax
+    xor ebx, ebx
+    xor ecx, ecx
+    xor edx, edx
+    xor esi, esi
+    xor edi, edi
+    xor ebp, ebp
+    iret
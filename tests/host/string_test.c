@@ -0,0 +1,597 @@
+/* kernel/string.c 的宿主机单元测试与微基准
+ *
+ * make test-host 用内核的编译选项编译 string.c，再用 objcopy --prefix-symbols=k_
+ * 给所有符号加上前缀，这样内核实现（k_memcpy 等）可以和 libc 链接进同一个 32 位程序，
+ * 逐一与 libc 的结果比较。需要 32 位 libc（Debian/Ubuntu: gcc-multilib）。
+ *
+ *     ./string_test [--no-bench] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <kernel/cpu_features.h>
+
+/* ---- 带 k_ 前缀的内核实现 ---- */
+
+size_t k_strlen(const char *str);
+void *k_memset(void *ptr, uint8_t value, size_t num);
+void *k_memcpy(void *dest, const void *src, size_t num);
+void *k_memmove(void *dest, const void *src, size_t num);
+void *k_memcpy_nt(void *dest, const void *src, size_t num);
+void *k_memcpy_rep_movsd(void *dest, const void *src, size_t num);
+void *k_memcpy_rep_movsb(void *dest, const void *src, size_t num);
+int k_memcmp(const void *ptr1, const void *ptr2, size_t num);
+int k_strcmp(const char *str1, const char *str2);
+char *k_strcpy(char *dest, const char *src);
+char *k_strncpy(char *dest, const char *src, size_t n);
+size_t k_strlcpy(char *dest, const char *src, size_t n);
+char *k_strcat(char *dest, const char *src);
+char *k_strncat(char *dest, const char *src, size_t n);
+char *k_strchr(const char *str, int c);
+char *k_strrchr(const char *str, int c);
+char *k_strtok_r(char *str, const char *delim, char **saveptr);
+void k_itoa(int value, char *str, int base);
+void k_utoa(uint32_t value, char *str, int base);
+int k_atoi(const char *str);
+int k_vsnprintf(char *str, size_t size, const char *format, va_list args);
+
+/* ---- string.c 依赖的内核符号 ---- */
+
+uint8_t k_boot_quiet = 1;
+uint32_t k_cpu_feature_bits = 0;
+cpu_dispatch_t k_cpu_dispatch = { .memcpy = k_memcpy_rep_movsd };
+
+/* 用户态下 XMM 状态由宿主操作系统保存 */
+int k_fpu_sse_enabled(void) { return 1; }
+uint32_t k_kernel_fpu_begin(void) { return 0; }
+void k_kernel_fpu_end(uint32_t flags) { (void)flags; }
+void k_serial_puts(const char *str) { fputs(str, stdout); }
+
+static int k_snprintf(char *str, size_t size, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int ret = k_vsnprintf(str, size, format, args);
+    va_end(args);
+    return ret;
+}
+
+/* ---- 测试框架 ---- */
+
+static uint32_t failures = 0;
+static uint32_t checks = 0;
+
+#define CHECK(cond, ...) do {                                   \
+    checks++;                                                   \
+    if (!(cond)) {                                              \
+        if (failures++ < 20) {                                  \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);         \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+        }                                                       \
+    }                                                           \
+} while (0)
+
+static int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+/* xorshift32：与 libc rand 无关，便于用种子复现 */
+static uint32_t rng_state = 1;
+
+static uint32_t rnd(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+/* 偏向短长度：大多数调用都很短，但也要覆盖跨页的大块 */
+static size_t rnd_len(size_t max) {
+    size_t limit;
+    switch (rnd() & 3) {
+        case 0: limit = 16; break;
+        case 1: limit = 256; break;
+        default: limit = max; break;
+    }
+    return rnd() % ((limit < max ? limit : max) + 1);
+}
+
+static void fill_random(uint8_t *buf, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        buf[i] = (uint8_t)rnd();
+    }
+}
+
+/* 内核按 cpu_feature_bits 与分发表选择实现，逐一覆盖 */
+static const struct {
+    const char *name;
+    uint32_t features;
+    void *(*memcpy)(void *, const void *, size_t);
+} variants[] = {
+    { "rep movsd",        0,                                                   k_memcpy_rep_movsd },
+    { "erms",             1u << CPU_FEATURE_ERMS,                              k_memcpy_rep_movsb },
+    { "rep movsd + sse2", 1u << CPU_FEATURE_SSE2,                              k_memcpy_rep_movsd },
+    { "erms + sse2",      (1u << CPU_FEATURE_ERMS) | (1u << CPU_FEATURE_SSE2), k_memcpy_rep_movsb },
+};
+#define VARIANT_COUNT (sizeof(variants) / sizeof(variants[0]))
+
+static void select_variant(uint32_t v) {
+    k_cpu_feature_bits = variants[v].features;
+    k_cpu_dispatch.memcpy = variants[v].memcpy;
+}
+
+/* ---- 内存操作 ---- */
+
+#define MEM_MAX   8192
+#define MEM_GUARD 64
+#define MEM_BUF   (MEM_MAX + 2 * MEM_GUARD + 64)
+
+static uint8_t src_buf[MEM_BUF], dst_buf[MEM_BUF], ref_buf[MEM_BUF];
+
+static void test_memory(uint32_t iterations) {
+    for (uint32_t v = 0; v < VARIANT_COUNT; v++) {
+        select_variant(v);
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            size_t len = rnd_len(MEM_MAX);
+            size_t soff = MEM_GUARD + (rnd() & 63);
+            size_t doff = MEM_GUARD + (rnd() & 63);
+            fill_random(src_buf, MEM_BUF);
+            fill_random(dst_buf, MEM_BUF);
+
+            // memcpy / memcpy_nt：前后保护区也必须不变
+            memcpy(ref_buf, dst_buf, MEM_BUF);
+            memcpy(ref_buf + doff, src_buf + soff, len);
+            k_memcpy(dst_buf + doff, src_buf + soff, len);
+            CHECK(memcmp(dst_buf, ref_buf, MEM_BUF) == 0,
+                  "memcpy [%s] len %zu src+%zu dst+%zu", variants[v].name, len, soff, doff);
+
+            fill_random(dst_buf, MEM_BUF);
+            memcpy(ref_buf, dst_buf, MEM_BUF);
+            memcpy(ref_buf + doff, src_buf + soff, len);
+            k_memcpy_nt(dst_buf + doff, src_buf + soff, len);
+            CHECK(memcmp(dst_buf, ref_buf, MEM_BUF) == 0,
+                  "memcpy_nt [%s] len %zu src+%zu dst+%zu", variants[v].name, len, soff, doff);
+
+            // memmove：同一缓冲区内任意方向、任意距离的重叠
+            size_t mlen = len / 2;
+            size_t a = MEM_GUARD + rnd() % (MEM_MAX / 2);
+            size_t b = MEM_GUARD + rnd() % (MEM_MAX / 2);
+            memcpy(ref_buf, dst_buf, MEM_BUF);
+            memmove(ref_buf + a, ref_buf + b, mlen);
+            k_memmove(dst_buf + a, dst_buf + b, mlen);
+            CHECK(memcmp(dst_buf, ref_buf, MEM_BUF) == 0,
+                  "memmove [%s] len %zu src %zu dst %zu", variants[v].name, mlen, b, a);
+
+            // memset
+            uint8_t value = (uint8_t)rnd();
+            memcpy(ref_buf, dst_buf, MEM_BUF);
+            memset(ref_buf + doff, value, len);
+            CHECK(k_memset(dst_buf + doff, value, len) == dst_buf + doff,
+                  "memset return value");
+            CHECK(memcmp(dst_buf, ref_buf, MEM_BUF) == 0,
+                  "memset [%s] len %zu dst+%zu", variants[v].name, len, doff);
+        }
+    }
+    select_variant(0);
+
+    // memcmp：只比较符号
+    for (uint32_t it = 0; it < iterations; it++) {
+        size_t len = rnd_len(256);
+        fill_random(src_buf, len + 1);
+        memcpy(dst_buf, src_buf, len + 1);
+        if (len && (rnd() & 1)) {
+            dst_buf[rnd() % len] = (uint8_t)rnd();
+        }
+        CHECK(sign(k_memcmp(src_buf, dst_buf, len)) == sign(memcmp(src_buf, dst_buf, len)),
+              "memcmp len %zu", len);
+    }
+}
+
+/* ---- 字符串操作 ---- */
+
+#define STR_MAX 200
+
+/* 由少数几个字符组成的随机串，便于命中 strchr/strtok 的分隔符 */
+static void rnd_string(char *buf, size_t max) {
+    static const char alphabet[] = "abc,; \xe9\x7f";
+    size_t len = rnd_len(max);
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = alphabet[rnd() % (sizeof(alphabet) - 1)];
+    }
+    buf[len] = '\0';
+}
+
+/* 参照实现：glibc 2.38 之前没有 strlcpy */
+static size_t ref_strlcpy(char *dest, const char *src, size_t n) {
+    size_t len = strlen(src);
+    if (n) {
+        size_t copy = len < n - 1 ? len : n - 1;
+        memcpy(dest, src, copy);
+        dest[copy] = '\0';
+    }
+    return len;
+}
+
+static void test_strings(uint32_t iterations) {
+    char s1[STR_MAX + 1], s2[STR_MAX + 1];
+    char kd[2 * STR_MAX + 64], rd[2 * STR_MAX + 64];
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        rnd_string(s1, STR_MAX);
+        if (rnd() & 1) {
+            strcpy(s2, s1);
+            if (s2[0] && (rnd() & 1)) {
+                s2[rnd() % strlen(s2)] = 'z';
+            }
+        } else {
+            rnd_string(s2, STR_MAX);
+        }
+
+        CHECK(k_strlen(s1) == strlen(s1), "strlen \"%s\"", s1);
+        CHECK(sign(k_strcmp(s1, s2)) == sign(strcmp(s1, s2)), "strcmp \"%s\" \"%s\"", s1, s2);
+
+        int c = "abc,;z\xe9"[rnd() % 8];   // 包括 '\0'
+        CHECK(k_strchr(s1, c) == strchr(s1, c), "strchr \"%s\" %d", s1, c);
+        CHECK(k_strrchr(s1, c) == strrchr(s1, c), "strrchr \"%s\" %d", s1, c);
+
+        // 复制类函数：目标预先填满相同的垃圾，检查写入范围与内容都一致
+        size_t n = rnd() % (STR_MAX + 8);
+        memset(kd, 0x5A, sizeof(kd));
+        memset(rd, 0x5A, sizeof(rd));
+        CHECK(k_strcpy(kd, s1) == kd, "strcpy return value");
+        strcpy(rd, s1);
+        CHECK(memcmp(kd, rd, sizeof(kd)) == 0, "strcpy \"%s\"", s1);
+
+        memset(kd, 0x5A, sizeof(kd));
+        memset(rd, 0x5A, sizeof(rd));
+        k_strncpy(kd, s1, n);
+        strncpy(rd, s1, n);
+        CHECK(memcmp(kd, rd, sizeof(kd)) == 0, "strncpy \"%s\" %zu", s1, n);
+
+        memset(kd, 0x5A, sizeof(kd));
+        memset(rd, 0x5A, sizeof(rd));
+        CHECK(k_strlcpy(kd, s1, n) == ref_strlcpy(rd, s1, n), "strlcpy return \"%s\" %zu", s1, n);
+        CHECK(memcmp(kd, rd, sizeof(kd)) == 0, "strlcpy \"%s\" %zu", s1, n);
+
+        memset(kd, 0x5A, sizeof(kd));
+        memset(rd, 0x5A, sizeof(rd));
+        strcpy(kd, s2);
+        strcpy(rd, s2);
+        k_strcat(kd, s1);
+        strcat(rd, s1);
+        CHECK(memcmp(kd, rd, sizeof(kd)) == 0, "strcat \"%s\" \"%s\"", s2, s1);
+
+        memset(kd, 0x5A, sizeof(kd));
+        memset(rd, 0x5A, sizeof(rd));
+        strcpy(kd, s2);
+        strcpy(rd, s2);
+        k_strncat(kd, s1, n);
+        strncat(rd, s1, n);
+        CHECK(memcmp(kd, rd, sizeof(kd)) == 0, "strncat \"%s\" \"%s\" %zu", s2, s1, n);
+
+        // strtok_r：逐个比较切出的片段和剩余位置
+        const char *delims[] = { ",", ", ;", ";", "" };
+        const char *delim = delims[rnd() % 4];
+        char *ksave = NULL, *rsave = NULL;
+        strcpy(kd, s1);
+        strcpy(rd, s1);
+        char *kt = k_strtok_r(kd, delim, &ksave);
+        char *rt = strtok_r(rd, delim, &rsave);
+        for (;;) {
+            CHECK((kt == NULL) == (rt == NULL) && (!kt || kt - kd == rt - rd),
+                  "strtok_r \"%s\" delim \"%s\"", s1, delim);
+            if (!kt || !rt) {
+                break;
+            }
+            kt = k_strtok_r(NULL, delim, &ksave);
+            rt = strtok_r(NULL, delim, &rsave);
+        }
+        CHECK(memcmp(kd, rd, strlen(s1) + 1) == 0, "strtok_r buffer \"%s\"", s1);
+    }
+}
+
+/* ---- 数字转换 ---- */
+
+/* 覆盖边界值与各种数量级 */
+static uint32_t rnd_u32(void) {
+    static const uint32_t edges[] = {
+        0, 1, 9, 10, 99, 100, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 999999999, 1000000000,
+        4294967294u, 429496729, 429496730,
+    };
+    switch (rnd() & 3) {
+        case 0: return edges[rnd() % (sizeof(edges) / sizeof(edges[0]))];
+        case 1: return rnd() >> (rnd() & 31);
+        default: return rnd();
+    }
+}
+
+/* 参照实现：任意进制 */
+static void ref_utoa(uint32_t value, char *str, int base) {
+    char tmp[40];
+    int n = 0;
+    do {
+        tmp[n++] = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base];
+        value /= base;
+    } while (value);
+    while (n) {
+        *str++ = tmp[--n];
+    }
+    *str = '\0';
+}
+
+static void test_numbers(uint32_t iterations) {
+    char kb[64], rb[64];
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        uint32_t u = rnd_u32();
+        int32_t i = (int32_t)u;
+        int base = 2 + rnd() % 35;
+
+        k_utoa(u, kb, 10);
+        snprintf(rb, sizeof(rb), "%u", u);
+        CHECK(strcmp(kb, rb) == 0, "utoa(%u, 10) = \"%s\"", u, kb);
+
+        k_utoa(u, kb, 16);
+        snprintf(rb, sizeof(rb), "%x", u);
+        CHECK(strcmp(kb, rb) == 0, "utoa(%u, 16) = \"%s\"", u, kb);
+
+        k_utoa(u, kb, base);
+        ref_utoa(u, rb, base);
+        CHECK(strcmp(kb, rb) == 0, "utoa(%u, %d) = \"%s\"", u, base, kb);
+
+        k_itoa(i, kb, 10);
+        snprintf(rb, sizeof(rb), "%d", i);
+        CHECK(strcmp(kb, rb) == 0, "itoa(%d, 10) = \"%s\"", i, kb);
+
+        // 非十进制按补码输出
+        k_itoa(i, kb, base == 10 ? 16 : base);
+        ref_utoa(u, rb, base == 10 ? 16 : base);
+        CHECK(strcmp(kb, rb) == 0, "itoa(%d, %d) = \"%s\"", i, base, kb);
+
+        // atoi：前导空白与符号；值不溢出时与 libc 一致
+        static const char *prefixes[] = { "", " ", "\t\n ", "+", "-", " -" };
+        const char *prefix = prefixes[rnd() % 6];
+        snprintf(rb, sizeof(rb), "%s%u%s", prefix, u >> 1, (rnd() & 1) ? "x12" : "");
+        CHECK(k_atoi(rb) == atoi(rb), "atoi(\"%s\") = %d", rb, k_atoi(rb));
+    }
+
+    CHECK(k_atoi("") == 0 && k_atoi("-") == 0 && k_atoi("abc") == 0, "atoi of non-numbers");
+}
+
+/* ---- vsnprintf ---- */
+
+static void check_format(const char *format, ...) {
+    char kb[96], rb[96];
+    va_list args, copy;
+
+    va_start(args, format);
+    va_copy(copy, args);
+    int kret = k_vsnprintf(kb, sizeof(kb), format, args);
+    vsnprintf(rb, sizeof(rb), format, copy);
+    va_end(copy);
+    va_end(args);
+
+    CHECK(strcmp(kb, rb) == 0 && kret == (int)strlen(rb),
+          "vsnprintf \"%s\": \"%s\" vs libc \"%s\"", format, kb, rb);
+}
+
+static void test_format(uint32_t iterations) {
+    static const char *numeric[] = { "d", "i", "u", "x", "X", "ld", "lu", "lx" };
+    static const char *flags[] = { "", "-", "0", "-0" };
+    static const char *words[] = { "", "a", "hello", "with space", "\xe4\xb8\xad\xe6\x96\x87" };
+    char format[32];
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        uint32_t width = rnd() % 14;
+        const char *flag = flags[rnd() % 4];
+        const char *text = (rnd() & 1) ? "v=" : "";
+
+        // 整数：格式与参数都随机
+        const char *conv = numeric[rnd() % 8];
+        if (width) {
+            snprintf(format, sizeof(format), "%s%%%s%u%s;", text, flag, width, conv);
+        } else {
+            snprintf(format, sizeof(format), "%s%%%s%s;", text, flag, conv);
+        }
+        check_format(format, rnd_u32());
+
+        // 字符串与字符：libc 对 %0s 的行为未定义，不加 '0'
+        const char *sflag = (rnd() & 1) ? "-" : "";
+        snprintf(format, sizeof(format), "[%%%s%us|%%c]", sflag, width);
+        check_format(format, words[rnd() % 5], 'A' + (int)(rnd() % 26));
+    }
+
+    check_format("%% %s %c %d %u %x", "mixed", 'q', -123, 456u, 0xbeefu);
+    check_format("%s", "");
+    check_format("no conversions at all");
+
+    // %p：内核固定输出 0x 加 8 位
+    char kb[32], rb[32];
+    k_snprintf(kb, sizeof(kb), "%p", (void *)0x1234);
+    CHECK(strcmp(kb, "0x00001234") == 0, "%%p = \"%s\"", kb);
+    k_snprintf(kb, sizeof(kb), "%s", (const char *)NULL);
+    CHECK(strcmp(kb, "(null)") == 0, "%%s NULL = \"%s\"", kb);
+
+    // 截断：写入的内容与 libc 一致，返回实际写入的长度
+    for (size_t size = 0; size < 20; size++) {
+        memset(kb, 0x5A, sizeof(kb));
+        memset(rb, 0x5A, sizeof(rb));
+        int kret = k_snprintf(kb, size, "abc %d def %s", -42, "tail");
+        snprintf(rb, size, "abc %d def %s", -42, "tail");
+        CHECK(memcmp(kb, rb, sizeof(kb)) == 0, "truncated snprintf size %zu", size);
+        CHECK(kret == (size ? (int)strlen(rb) : 0), "truncated snprintf return %d size %zu", kret, size);
+    }
+}
+
+/* ---- 微基准 ---- */
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    asm volatile("lfence\n\trdtsc" : "=a"(lo), "=d"(hi) : : "memory");
+    return ((uint64_t)hi << 32) | lo;
+}
+
+#define BENCH_BUF     (2u << 20)
+#define BENCH_BYTES   (64u << 20)   // 每项测量处理的总字节数
+#define BENCH_REPEAT  3             // 取最快的一次
+
+static uint8_t *bench_src, *bench_dst;
+
+typedef void (*bench_fn)(size_t len, size_t soff, size_t doff);
+
+static void b_kmemcpy(size_t len, size_t s, size_t d) { k_memcpy(bench_dst + d, bench_src + s, len); }
+static void b_kmemcpy_nt(size_t len, size_t s, size_t d) { k_memcpy_nt(bench_dst + d, bench_src + s, len); }
+static void b_kmemmove(size_t len, size_t s, size_t d) { k_memmove(bench_dst + d + 64, bench_dst + s, len); }
+static void b_kmemset(size_t len, size_t s, size_t d) { (void)s; k_memset(bench_dst + d, 0x5A, len); }
+static void b_memcpy(size_t len, size_t s, size_t d) { memcpy(bench_dst + d, bench_src + s, len); }
+static void b_memmove(size_t len, size_t s, size_t d) { memmove(bench_dst + d + 64, bench_dst + s, len); }
+static void b_memset(size_t len, size_t s, size_t d) { (void)s; memset(bench_dst + d, 0x5A, len); }
+
+/* 返回每周期字节数 */
+static double bench_bytes(bench_fn fn, size_t len, size_t soff, size_t doff) {
+    uint32_t iters = BENCH_BYTES / len;
+    uint64_t best = ~0ull;
+
+    if (iters > 1000000) {
+        iters = 1000000;
+    }
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        uint64_t t0 = rdtsc();
+        for (uint32_t i = 0; i < iters; i++) {
+            fn(len, soff, doff);
+        }
+        uint64_t t = rdtsc() - t0;
+        if (t < best) {
+            best = t;
+        }
+    }
+    return (double)len * iters / (double)best;
+}
+
+/* 返回每次调用的周期数 */
+#define BENCH_CALLS(result, iters, stmt) do {                   \
+    uint64_t best = ~0ull;                                      \
+    for (int r = 0; r < BENCH_REPEAT; r++) {                    \
+        uint64_t t0 = rdtsc();                                  \
+        for (uint32_t i = 0; i < (iters); i++) {                \
+            stmt;                                               \
+        }                                                       \
+        uint64_t t = rdtsc() - t0;                              \
+        if (t < best) best = t;                                 \
+    }                                                           \
+    (result) = (double)best / (iters);                          \
+} while (0)
+
+static void run_benchmarks(void) {
+    static const size_t sizes[] = { 16, 64, 256, 1024, 4096, 65536, 1u << 20 };
+    static const struct {
+        const char *name;
+        bench_fn kernel, libc;
+    } ops[] = {
+        { "memcpy",    b_kmemcpy,    b_memcpy },
+        { "memcpy_nt", b_kmemcpy_nt, b_memcpy },
+        { "memmove",   b_kmemmove,   b_memmove },
+        { "memset",    b_kmemset,    b_memset },
+    };
+
+    bench_src = aligned_alloc(64, BENCH_BUF);
+    bench_dst = aligned_alloc(64, BENCH_BUF + 4096);
+    if (!bench_src || !bench_dst) {
+        printf("benchmark: out of memory\n");
+        return;
+    }
+    memset(bench_src, 1, BENCH_BUF);
+    memset(bench_dst, 2, BENCH_BUF + 4096);
+
+    printf("\nbytes/cycle (kernel string.c vs host libc; misaligned = src+1, dst+3)\n");
+    printf("%-10s %-17s %8s", "op", "variant", "");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        printf(" %8zu", sizes[i]);
+    }
+    printf("\n");
+
+    for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+        for (uint32_t v = 0; v <= VARIANT_COUNT; v++) {
+            int is_libc = v == VARIANT_COUNT;
+            // memmove/memset 不受 SSE2 影响，只测前两种实现
+            if (!is_libc && ops[o].kernel != b_kmemcpy_nt && variants[v].features & (1u << CPU_FEATURE_SSE2)) {
+                continue;
+            }
+            if (!is_libc) {
+                select_variant(v);
+            }
+            for (int mis = 0; mis < 2; mis++) {
+                printf("%-10s %-17s %8s", ops[o].name, is_libc ? "libc" : variants[v].name,
+                       mis ? "misalign" : "aligned");
+                for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                    double bpc = bench_bytes(is_libc ? ops[o].libc : ops[o].kernel,
+                                             sizes[i], mis ? 1 : 0, mis ? 3 : 0);
+                    printf(" %8.2f", bpc);
+                }
+                printf("\n");
+            }
+        }
+    }
+    select_variant(0);
+
+    // 字符串与格式化：每次调用的周期数
+    char buf[64];
+    static const char text[] = "The quick brown fox jumps over the lazy dog, 1234567890";
+    volatile size_t sink = 0;
+    double kc, lc;
+
+    printf("\ncycles/call             kernel      libc\n");
+    BENCH_CALLS(kc, 200000, sink += k_strlen(text));
+    BENCH_CALLS(lc, 200000, sink += strlen(text));
+    printf("strlen(%2zu)          %9.1f %9.1f\n", sizeof(text) - 1, kc, lc);
+    BENCH_CALLS(kc, 200000, sink += k_strcmp(text, text + 0));
+    BENCH_CALLS(lc, 200000, sink += strcmp(text, text + 0));
+    printf("strcmp(equal)       %9.1f %9.1f\n", kc, lc);
+    BENCH_CALLS(kc, 200000, k_utoa(i * 2654435761u, buf, 10));
+    BENCH_CALLS(lc, 200000, snprintf(buf, sizeof(buf), "%u", i * 2654435761u));
+    printf("utoa/%%u             %9.1f %9.1f\n", kc, lc);
+    BENCH_CALLS(kc, 200000, sink += k_atoi("  -1234567"));
+    BENCH_CALLS(lc, 200000, sink += atoi("  -1234567"));
+    printf("atoi                %9.1f %9.1f\n", kc, lc);
+    BENCH_CALLS(kc, 100000, k_snprintf(buf, sizeof(buf), "cpu %u: %s 0x%08x %d", i & 7, "event", i, -(int)i));
+    BENCH_CALLS(lc, 100000, snprintf(buf, sizeof(buf), "cpu %u: %s 0x%08x %d", i & 7, "event", i, -(int)i));
+    printf("snprintf            %9.1f %9.1f\n", kc, lc);
+    (void)sink;
+
+    free(bench_src);
+    free(bench_dst);
+}
+
+int main(int argc, char **argv) {
+    int bench = 1;
+    uint32_t seed = 12345;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-bench") == 0) {
+            bench = 0;
+        } else {
+            seed = (uint32_t)strtoul(argv[i], NULL, 0);
+        }
+    }
+    rng_state = seed ? seed : 1;
+
+    test_memory(3000);
+    test_strings(20000);
+    test_numbers(50000);
+    test_format(20000);
+
+    printf("string_test: seed %u, %u checks, %u failures\n", seed, checks, failures);
+    if (failures) {
+        return 1;
+    }
+
+    if (bench) {
+        run_benchmarks();
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""IsThisAnOS 跟踪缓冲区解码器
+
+从串口日志中提取 trace_dump() 输出的记录并还原为时间线:
+
+    qemu-system-x86_64 ... -serial file:serial.log
+    python3 tools/trace_decode.py serial.log
+
+事件名从 include/kernel/trace.h 的 enum trace_event 中解析。
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+RECORD_FORMAT = "<QIHHII"   # 与 trace_record_t 保持一致
+RECORD_SIZE = struct.calcsize(RECORD_FORMAT)
+
+BEGIN_RE = re.compile(r"=== TRACE BEGIN v1 tsc_khz=(\d+) records=(\d+) size=(\d+) ===")
+# 旧内核没有 crc32c 字段
+END_RE = re.compile(r"^=== TRACE END(?: crc32c=([0-9a-fA-F]+))? ===$")
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                              "..", "include", "kernel", "trace.h")
+
+# 需要按有符号整数显示参数的事件
+SIGNED_ARGS = {"MOUSE_PACKET"}
+
+
+def crc32c(data, crc=0):
+    crc ^= 0xFFFFFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0x82F63B78 if crc & 1 else 0)
+    return crc ^ 0xFFFFFFFF
+
+
+def load_event_names(header):
+    names = {}
+    try:
+        with open(header, encoding="utf-8") as f:
+            for m in re.finditer(r"\bTRACE_([A-Z0-9_]+)\s*=\s*(\d+)", f.read()):
+                names[int(m.group(2))] = m.group(1)
+    except OSError:
+        pass
+    return names
+
+
+def extract_dumps(lines):
+    """返回 [(tsc_khz, [记录元组, ...]), ...]，一个日志里可能有多次导出"""
+    dumps = []
+    current = None
+    crc = 0
+    for line in lines:
+        line = line.strip()
+        m = BEGIN_RE.search(line)
+        if m:
+            khz, size = int(m.group(1)), int(m.group(3))
+            if size != RECORD_SIZE:
+                sys.exit("record size %d does not match decoder (%d)" % (size, RECORD_SIZE))
+            current = (khz, [])
+            crc = 0
+            continue
+        if current is None:
+            continue
+        m = END_RE.match(line)
+        if m:
+            if m.group(1) is not None and int(m.group(1), 16) != crc:
+                sys.stderr.write("warning: dump %d crc32c mismatch (log %s, computed %x), "
+                                 "serial output may have lost bytes\n"
+                                 % (len(dumps), m.group(1), crc))
+            dumps.append(current)
+            current = None
+            continue
+        try:
+            raw = bytes.fromhex(line)
+        except ValueError:
+            continue    # 混入的其他串口输出
+        if len(raw) == RECORD_SIZE:
+            crc = crc32c(raw, crc)
+            current[1].append(struct.unpack(RECORD_FORMAT, raw))
+    if current is not None:
+        dumps.append(current)   # 日志被截断，尽量解码
+    return dumps
+
+
+def to_signed(v):
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def index_log_lines(lines):
+    """TRACE_LOG 事件的 arg1 是该行的 CRC32C，据此从串口日志中找回原文"""
+    return {crc32c(line.encode("utf-8", "replace")): line.rstrip("\n") for line in lines}
+
+
+def print_timeline(khz, records, names, out, log_lines=None):
+    # 跳过从未写入的空槽
+    records = [r for r in records if r[2] != 0 or r[1] != 0]
+    records.sort(key=lambda r: r[1])
+    if not records:
+        out.write("(empty trace)\n")
+        return
+
+    base = records[0][0]
+    prev = base
+    unit = "us" if khz else "cycles"
+    out.write("# %d records, tsc %s kHz\n" % (len(records), khz if khz else "unknown"))
+    out.write("%14s %12s  cpu  %-16s args\n" % ("time(" + unit + ")", "delta", "event"))
+
+    for tsc, seq, event, cpu, a0, a1 in records:
+        name = names.get(event, "EVENT_%d" % event)
+        if name in SIGNED_ARGS:
+            a0, a1 = to_signed(a0), to_signed(a1)
+        text = ""
+        if name == "LOG" and log_lines:
+            text = "  " + log_lines.get(a1, "?")
+        t = tsc - base
+        d = tsc - prev
+        prev = tsc
+        if khz:
+            t_str = "%.3f" % (t * 1000.0 / khz)
+            d_str = "+%.3f" % (d * 1000.0 / khz)
+        else:
+            t_str, d_str = str(t), "+%d" % d
+        out.write("%14s %12s  %3d  %-16s %s %s%s\n" % (t_str, d_str, cpu, name, a0, a1, text))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Decode IsThisAnOS trace dumps from a serial log")
+    ap.add_argument("log", nargs="?", help="serial log file (default: stdin)")
+    ap.add_argument("--header", default=DEFAULT_HEADER, help="path to kernel/trace.h")
+    ap.add_argument("--dump", type=int, default=-1,
+                    help="which dump to decode when the log has several (default: last)")
+    args = ap.parse_args()
+
+    if args.log:
+        with open(args.log, encoding="utf-8", errors="replace") as f:
+            lines = f.readlines()
+    else:
+        lines = sys.stdin.readlines()
+
+    dumps = extract_dumps(lines)
+    if not dumps:
+        sys.exit("no trace dump found")
+
+    khz, records = dumps[args.dump]
+    print_timeline(khz, records, load_event_names(args.header), sys.stdout,
+                   index_log_lines(lines))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,63 @@
+; AP 启动蹦床
+; smp_init 将 [ap_trampoline_start, ap_trampoline_end) 复制到 TRAMPOLINE_BASE，
+; AP 收到 STARTUP IPI 后以实模式从该地址开始执行，进入保护模式后调用 ap_entry。
+section .text
+
+global ap_trampoline_start
+global ap_trampoline_end
+global ap_stack
+global ap_entry
+
+TRAMPOLINE_BASE equ 0x8000
+
+; 蹦床内标签在复制后的实际地址
+%define TADDR(x) (TRAMPOLINE_BASE + ((x) - ap_trampoline_start))
+
+bits 16
+ap_trampoline_start:
+    cli
+    cld
+    xor ax, ax
+    mov ds, ax
+
+    ; 加载临时 GDT 并进入保护模式
+    lgdt [TADDR(ap_gdt_ptr)]
+    mov eax, cr0
+    or eax, 1
+    mov cr0, eax
+    jmp dword 0x08:TADDR(ap_protected)
+
+bits 32
+ap_protected:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    ; 栈和入口由 smp_init 在启动每个 AP 前填写
+    mov esp, [TADDR(ap_stack)]
+    call [TADDR(ap_entry)]
+.hang:
+    cli
+    hlt
+    jmp .hang
+
+; 临时平坦 GDT（ap_main 随后加载本 CPU 的正式 GDT）
+align 8
+ap_gdt:
+    dq 0                        ; 空描述符
+    dq 0x00CF9A000000FFFF       ; 内核代码段
+    dq 0x00CF92000000FFFF       ; 内核数据段
+ap_gdt_end:
+
+ap_gdt_ptr:
+    dw ap_gdt_end - ap_gdt - 1
+    dd TADDR(ap_gdt)
+
+ap_stack:
+    dd 0
+ap_entry:
+    dd 0
+ap_trampoline_end:
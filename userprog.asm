@@ -0,0 +1,230 @@
+; 用户态演示程序（ring 3）
+; process_create 将 [user_hello_start, user_hello_end) 复制到 USER_BASE 执行，
+; 因此数据地址需按装载地址换算。
+section .rodata
+
+global user_hello_start
+global user_hello_end
+global user_bench_start
+global user_bench_end
+global user_surface_start
+global user_surface_end
+
+USER_BASE equ 0x40000000
+VSYSCALL_BASE equ 0xBFFF0000
+%define UADDR(x) (USER_BASE + ((x) - user_hello_start))
+%define BADDR(x) (USER_BASE + ((x) - user_bench_start))
+
+; 系统调用号（与 include/kernel/syscall.h 一致）
+SYS_EXIT   equ 0
+SYS_WRITE  equ 1
+SYS_YIELD  equ 2
+SYS_GETPID equ 3
+SYS_SLEEP  equ 4
+SYS_SURFACE_CREATE  equ 6
+SYS_SURFACE_PRESENT equ 7
+SYS_SURFACE_MOVE    equ 8
+SURFACE_ALPHA       equ 1   ; 与 include/kernel/surface.h 一致
+
+bits 32
+user_hello_start:
+    mov esi, 3              ; 输出三次
+
+.loop:
+    mov eax, SYS_WRITE
+    mov ebx, UADDR(hello_msg)
+    mov ecx, hello_len
+    int 0x80
+
+    mov eax, SYS_SLEEP
+    mov ebx, 50             ; 0.5 秒
+    int 0x80
+
+    dec esi
+    jnz .loop
+
+    mov eax, SYS_EXIT
+    xor ebx, ebx
+    int 0x80
+
+.hang:
+    jmp .hang
+
+hello_msg:
+    db "Hello from ring 3!", 10
+hello_len equ $ - hello_msg
+
+user_hello_end:
+
+; 系统调用往返基准：分别用 int 0x80 与 vsyscall 页（SYSENTER）调用 getpid，
+; 用 rdtsc 计时，输出每次往返的平均周期数
+BENCH_ITERS equ 10000
+
+user_bench_start:
+    sub esp, 8
+
+    rdtsc
+    mov [esp], eax
+    mov [esp + 4], edx
+    mov esi, BENCH_ITERS
+.int80_loop:
+    mov eax, SYS_GETPID
+    int 0x80
+    dec esi
+    jnz .int80_loop
+    rdtsc
+    sub eax, [esp]
+    sbb edx, [esp + 4]
+    mov ecx, BENCH_ITERS
+    div ecx
+    mov ebx, BADDR(int80_label)
+    mov ecx, int80_label_len
+    call bench_report
+
+    mov edi, VSYSCALL_BASE
+    rdtsc
+    mov [esp], eax
+    mov [esp + 4], edx
+    mov esi, BENCH_ITERS
+.vsyscall_loop:
+    mov eax, SYS_GETPID
+    call edi
+    dec esi
+    jnz .vsyscall_loop
+    rdtsc
+    sub eax, [esp]
+    sbb edx, [esp + 4]
+    mov ecx, BENCH_ITERS
+    div ecx
+    mov ebx, BADDR(vsyscall_label)
+    mov ecx, vsyscall_label_len
+    call bench_report
+
+    mov eax, SYS_EXIT
+    xor ebx, ebx
+    int 0x80
+.hang:
+    jmp .hang
+
+; 输出 "标签 + 十进制数值 + 换行"
+; eax = 数值, ebx = 标签地址, ecx = 标签长度
+bench_report:
+    push eax
+    mov eax, SYS_WRITE
+    int 0x80
+    pop eax
+
+    ; 从缓冲区末尾向前逐位写入
+    sub esp, 16
+    lea edi, [esp + 15]
+    mov byte [edi], 10
+    mov ecx, 10
+.digit:
+    xor edx, edx
+    div ecx
+    add dl, '0'
+    dec edi
+    mov [edi], dl
+    test eax, eax
+    jnz .digit
+
+    mov eax, SYS_WRITE
+    mov ebx, edi
+    lea ecx, [esp + 16]
+    sub ecx, edi
+    int 0x80
+    add esp, 16
+    ret
+
+int80_label:
+    db "int 0x80 round trip (cycles): "
+int80_label_len equ $ - int80_label
+
+vsyscall_label:
+    db "vsyscall round trip (cycles): "
+vsyscall_label_len equ $ - vsyscall_label
+
+user_bench_end:
+
+; 共享表面演示：在内核分配的表面上直接绘制动画，只通过 present 提交损坏区域；
+; 像素 alpha 为 0xC0，合成时与屏幕上的内容（包括上一帧）混合
+SURF_SIZE   equ 128
+SURF_FRAMES equ 120
+SURF_X      equ 20
+SURF_Y      equ 320
+SURF_SLIDE  equ 60          ; 动画结束后向右下方滑动的步数（每步 2 像素）
+
+user_surface_start:
+    mov eax, SYS_SURFACE_CREATE
+    mov ebx, SURF_SIZE
+    mov ecx, SURF_SIZE
+    mov edx, SURF_X         ; 屏幕位置
+    mov esi, SURF_Y
+    mov edi, SURFACE_ALPHA
+    int 0x80
+    cmp eax, 0xFFFFFFF0     ; 错误码为 -1 ~ -4
+    jae .exit
+    mov ebp, eax            ; 表面的用户地址
+
+    xor esi, esi            ; 帧号
+.frame:
+    mov edi, ebp
+    xor edx, edx            ; y
+.row:
+    xor ecx, ecx            ; x
+.pixel:
+    mov eax, ecx
+    xor eax, edx
+    add eax, esi
+    and eax, 0xFF
+    mov ebx, eax
+    shl ebx, 8
+    or eax, ebx             ; 青色渐变
+    or eax, 0xC0000000      ; 3/4 不透明
+    mov [edi + ecx * 4], eax
+    inc ecx
+    cmp ecx, SURF_SIZE
+    jb .pixel
+    add edi, SURF_SIZE * 4
+    inc edx
+    cmp edx, SURF_SIZE
+    jb .row
+
+    push esi
+    mov eax, SYS_SURFACE_PRESENT
+    xor ebx, ebx
+    xor ecx, ecx
+    mov edx, SURF_SIZE
+    mov esi, SURF_SIZE
+    int 0x80
+    mov eax, SYS_SLEEP
+    mov ebx, 2
+    int 0x80
+    pop esi
+
+    inc esi
+    cmp esi, SURF_FRAMES
+    jb .frame
+
+    ; 只移动表面不重绘：内核在屏幕内搬移已合成的像素
+    xor esi, esi
+.slide:
+    inc esi
+    mov eax, SYS_SURFACE_MOVE
+    lea ebx, [SURF_X + esi * 2]
+    lea ecx, [SURF_Y + esi * 2]
+    int 0x80
+    mov eax, SYS_SLEEP
+    mov ebx, 2
+    int 0x80
+    cmp esi, SURF_SLIDE
+    jb .slide
+
+.exit:
+    mov eax, SYS_EXIT
+    xor ebx, ebx
+    int 0x80
+.hang:
+    jmp .hang
+
+user_surface_end:
@@ -0,0 +1,87 @@
+; 快速系统调用：SYSENTER 内核入口与用户态 vsyscall 页
+; process_create 把其中一段用户代码复制到每个进程的 VSYSCALL_BASE，
+; 用户程序统一 call VSYSCALL_BASE，寄存器约定与 int 0x80 相同。
+
+global sysenter_entry
+global vsyscall_sysenter_start, vsyscall_sysenter_end
+global vsyscall_int80_start, vsyscall_int80_end
+
+extern syscall_dispatch
+
+; 与 include/kernel/syscall.h 一致
+VSYSCALL_BASE equ 0xBFFF0000
+
+section .rodata
+bits 32
+
+; 支持 SEP 的 CPU：通过 SYSENTER 进入内核
+; ecx/edx 是参数，返回时被 SYSEXIT 占用，因此先保存在用户栈上
+vsyscall_sysenter_start:
+    push ecx
+    push edx
+    push ebp
+    mov ebp, esp            ; 内核从 ebp 取得用户栈
+    sysenter
+vsyscall_sysenter_return:   ; SYSEXIT 返回到这里
+    pop ebp
+    pop edx
+    pop ecx
+    ret
+vsyscall_sysenter_end:
+
+; 回退路径：普通的 int 0x80
+vsyscall_int80_start:
+    int 0x80
+    ret
+vsyscall_int80_end:
+
+SYSENTER_RETURN equ VSYSCALL_BASE + (vsyscall_sysenter_return - vsyscall_sysenter_start)
+
+section .text
+
+; SYSENTER 入口：CPU 已从 MSR 载入 CS/SS/ESP/EIP，并清除了 IF
+; 在内核栈上构造与 int 0x80 相同的 struct registers 帧，复用同一张系统调用表。
+; 用户态可以把 ds/es 置为空选择子后再调用 vsyscall 页，因此与 irq_common_stub 一样
+; 重新加载全部数据段，返回前恢复用户的值。
+sysenter_entry:
+    push dword 0x23         ; ss
+    push ebp                ; 用户 esp
+    pushfd                  ; 用户的 eflags（SYSENTER 只清除了 IF，用户态总是开中断）
+    or dword [esp], 0x200
+    push dword 0x1B         ; cs
+    push dword SYSENTER_RETURN  ; eip
+    push dword 0
+    push dword 0x80
+    pusha
+    
+    push ds
+    push es
+    push fs
+    push gs
+    
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov ax, 0x30
+    mov gs, ax
+    cld                     ; C 代码假定 DF=0（用户态或被打断的 memmove 可能置位）
+    sti                     ; 与陷阱门一致，系统调用期间允许中断
+    
+    push esp
+    call syscall_dispatch
+    add esp, 4
+    
+    cli
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    add esp, 8
+    
+    ; SYSEXIT：eip = edx，esp = ecx（用户的 ecx/edx 由 vsyscall 代码恢复）
+    mov edx, [esp]
+    mov ecx, [esp + 12]
+    sti                     ; sti 的中断延迟覆盖 sysexit，返回前不会被打断
+    sysexit